@@ -0,0 +1,333 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cxxopts.hpp>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#include <gnuradio/constants.h>
+#include <gnuradio/top_block.h>
+#include <volk/volk.h>
+
+#include "report.h"
+#include "stages.h"
+
+/// The center frequency of the canned TETRA signal relative to the center of the input of a channel filter
+static constexpr int kSignalOffset = 50000;
+
+/// The benchmark of one stage
+class Benchmark {
+public:
+  /// the name of the benchmark
+  std::string name_;
+  /// the sample rate of the input of the stage
+  double input_sample_rate_ = 0;
+  /// create the block of the stage, which is created anew for every repetition
+  std::function<gr::block_sptr()> make_;
+};
+
+/// A π/4-DQPSK signal at the TETRA symbol rate with a little noise, shifted by offset and sampled at sample_rate. The
+/// symbols are linearly interpolated, which is close enough to the real signal for the loops of the demodulator.
+static auto canned_signal(const double sample_rate, const double offset, const std::size_t items)
+    -> std::vector<std::complex<float>> {
+  std::mt19937 generator(/*seed=*/42);
+  std::uniform_int_distribution<int> dibits(0, 3);
+  std::normal_distribution<float> noise(0, 0.05);
+
+  // the phase changes of the π/4-DQPSK dibits
+  constexpr std::array<float, 4> kPhaseChanges = {M_PI / 4, 3 * M_PI / 4, -M_PI / 4, -3 * M_PI / 4};
+  const auto samples_per_symbol = sample_rate / graph::kSymbolRate;
+  const auto symbols = static_cast<std::size_t>(items / samples_per_symbol) + 2;
+
+  std::vector<std::complex<float>> points(symbols);
+  float phase = 0;
+  for (auto& point : points) {
+    phase += kPhaseChanges[dibits(generator)];
+    point = std::polar(1.0f, phase);
+  }
+
+  std::vector<std::complex<float>> signal(items);
+  for (std::size_t i = 0; i < items; i++) {
+    const auto position = i / samples_per_symbol;
+    const auto symbol = static_cast<std::size_t>(position);
+    const auto fraction = static_cast<float>(position - symbol);
+    const auto rotation = std::polar(1.0f, static_cast<float>(2 * M_PI * offset * i / sample_rate));
+
+    signal[i] = ((1 - fraction) * points[symbol] + fraction * points[symbol + 1]) * rotation +
+                std::complex<float>(noise(generator), noise(generator));
+  }
+
+  return signal;
+}
+
+/// Create a source of canned items for the input of the block
+static auto make_source(const gr::block_sptr& block, const double sample_rate, const std::size_t items)
+    -> gr::block_sptr {
+  const auto item_size = block->input_signature()->sizeof_stream_item(0);
+
+  switch (item_size) {
+  case sizeof(gr_complex):
+    return gr::blocks::vector_source_c::make(canned_signal(sample_rate, 0, items));
+  case sizeof(float): {
+    // the power of the samples
+    const auto signal = canned_signal(sample_rate, 0, items);
+    std::vector<float> power(items);
+    std::transform(signal.begin(), signal.end(), power.begin(), [](const auto& sample) { return std::norm(sample); });
+    return gr::blocks::vector_source_f::make(power);
+  }
+  case 2 * sizeof(uint8_t): {
+    // interleaved cu8 samples of an RTL-SDR, passed as shorts
+    const auto signal = canned_signal(sample_rate, kSignalOffset, items);
+    std::vector<int16_t> samples(items);
+    for (std::size_t i = 0; i < items; i++) {
+      const std::array<uint8_t, 2> iq = {static_cast<uint8_t>(std::lround(signal[i].real() * 100 + 127.5)),
+                                         static_cast<uint8_t>(std::lround(signal[i].imag() * 100 + 127.5))};
+      std::memcpy(&samples[i], iq.data(), iq.size());
+    }
+    return gr::blocks::vector_source_s::make(samples);
+  }
+  case sizeof(uint8_t): {
+    // the dibits of the symbols
+    std::mt19937 generator(/*seed=*/42);
+    std::uniform_int_distribution<int> dibits(0, 3);
+    std::vector<uint8_t> symbols(items);
+    std::generate(symbols.begin(), symbols.end(), [&] { return static_cast<uint8_t>(dibits(generator)); });
+    return gr::blocks::vector_source_b::make(symbols);
+  }
+  default:
+    throw std::invalid_argument("No canned input for items of " + std::to_string(item_size) + " bytes.");
+  }
+}
+
+/// Measure the median time per input item of the benchmark
+static auto run(const Benchmark& benchmark, const double seconds, const unsigned int repetitions)
+    -> BenchmarkResult {
+  const auto items = static_cast<std::size_t>(seconds * benchmark.input_sample_rate_);
+  std::vector<double> ns_per_item;
+
+  for (unsigned int repetition = 0; repetition < repetitions; repetition++) {
+    auto tb = gr::make_top_block("benchmark");
+    auto block = benchmark.make_();
+    // blocks with several ports get a source for each input and a sink for each output
+    for (int port = 0; port < block->input_signature()->min_streams(); port++) {
+      tb->connect(make_source(block, benchmark.input_sample_rate_, items), 0, block, port);
+    }
+    for (int port = 0; port < block->output_signature()->min_streams(); port++) {
+      tb->connect(block, port, gr::blocks::null_sink::make(block->output_signature()->sizeof_stream_item(port)), 0);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    tb->run();
+    const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+
+    ns_per_item.push_back(duration.count() / items);
+  }
+
+  std::sort(ns_per_item.begin(), ns_per_item.end());
+  return BenchmarkResult{/*name=*/benchmark.name_, /*items=*/items, /*ns_per_item=*/ns_per_item[repetitions / 2]};
+}
+
+/// A channel filter as the builder configures it for the given rates
+static auto channel_filter_benchmark(const std::string& name, const graph::FilterImplementation implementation,
+                                     const config::SampleFormat format, const unsigned int input_sample_rate,
+                                     const unsigned int output_sample_rate) -> Benchmark {
+  const double half_sample_rate = output_sample_rate / 2;
+  const auto decimation = input_sample_rate / output_sample_rate;
+
+  return Benchmark{name, static_cast<double>(input_sample_rate), [=] {
+                     return stages::make_channel_filter(implementation, format, decimation, half_sample_rate,
+                                                        half_sample_rate * 0.2, kSignalOffset, input_sample_rate);
+                   }};
+}
+
+/// Each stage of a chain in isolation, with the sample rate at which it runs in the chain
+static auto chain_benchmarks(const std::string& prefix, const double input_sample_rate,
+                             const std::function<std::vector<stages::Stage>()>& make_stages)
+    -> std::vector<Benchmark> {
+  std::vector<Benchmark> benchmarks;
+
+  auto sample_rate = input_sample_rate;
+  const auto stages = make_stages();
+  for (std::size_t i = 0; i < stages.size(); i++) {
+    benchmarks.push_back(Benchmark{prefix + "/" + stages[i].name_, sample_rate, [make_stages, i] {
+                                     return make_stages().at(i).block_;
+                                   }});
+    sample_rate = stages[i].output_sample_rate_;
+  }
+
+  return benchmarks;
+}
+
+/// The stages of the receiver with the rates and parameters of the typical configurations
+static auto all_benchmarks() -> std::vector<Benchmark> {
+  using graph::FilterImplementation;
+  using config::SampleFormat;
+
+  std::vector<Benchmark> benchmarks = {
+      // a Stream directly on the samples of the SDR
+      channel_filter_benchmark("xlat/float_2400000_to_25000", FilterImplementation::kFreqXlatingFir,
+                               SampleFormat::kComplexFloat32, 2400000, config::kTetraSampleRate),
+      // a Decimate block and a Stream under it
+      channel_filter_benchmark("xlat/float_2400000_to_200000", FilterImplementation::kFreqXlatingFir,
+                               SampleFormat::kComplexFloat32, 2400000, 200000),
+      channel_filter_benchmark("xlat/float_200000_to_25000", FilterImplementation::kFreqXlatingFir,
+                               SampleFormat::kComplexFloat32, 200000, config::kTetraSampleRate),
+      channel_filter_benchmark("xlat/multistage_200000_to_25000", FilterImplementation::kMultistage,
+                               SampleFormat::kComplexFloat32, 200000, config::kTetraSampleRate),
+      // a Decimate block on a wideband SDR
+      channel_filter_benchmark("xlat/float_10000000_to_200000", FilterImplementation::kFreqXlatingFir,
+                               SampleFormat::kComplexFloat32, 10000000, 200000),
+      channel_filter_benchmark("xlat/multistage_10000000_to_200000", FilterImplementation::kMultistage,
+                               SampleFormat::kComplexFloat32, 10000000, 200000),
+      // a Decimate block on the native samples of an RTL-SDR
+      channel_filter_benchmark("xlat/integer_cu8_2400000_to_200000", FilterImplementation::kIntegerXlatingFir,
+                               SampleFormat::kComplexUint8, 2400000, 200000),
+      // a Decimate block with a sample rate that does not divide the one of the SDR
+      Benchmark{"pfb_arb_resampler_ccf/0.9", 1000000.0 / 3, [] { return stages::make_resampler(0.9); }},
+  };
+
+  for (auto&& benchmark : chain_benchmarks("demodulator_bits", config::kTetraSampleRate, [] {
+         auto stages = stages::demodulator_stages(/*samples_per_symbol=*/2, config::kTetraSampleRate).stages_;
+         for (auto&& stage : stages::bit_decoder_stages()) {
+           stages.push_back(std::move(stage));
+         }
+         return stages;
+       })) {
+    benchmarks.push_back(std::move(benchmark));
+  }
+  for (auto&& benchmark : chain_benchmarks("demodulator_iq", config::kTetraSampleRate, [] {
+         return stages::demodulator_stages(/*samples_per_symbol=*/1, config::kTetraSampleRate).stages_;
+       })) {
+    benchmarks.push_back(std::move(benchmark));
+  }
+  for (auto&& benchmark : chain_benchmarks("demodulator_uplink", config::kTetraSampleRate, [] {
+         return stages::burst_demodulator_stages(config::kTetraSampleRate, /*center_frequency=*/0);
+       })) {
+    benchmarks.push_back(std::move(benchmark));
+  }
+  // the streams of a Decimate block in the lanes of one batch, the time is per sample of all lanes
+  benchmarks.push_back(Benchmark{"batch_demodulator/16", config::kTetraSampleRate, [] {
+                                   return stages::make_batch_demodulator(/*lanes=*/16, config::kTetraSampleRate);
+                                 }});
+  benchmarks.push_back(Benchmark{"soft_bit_framer", graph::kSymbolRate,
+                                 [] { return stages::make_soft_bit_framer(/*center_frequency=*/0); }});
+  for (auto&& benchmark : chain_benchmarks("power_meter", config::kTetraSampleRate,
+                                           [] { return stages::power_meter_stages(config::kTetraSampleRate); })) {
+    benchmarks.push_back(std::move(benchmark));
+  }
+
+  return benchmarks;
+}
+
+static auto read_file(const std::string& path) -> std::string {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::invalid_argument("Could not open " + path);
+  }
+
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+static auto write_file(const std::string& path, const std::string& content) -> void {
+  std::ofstream file(path);
+  if (!file) {
+    throw std::invalid_argument("Could not open " + path);
+  }
+
+  file << content;
+}
+
+auto main(int argc, char** argv) -> int {
+  try {
+    cxxopts::Options options("benchmarks", "Benchmark each DSP stage of the tetra-receiver in isolation");
+
+    // clang-format off
+    options.add_options()
+      ("h,help", "Print usage")
+      ("output", "Write the results as JSON to this file instead of stdout", cxxopts::value<std::string>()->default_value(""))
+      ("baseline", "Compare the results with the results in this JSON file", cxxopts::value<std::string>()->default_value(""))
+      ("tolerance", "The fraction by which a stage may be slower than its baseline", cxxopts::value<double>()->default_value("0.1"))
+      ("update-baseline", "Write the results to the baseline file instead of comparing them")
+      ("filter", "Only run the benchmarks whose name contains this string", cxxopts::value<std::string>()->default_value(""))
+      ("seconds", "Seconds of canned input per stage", cxxopts::value<double>()->default_value("2"))
+      ("repetitions", "Repetitions of each benchmark, the median is reported", cxxopts::value<unsigned int>()->default_value("5"))
+      ;
+    // clang-format on
+
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+      std::cout << options.help() << std::endl;
+      return EXIT_SUCCESS;
+    }
+
+    const auto& output = result["output"].as<std::string>();
+    const auto& baseline = result["baseline"].as<std::string>();
+    const auto tolerance = result["tolerance"].as<double>();
+    const bool update_baseline = result.count("update-baseline");
+    const auto& filter = result["filter"].as<std::string>();
+    const auto seconds = result["seconds"].as<double>();
+    const auto repetitions = std::max(result["repetitions"].as<unsigned int>(), 1u);
+
+    if (update_baseline && baseline.empty()) {
+      throw std::invalid_argument("--update-baseline needs the --baseline file to write.");
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const auto& benchmark : all_benchmarks()) {
+      if (benchmark.name_.find(filter) == std::string::npos) {
+        continue;
+      }
+
+      results.push_back(run(benchmark, seconds, repetitions));
+      std::cerr << benchmark.name_ << ": " << results.back().ns_per_item_ << " ns/item" << std::endl;
+    }
+
+    const auto json = to_json(results, gr::version(), volk_get_machine());
+    if (output.empty()) {
+      std::cout << json;
+    } else {
+      write_file(output, json);
+    }
+
+    if (baseline.empty()) {
+      return EXIT_SUCCESS;
+    }
+
+    if (update_baseline) {
+      write_file(baseline, json);
+      return EXIT_SUCCESS;
+    }
+
+    bool regression = false;
+    for (const auto& comparison : compare(results, from_json(read_file(baseline)), tolerance)) {
+      if (!comparison.baseline_ns_per_item_) {
+        std::cerr << "NEW        " << comparison.name_ << ": " << comparison.ns_per_item_ << " ns/item" << std::endl;
+        continue;
+      }
+
+      std::cerr << (comparison.regression_ ? "REGRESSION " : "OK         ") << comparison.name_ << ": "
+                << comparison.ns_per_item_ << " ns/item, baseline " << *comparison.baseline_ns_per_item_
+                << " ns/item" << std::endl;
+      regression |= comparison.regression_;
+    }
+
+    return regression ? EXIT_FAILURE : EXIT_SUCCESS;
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
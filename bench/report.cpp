@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include "report.h"
+
+auto to_json(const std::vector<BenchmarkResult>& results, const std::string& gnuradio_version,
+             const std::string& volk_machine) -> std::string {
+  std::ostringstream out;
+  out << std::setprecision(6);
+
+  // one benchmark per line, so from_json does not need a full JSON parser
+  out << "{\n";
+  out << "  \"gnuradio_version\": \"" << gnuradio_version << "\",\n";
+  out << "  \"volk_machine\": \"" << volk_machine << "\",\n";
+  out << "  \"benchmarks\": [\n";
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const auto& result = results[i];
+    out << "    {\"name\": \"" << result.name_ << "\", \"items\": " << result.items_
+        << ", \"ns_per_item\": " << result.ns_per_item_
+        << ", \"items_per_second\": " << 1e9 / result.ns_per_item_ << "}";
+    out << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  out << "  ]\n";
+  out << "}\n";
+
+  return out.str();
+}
+
+auto from_json(const std::string& json) -> std::vector<BenchmarkResult> {
+  static const std::regex kBenchmark(
+      R"re(\{"name": "([^"]+)", "items": ([0-9]+), "ns_per_item": ([-+0-9.eE]+))re");
+
+  static const std::regex kName(R"re(\{"name": )re");
+
+  if (json.find("\"benchmarks\": [") == std::string::npos) {
+    throw std::invalid_argument("The JSON does not contain a list of benchmarks.");
+  }
+
+  std::vector<BenchmarkResult> results;
+  for (auto it = std::sregex_iterator(json.begin(), json.end(), kBenchmark); it != std::sregex_iterator(); ++it) {
+    const auto& match = *it;
+    results.push_back(BenchmarkResult{/*name=*/match[1].str(), /*items=*/std::stoull(match[2].str()),
+                                      /*ns_per_item=*/std::stod(match[3].str())});
+  }
+
+  const auto benchmarks = static_cast<std::size_t>(
+      std::distance(std::sregex_iterator(json.begin(), json.end(), kName), std::sregex_iterator()));
+  if (benchmarks != results.size()) {
+    throw std::invalid_argument("The JSON contains " + std::to_string(benchmarks) + " benchmarks, but only " +
+                                std::to_string(results.size()) + " of them could be read.");
+  }
+
+  return results;
+}
+
+auto compare(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>& baseline,
+             const double tolerance) -> std::vector<Comparison> {
+  std::vector<Comparison> comparisons;
+
+  for (const auto& result : results) {
+    Comparison comparison{/*name=*/result.name_, /*baseline_ns_per_item=*/std::nullopt,
+                          /*ns_per_item=*/result.ns_per_item_, /*regression=*/false};
+
+    const auto it = std::find_if(baseline.begin(), baseline.end(),
+                                 [&result](const BenchmarkResult& other) { return other.name_ == result.name_; });
+    if (it != baseline.end()) {
+      comparison.baseline_ns_per_item_ = it->ns_per_item_;
+      comparison.regression_ = result.ns_per_item_ > it->ns_per_item_ * (1.0 + tolerance);
+    }
+
+    comparisons.push_back(comparison);
+  }
+
+  return comparisons;
+}
@@ -0,0 +1,49 @@
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/// The result of the benchmark of one stage
+class BenchmarkResult {
+public:
+  /// the name of the benchmark
+  std::string name_;
+  /// the number of input items the stage processed per repetition
+  uint64_t items_ = 0;
+  /// the median time the stage needed per input item
+  double ns_per_item_ = 0;
+};
+
+/// The comparison of a benchmark result with its baseline
+class Comparison {
+public:
+  /// the name of the benchmark
+  std::string name_;
+  /// the time per input item of the baseline, if the baseline contains the benchmark
+  std::optional<double> baseline_ns_per_item_;
+  /// the time per input item of the current run
+  double ns_per_item_ = 0;
+  /// true if the current run is slower than the baseline by more than the tolerance
+  bool regression_ = false;
+};
+
+/// Serialize the results as JSON together with the versions of the libraries they were measured with
+auto to_json(const std::vector<BenchmarkResult>& results, const std::string& gnuradio_version,
+             const std::string& volk_machine) -> std::string;
+
+/// Read the results from JSON that was written by to_json. Throws std::invalid_argument if the JSON has no list of
+/// benchmarks or a benchmark in it cannot be read, so a broken baseline is not taken as one without benchmarks.
+auto from_json(const std::string& json) -> std::vector<BenchmarkResult>;
+
+/// Compare the results with the baseline. A benchmark that is missing in the baseline has no baseline time and is no
+/// regression, benchmarks that are only in the baseline are ignored.
+/// \param results the results of the current run
+/// \param baseline the results of the baseline
+/// \param tolerance the fraction by which a benchmark may be slower than its baseline
+auto compare(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>& baseline,
+             double tolerance) -> std::vector<Comparison>;
+
+#endif // BENCH_REPORT_H
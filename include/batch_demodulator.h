@@ -0,0 +1,48 @@
+#ifndef BATCH_DEMODULATOR_H
+#define BATCH_DEMODULATOR_H
+
+#include <vector>
+
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+
+#include "lanes.h"
+
+namespace gr::tetra {
+
+/// This block demodulates several TETRA streams with the same sample rate in the SIMD lanes of one block, instead of
+/// one chain of blocks per stream. Each input is the channel filtered samples of one stream and the output with the
+/// same index carries its differentially decoded symbols, like the output of the chain of a single stream. The streams
+/// are consumed in lockstep, but each lane recovers its own symbol timing, so the outputs produce different numbers of
+/// symbols.
+class BatchDemodulator : virtual public block {
+private:
+  /// the demodulator of all lanes
+  lanes::Demodulator demodulator_;
+  /// the pointers to the inputs and the outputs of each lane
+  std::vector<const gr_complex*> inputs_;
+  std::vector<gr_complex*> outputs_;
+  /// the number of symbols produced by each lane
+  std::vector<std::size_t> produced_;
+
+public:
+  using sptr = boost::shared_ptr<BatchDemodulator>;
+
+  BatchDemodulator() = delete;
+
+  /// \param lanes the number of streams
+  /// \param input_sample_rate the sample rate of the streams
+  /// \param symbol_rate the symbol rate of the streams
+  BatchDemodulator(unsigned int lanes, unsigned int input_sample_rate, unsigned int symbol_rate);
+
+  static auto make(unsigned int lanes, unsigned int input_sample_rate, unsigned int symbol_rate) -> sptr;
+
+  auto forecast(int noutput_items, gr_vector_int& ninput_items_required) -> void override;
+
+  auto general_work(int noutput_items, gr_vector_int& ninput_items, gr_vector_const_void_star& input_items,
+                    gr_vector_void_star& output_items) -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // BATCH_DEMODULATOR_H
@@ -0,0 +1,160 @@
+#ifndef BURST_H
+#define BURST_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/// The acquisition and demodulation of single TETRA uplink bursts. Instead of loops that track a continuous carrier,
+/// the energy of each burst is detected and its timing and frequency offset are estimated feedforward from the
+/// differential correlation with the training sequence in a window of buffered samples around it. Only this window is
+/// demodulated. The bursts and their training sequences are described in ETSI EN 300 392-2, clause 9.4.4.
+namespace burst {
+
+/// The number of samples per symbol the bursts are demodulated at
+[[maybe_unused]] static constexpr unsigned int kSamplesPerSymbol = 4;
+/// The number of symbols of a timeslot
+[[maybe_unused]] static constexpr unsigned int kSlotSymbols = 255;
+/// The number of bits of a normal uplink burst, which fills a timeslot
+[[maybe_unused]] static constexpr unsigned int kNormalBurstBits = 462;
+/// The number of bits of a control uplink burst, which fills one half of a timeslot
+[[maybe_unused]] static constexpr unsigned int kControlBurstBits = 206;
+/// The number of symbols before the detected start of the energy and after the end of a normal burst that are kept
+/// in the window, which cover the ramping of the transmitter and the delay of the detection
+[[maybe_unused]] static constexpr unsigned int kGuardSymbols = 8;
+/// The smallest magnitude of the normalized correlation with the training sequence of an accepted burst
+[[maybe_unused]] static constexpr float kMinimumQuality = 0.8f;
+/// The factor by which the power has to exceed the noise floor to detect a burst, 10 dB
+[[maybe_unused]] static constexpr float kDetectionThreshold = 10.0f;
+
+/// The kinds of uplink bursts, which are told apart by their training sequence
+enum class BurstType : uint8_t {
+  /// a normal uplink burst with the normal training sequence 1, which carries one logical channel
+  kNormalUplink = 1,
+  /// a normal uplink burst with the normal training sequence 2, whose halves carry the stealing channel
+  kNormalUplinkStolen = 2,
+  /// a control uplink burst with the extended training sequence
+  kControlUplink = 3,
+};
+
+/// The training sequence of a kind of burst and its position in the burst
+class TrainingSequence {
+public:
+  /// the kind of burst with this training sequence
+  BurstType burst_type_ = BurstType::kNormalUplink;
+  /// the number of bits of the burst
+  unsigned int burst_bits_ = 0;
+  /// the position of the first bit of the training sequence in the burst, always at the start of a symbol
+  unsigned int position_ = 0;
+  /// the bits of the training sequence
+  std::vector<uint8_t> bits_;
+};
+
+/// The training sequences of the normal and the control uplink bursts
+auto training_sequences() -> const std::vector<TrainingSequence>&;
+
+/// The phase change of the π/4-DQPSK symbol of two bits: 00 is +π/4, 01 is +3π/4, 10 is -π/4 and 11 is -3π/4
+auto phase_change(uint8_t first_bit, uint8_t second_bit) noexcept -> float;
+
+/// Detect the rising edge of the energy of a burst against the noise floor. The floor follows the power between the
+/// bursts, and a burst is only detected again after the power fell back below the threshold. A power that stays above
+/// the threshold for longer than two timeslots is not a burst and becomes the new noise floor.
+class EnergyDetector {
+private:
+  /// the smoothing factors of the power and of the noise floor per sample
+  const float power_smoothing_;
+  const float floor_smoothing_;
+  /// the factor by which the power has to exceed the noise floor
+  const float threshold_;
+  /// the number of samples of two timeslots
+  const std::size_t max_burst_samples_;
+  /// the smoothed power of the samples
+  float power_ = 0;
+  /// the power between the bursts, unknown until the first sample
+  std::optional<float> noise_floor_;
+  /// the number of samples since the power rose above the threshold
+  std::size_t samples_above_ = 0;
+  /// true once the power fell below the threshold after the previous burst
+  bool armed_ = false;
+
+public:
+  EnergyDetector() = delete;
+
+  /// \param samples_per_symbol the number of samples per symbol, the power is smoothed over about one symbol
+  /// \param threshold the factor by which the power has to exceed the noise floor
+  explicit EnergyDetector(unsigned int samples_per_symbol, float threshold = kDetectionThreshold);
+
+  /// Add the next sample
+  /// \return true if a burst starts at this sample
+  auto push(std::complex<float> sample) noexcept -> bool;
+
+  /// the current estimate of the power between the bursts
+  [[nodiscard]] auto noise_floor() const noexcept -> float { return noise_floor_.value_or(0); };
+};
+
+/// The kind, timing and frequency offset of a burst in a window of samples
+class Estimate {
+public:
+  /// the kind of burst
+  BurstType burst_type_ = BurstType::kNormalUplink;
+  /// the number of bits of the burst
+  unsigned int burst_bits_ = 0;
+  /// the position of the first symbol of the burst in the window in samples
+  double start_ = 0;
+  /// the phase change per symbol caused by the frequency offset
+  float phase_drift_ = 0;
+  /// the frequency offset of the burst in Hz
+  double frequency_offset_ = 0;
+  /// the magnitude of the correlation with the training sequence normalized to one
+  float quality_ = 0;
+};
+
+/// Estimate the kind, timing and frequency offset of a burst in a window of matched filtered samples and demodulate
+/// it. The window is correlated with the phase changes of each training sequence at symbol spacing. The differential
+/// products do not depend on the phase of the carrier, and a frequency offset only rotates all of them by the same
+/// angle, so the peak of the correlation gives the timing and its angle the frequency offset.
+class BurstEstimator {
+private:
+  /// the number of samples per symbol of the windows
+  const unsigned int samples_per_symbol_;
+  /// the symbol rate of the bursts
+  const double symbol_rate_;
+  /// the smallest normalized correlation of an accepted burst
+  const float minimum_quality_;
+  /// the conjugated phase changes of the symbols of each training sequence
+  std::vector<std::vector<std::complex<float>>> references_;
+  /// the differential products of the samples one symbol apart
+  std::vector<std::complex<float>> products_;
+
+public:
+  BurstEstimator() = delete;
+
+  /// \param samples_per_symbol the number of samples per symbol of the windows
+  /// \param symbol_rate the symbol rate of the bursts
+  /// \param minimum_quality the smallest normalized correlation with the training sequence of an accepted burst
+  BurstEstimator(unsigned int samples_per_symbol, double symbol_rate, float minimum_quality = kMinimumQuality);
+
+  /// Find the kind and the position of the burst whose training sequence correlates best with the window.
+  /// \param samples the window of matched filtered samples
+  /// \param count the number of samples in the window
+  /// \param max_start the last sample of the window at which a burst may start
+  /// \return the estimate of the burst, or nothing if no burst of any kind fits into the window or none is correlated
+  /// well enough with its training sequence
+  auto estimate(const std::complex<float>* samples, std::size_t count, std::size_t max_start)
+      -> std::optional<Estimate>;
+
+  /// Demodulate the burst into int8 log-likelihood ratios of its bits, positive values are ones. The bits of symbols
+  /// outside of the window are zero.
+  /// \param samples the window of matched filtered samples the burst was estimated in
+  /// \param count the number of samples in the window
+  /// \param estimate the estimate of the burst
+  /// \param soft_bits the estimate.burst_bits_ soft bits of the burst
+  auto demodulate(const std::complex<float>* samples, std::size_t count, const Estimate& estimate,
+                  int8_t* soft_bits) const noexcept -> void;
+};
+
+} // namespace burst
+
+#endif // BURST_H
@@ -0,0 +1,67 @@
+#ifndef BURST_DEMODULATOR_H
+#define BURST_DEMODULATOR_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+
+#include "burst.h"
+#include "udp_frame.h"
+
+namespace gr::tetra {
+
+/// This block demodulates the bursts of a TETRA uplink carrier. It takes matched filtered samples at
+/// burst::kSamplesPerSymbol samples per symbol, detects the rising energy of each burst and buffers a window around
+/// it. The kind, timing and frequency offset of the burst are estimated from its training sequence in this window, and
+/// only the window is demodulated. Each output item is one frame of the soft bits of one burst, which is sent as one
+/// UDP datagram. The frames have the size of a normal uplink burst, shorter bursts are padded with zeros.
+class BurstDemodulator : virtual public block {
+private:
+  /// the number of samples of the guard symbols before and after a burst
+  const std::size_t guard_samples_;
+  /// the number of samples of the window around a burst, long enough for a normal uplink burst
+  const std::size_t window_samples_;
+  /// the last sample of the window at which the first symbol of a burst may start
+  const std::size_t max_start_;
+  /// the detector of the start of the bursts
+  burst::EnergyDetector detector_;
+  /// the estimator of the bursts in their windows
+  burst::BurstEstimator estimator_;
+  /// the header of the next frame
+  udp_frame::Header header_;
+  /// the samples that may still be part of a window
+  std::vector<gr_complex> samples_;
+  /// the number of the first sample of samples_ since the start of the stream
+  uint64_t first_sample_ = 0;
+  /// the number of samples of samples_ that were passed to the detector
+  std::size_t scanned_ = 0;
+  /// the sample in samples_ at which the energy of the next burst rose, until its window is complete
+  std::optional<std::size_t> trigger_;
+
+  /// Write the frame of the burst
+  /// \param estimate the estimate of the burst in the window
+  /// \param window the position of the window in samples_
+  /// \param frame the output item of the frame
+  auto write_frame(const burst::Estimate& estimate, std::size_t window, uint8_t* frame) -> void;
+
+public:
+  using sptr = boost::shared_ptr<BurstDemodulator>;
+
+  BurstDemodulator() = delete;
+
+  /// \param symbol_rate the symbol rate of the bursts
+  /// \param center_frequency the center frequency of the stream, which is sent in each frame
+  BurstDemodulator(unsigned int symbol_rate, unsigned int center_frequency);
+
+  static auto make(unsigned int symbol_rate, unsigned int center_frequency) -> sptr;
+
+  auto general_work(int noutput_items, gr_vector_int& ninput_items, gr_vector_const_void_star& input_items,
+                    gr_vector_void_star& output_items) -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // BURST_DEMODULATOR_H
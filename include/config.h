@@ -13,6 +13,8 @@
 
 #include <toml.hpp>
 
+#include "sample_format.h"
+
 namespace config {
 
 /// The sample rate of the TETRA Stream
@@ -22,10 +24,45 @@ namespace config {
 [[maybe_unused]] const std::string kDefaultHost = "127.0.0.1";
 [[maybe_unused]] constexpr uint16_t kDefaultPort = 42000;
 
+/// The fraction of the output bandwidth of a resampling Decimate block that is free of aliases
+[[maybe_unused]] static constexpr double kResamplerPassband = 0.8;
+
+/// The default number of seconds before and after a trigger that are recorded
+constexpr unsigned int kDefaultPreTriggerSeconds = 10;
+constexpr unsigned int kDefaultPostTriggerSeconds = 5;
+/// The default directory to which the recordings are written
+const std::string kDefaultRecordingDirectory = ".";
+
+/// The default number of seconds of samples the buffer after the SDR source holds
+constexpr double kDefaultSourceBufferSeconds = 1.0;
+
+/// The default number of seconds a scanning slot listens to a carrier before it moves on
+constexpr double kDefaultDwellSeconds = 1.0;
+/// The default number of seconds a scanning slot stays on a carrier that carries a signal
+constexpr double kDefaultMaxDwellSeconds = 5.0;
+
 // The default host to which we send the signal strength data for prometheus
 const std::string kDefaultPrometheusHost = "127.0.0.1";
 constexpr uint16_t kDefaultPrometheusPort = 9010;
 
+/// The kinds of TETRA carriers a Stream demodulates
+enum class StreamMode {
+  /// the continuous carrier of a base station
+  kDownlink,
+  /// the bursts of the mobile stations
+  kUplink,
+};
+
+/// Parse the name of a stream mode
+[[maybe_unused]] static auto stream_mode_from_string(const std::string& name) -> StreamMode {
+  if (name == "downlink")
+    return StreamMode::kDownlink;
+  if (name == "uplink")
+    return StreamMode::kUplink;
+
+  throw std::invalid_argument("Unknown stream mode " + name + ". Use one of downlink or uplink.");
+}
+
 template <typename T> class Range {
 private:
   T min_ = 0;
@@ -81,6 +118,66 @@ public:
   friend auto operator!=(const SpectrumSlice<T>& lhs, const SpectrumSlice<T>& rhs) -> bool { return !(lhs == rhs); };
 };
 
+class Recorder {
+public:
+  /// the number of seconds before the trigger that are kept in memory and written to disk
+  const unsigned int pre_trigger_seconds_;
+  /// the number of seconds after the trigger that are written to disk
+  const unsigned int post_trigger_seconds_;
+  /// the directory to which the recordings are written
+  const std::string directory_;
+  /// Optional field
+  /// Trigger a recording when the mean power of the samples exceeds this threshold
+  const std::optional<float> power_threshold_;
+  /// True if the ring buffer should be backed by huge pages
+  const bool huge_pages_;
+
+  Recorder() = delete;
+
+  /// Describe a recorder that keeps the last samples in a ring buffer in memory and writes them to disk when it is
+  /// triggered by SIGUSR1 or by the power threshold
+  /// \param pre_trigger_seconds the number of seconds before the trigger that are recorded
+  /// \param post_trigger_seconds the number of seconds after the trigger that are recorded
+  /// \param directory the directory to which the recordings are written
+  /// \param power_threshold the optional power threshold that triggers a recording
+  /// \param huge_pages back the ring buffer with huge pages
+  Recorder(unsigned int pre_trigger_seconds, unsigned int post_trigger_seconds, std::string directory,
+           std::optional<float> power_threshold, bool huge_pages);
+};
+
+class SourceBuffer {
+public:
+  /// the number of seconds of samples the buffer holds
+  const double seconds_;
+  /// True if the buffer should be backed by huge pages
+  const bool huge_pages_;
+
+  SourceBuffer() = delete;
+
+  /// Describe the ring buffer between the SDR source and the rest of the flowgraph, which drops samples when the
+  /// flowgraph falls behind instead of back-pressuring the SDR
+  /// \param seconds the number of seconds of samples the buffer holds
+  /// \param huge_pages back the buffer with huge pages
+  SourceBuffer(double seconds, bool huge_pages);
+};
+
+class Export {
+public:
+  /// the host to which the frames are sent
+  const std::string host_;
+  /// the port to which the frames are sent
+  const uint16_t port_;
+
+  Export() = delete;
+
+  /// Describe where the decimated samples of a Decimate block are sent to, so they can be imported by another process
+  /// \param host the host to which the frames are sent
+  /// \param port the port to which the frames are sent
+  Export(std::string host, const uint16_t port)
+      : host_(std::move(host))
+      , port_(port){};
+};
+
 class Stream {
 public:
   /// the name of the table in the config
@@ -101,6 +198,10 @@ public:
   const uint16_t port_ = 0;
   /// True if we send out iq data.
   const bool send_iq_;
+  /// True if we send out framed int8 soft decisions of the bits instead of hard decisions.
+  const bool send_soft_bits_;
+  /// The kind of carrier. The bursts of an uplink are sent as frames of their soft bits.
+  const StreamMode mode_;
 
   Stream() = delete;
 
@@ -112,8 +213,49 @@ public:
   /// \param host the to send the data to
   /// \param port the port to send the data to
   /// \param send_iq do we send decoded bits or iq data.
+  /// \param send_soft_bits do we send soft decisions of the bits instead of hard decisions.
+  /// \param mode the kind of carrier
   Stream(const std::string& name, const SpectrumSlice<unsigned int>& input_spectrum,
-         const SpectrumSlice<unsigned int>& spectrum, std::string host, uint16_t port, bool send_iq);
+         const SpectrumSlice<unsigned int>& spectrum, std::string host, uint16_t port, bool send_iq,
+         bool send_soft_bits, StreamMode mode);
+};
+
+class Scan {
+public:
+  /// the name of the table in the config
+  const std::string name_;
+  /// the slice of spectrum that is input to this block
+  const SpectrumSlice<unsigned int> input_spectrum_;
+  /// the center frequencies of the candidate carriers
+  const std::vector<unsigned int> frequencies_;
+  /// the number of demodulators that are time-shared between the carriers
+  const std::size_t slots_;
+  /// the number of seconds a slot listens to a carrier before it moves on
+  const double dwell_seconds_;
+  /// the number of seconds a slot stays on a carrier that carries a signal
+  const double max_dwell_seconds_;
+  /// the host to which the frames of soft bits of all slots are sent
+  const std::string host_;
+  /// the port to which the frames of soft bits of all slots are sent
+  const uint16_t port_;
+  /// the decimation from the input to the TETRA sample rate
+  unsigned int decimation_ = 0;
+
+  Scan() = delete;
+
+  /// Describe a pool of demodulator slots that scan a list of carriers. Each slot dwells on one carrier at a time and
+  /// sends frames of soft bits that carry the frequency of the carrier they were demodulated from.
+  /// \param name the name of the table in the config
+  /// \param input_spectrum the slice of spectrum that is input to this block
+  /// \param frequencies the center frequencies of the candidate carriers
+  /// \param slots the number of demodulators
+  /// \param dwell_seconds the number of seconds a slot listens to a carrier
+  /// \param max_dwell_seconds the number of seconds a slot stays on a carrier that carries a signal
+  /// \param host the host to send the frames to
+  /// \param port the port to send the frames to
+  Scan(const std::string& name, const SpectrumSlice<unsigned int>& input_spectrum,
+       std::vector<unsigned int> frequencies, std::size_t slots, double dwell_seconds, double max_dwell_seconds,
+       std::string host, uint16_t port);
 };
 
 class Decimate {
@@ -125,13 +267,27 @@ public:
   /// the slice of spectrum after decimation_
   const SpectrumSlice<unsigned int> spectrum_;
 
-  /// the decimation of this block
+  /// the integer decimation of this block
   unsigned int decimation_ = 0;
+  /// the rate of the arbitrary resampler after the integer decimation. This is one if the input sample rate is
+  /// divisible by the sample rate of this block.
+  double resampling_rate_ = 1.0;
 
   /// The vector of streams the output of this Decimate block should be
   /// connected to.
   std::vector<Stream> streams_;
 
+  /// The vector of scans of the output of this Decimate block
+  std::vector<Scan> scans_;
+
+  /// Optional field
+  /// The recorder of the output of this Decimate block
+  std::optional<Recorder> recorder_;
+
+  /// Optional field
+  /// Send the output of this Decimate block to another process
+  std::optional<Export> export_;
+
   Decimate() = delete;
 
   /// Describe the decimation of the SDR Stream by the frequency where we want
@@ -143,6 +299,11 @@ public:
   /// to
   Decimate(const std::string& name, const SpectrumSlice<unsigned int>& input_spectrum,
            const SpectrumSlice<unsigned int>& spectrum);
+
+  /// The frequency Range after decimation which is free of aliases. If the sample rate is reached by resampling, the
+  /// anti-aliasing filter of the resampler only passes kResamplerPassband of the bandwidth. resampler::taps puts the
+  /// edge of its passband at the edge of this Range.
+  [[nodiscard]] auto passband() const noexcept -> Range<unsigned int>;
 };
 
 class Prometheus {
@@ -168,26 +329,50 @@ public:
   const SpectrumSlice<unsigned int> spectrum_;
   /// The device string for the SDR source block
   const std::string device_string_{};
+  /// Optional field
+  /// Read the samples from this file or fifo instead of the SDR source block
+  const std::string input_file_{};
+  /// Optional field
+  /// Receive the samples exported by a Decimate block of another process on this UDP port instead of the SDR source
+  /// block
+  const std::optional<uint16_t> input_port_;
+  /// The format of the samples in the input file
+  const SampleFormat sample_format_;
   /// The RF gain setting of the SDR
   const unsigned int rf_gain_;
   /// The IF gain setting of the SDR
   const unsigned int if_gain_;
   /// The BB gain setting of the SDR
   const unsigned int bb_gain_;
+  /// Trade throughput for a bounded latency by shrinking the buffers along each chain
+  const bool low_latency_;
+  /// Demodulate the downlink streams that share an input together in the SIMD lanes of one block
+  const bool batch_demodulators_;
+  /// Run the blocks in a fixed number of threads, one per partition of the flowgraph, instead of one thread per block
+  const bool thread_pool_;
   /// The vector of Streams which should be directly decoded from the input of
   /// the SDR.
   const std::vector<Stream> streams_{};
   /// The vector of decimators which should first Decimate a signal of the SDR
   /// and then sent it to the vector of streams inside them.
   const std::vector<Decimate> decimators_{};
+  /// The vector of scans which share demodulators between the carriers of the SDR
+  const std::vector<Scan> scans_{};
   /// Optional config element for the prometheus exporter
   const std::unique_ptr<Prometheus> prometheus_;
+  /// Optional config element for the recorder of the samples of the SDR
+  const std::optional<Recorder> recorder_;
+  /// Optional config element for the ring buffer after the SDR source
+  const std::optional<SourceBuffer> source_buffer_;
 
   TopLevel() = delete;
 
-  TopLevel(const SpectrumSlice<unsigned int>& spectrum, std::string device_string, unsigned int rf_gain,
-           unsigned int if_gain, unsigned int bb_gain, const std::vector<Stream>& streams,
-           const std::vector<Decimate>& decimators, std::unique_ptr<Prometheus>&& prometheus);
+  TopLevel(const SpectrumSlice<unsigned int>& spectrum, std::string device_string, std::string input_file,
+           std::optional<uint16_t> input_port, SampleFormat sample_format, unsigned int rf_gain, unsigned int if_gain,
+           unsigned int bb_gain, bool low_latency, bool batch_demodulators, bool thread_pool,
+           const std::vector<Stream>& streams, const std::vector<Decimate>& decimators,
+           const std::vector<Scan>& scans, std::unique_ptr<Prometheus>&& prometheus,
+           std::optional<Recorder> recorder, std::optional<SourceBuffer> source_buffer);
 };
 
 using decimate_or_stream = std::variant<Decimate, Stream>;
@@ -212,13 +397,27 @@ static config::decimate_or_stream get_decimate_or_stream(const config::SpectrumS
     return config::Decimate(name, input_spectrum, config::SpectrumSlice<unsigned int>(frequency, *sample_rate));
   } else {
     const bool send_iq = find_or(v, "SendIQ", false);
+    const bool send_soft_bits = find_or(v, "SendSoftBits", false);
+    const auto mode = config::stream_mode_from_string(find_or(v, "Mode", std::string("downlink")));
 
     return config::Stream(name, input_spectrum,
                           config::SpectrumSlice<unsigned int>(frequency, config::kTetraSampleRate), host, port,
-                          send_iq);
+                          send_iq, send_soft_bits, mode);
   }
 }
 
+static config::Scan get_scan(const config::SpectrumSlice<unsigned int>& input_spectrum, const std::string& name,
+                             const value& v) {
+  const auto frequencies = find<std::vector<unsigned int>>(v, "Frequencies");
+  const std::size_t slots = find<std::size_t>(v, "Slots");
+  const double dwell_seconds = find_or(v, "Dwell", config::kDefaultDwellSeconds);
+  const double max_dwell_seconds = find_or(v, "MaxDwell", config::kDefaultMaxDwellSeconds);
+  const std::string host = find_or(v, "Host", config::kDefaultHost);
+  const uint16_t port = find_or(v, "Port", config::kDefaultPort);
+
+  return config::Scan(name, input_spectrum, frequencies, slots, dwell_seconds, max_dwell_seconds, host, port);
+}
+
 template <> struct from<std::unique_ptr<config::Prometheus>> {
   static auto from_toml(const value& v) -> std::unique_ptr<config::Prometheus> {
     const std::string prometheus_host = find_or(v, "Host", config::kDefaultPrometheusHost);
@@ -228,20 +427,66 @@ template <> struct from<std::unique_ptr<config::Prometheus>> {
   }
 };
 
+template <> struct from<config::Recorder> {
+  static auto from_toml(const value& v) -> config::Recorder {
+    const unsigned int pre_trigger_seconds = find_or(v, "PreTrigger", config::kDefaultPreTriggerSeconds);
+    const unsigned int post_trigger_seconds = find_or(v, "PostTrigger", config::kDefaultPostTriggerSeconds);
+    const std::string directory = find_or(v, "Directory", config::kDefaultRecordingDirectory);
+    const bool huge_pages = find_or(v, "HugePages", false);
+
+    std::optional<float> power_threshold;
+    if (v.contains("PowerThreshold"))
+      power_threshold = find<float>(v, "PowerThreshold");
+
+    return config::Recorder(pre_trigger_seconds, post_trigger_seconds, directory, power_threshold, huge_pages);
+  }
+};
+
+template <> struct from<config::Export> {
+  static auto from_toml(const value& v) -> config::Export {
+    const std::string host = find_or(v, "Host", config::kDefaultHost);
+    const uint16_t port = find<uint16_t>(v, "Port");
+
+    return config::Export(host, port);
+  }
+};
+
+template <> struct from<config::SourceBuffer> {
+  static auto from_toml(const value& v) -> config::SourceBuffer {
+    const double seconds = find_or(v, "Seconds", config::kDefaultSourceBufferSeconds);
+    const bool huge_pages = find_or(v, "HugePages", false);
+
+    return config::SourceBuffer(seconds, huge_pages);
+  }
+};
+
 template <> struct from<config::TopLevel> {
   static auto from_toml(const value& v) -> config::TopLevel {
     const unsigned int center_frequency = find<unsigned int>(v, "CenterFrequency");
-    const std::string device_string = find<std::string>(v, "DeviceString");
+    const std::string input_file = find_or(v, "InputFile", std::string());
+    std::optional<uint16_t> input_port;
+    if (v.contains("InputPort"))
+      input_port = find<uint16_t>(v, "InputPort");
+    // the device string is only needed if we do not read from a file or from another process
+    const std::string device_string = input_file.empty() && !input_port ? find<std::string>(v, "DeviceString")
+                                                                        : find_or(v, "DeviceString", std::string());
+    const auto sample_format = config::sample_format_from_string(find_or(v, "SampleFormat", std::string("cf32")));
     const unsigned int sample_rate = find<unsigned int>(v, "SampleRate");
     const unsigned int rf_gain = find_or(v, "RFGain", 0);
     const unsigned int if_gain = find_or(v, "IFGain", 0);
     const unsigned int bb_gain = find_or(v, "BBGain", 0);
+    const bool low_latency = find_or(v, "LowLatency", false);
+    const bool batch_demodulators = find_or(v, "BatchDemodulators", false);
+    const bool thread_pool = find_or(v, "ThreadPool", false);
 
     config::SpectrumSlice<unsigned int> sdr_spectrum(center_frequency, sample_rate);
 
     std::vector<config::Stream> streams;
     std::vector<config::Decimate> decimators;
+    std::vector<config::Scan> scans;
     std::unique_ptr<config::Prometheus> prometheus;
+    std::optional<config::Recorder> recorder;
+    std::optional<config::SourceBuffer> source_buffer;
 
     // Iterate over all elements in the root table
     for (const auto& root_kv : v.as_table()) {
@@ -258,6 +503,24 @@ template <> struct from<config::TopLevel> {
         continue;
       }
 
+      // If the table is labled "Recorder" record the samples of the SDR
+      if (name == "Recorder") {
+        recorder.emplace(get<config::Recorder>(table));
+        continue;
+      }
+
+      // If the table is labled "SourceBuffer" decouple the SDR from the flowgraph
+      if (name == "SourceBuffer") {
+        source_buffer.emplace(get<config::SourceBuffer>(table));
+        continue;
+      }
+
+      // A table with a list of frequencies is a Scan
+      if (table.contains("Frequencies")) {
+        scans.push_back(get_scan(sdr_spectrum, name, table));
+        continue;
+      }
+
       const auto element = get_decimate_or_stream(sdr_spectrum, name, table);
 
       // Save the Stream
@@ -281,6 +544,23 @@ template <> struct from<config::TopLevel> {
           if (!stream_table.is_table())
             continue;
 
+          // If the subtable is labled "Recorder" record the output of the decimator
+          if (stream_name == "Recorder") {
+            decimate_element.recorder_.emplace(get<config::Recorder>(stream_table));
+            continue;
+          }
+
+          // If the subtable is labled "Export" send the output of the decimator to another process
+          if (stream_name == "Export") {
+            decimate_element.export_.emplace(get<config::Export>(stream_table));
+            continue;
+          }
+
+          if (stream_table.contains("Frequencies")) {
+            decimate_element.scans_.push_back(get_scan(decimate_element.spectrum_, stream_name, stream_table));
+            continue;
+          }
+
           const auto stream_element = get_decimate_or_stream(decimate_element.spectrum_, stream_name, stream_table);
 
           if (!std::holds_alternative<config::Stream>(stream_element)) {
@@ -298,8 +578,9 @@ template <> struct from<config::TopLevel> {
       throw std::invalid_argument("Did not handle a derived type of decimate_or_stream");
     }
 
-    return config::TopLevel(sdr_spectrum, device_string, rf_gain, if_gain, bb_gain, streams, decimators,
-                            std::move(prometheus));
+    return config::TopLevel(sdr_spectrum, device_string, input_file, input_port, sample_format, rf_gain, if_gain,
+                            bb_gain, low_latency, batch_demodulators, thread_pool, streams, decimators, scans,
+                            std::move(prometheus), recorder, source_buffer);
   }
 };
 
@@ -0,0 +1,381 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "config.h"
+#include "udp_frame.h"
+
+/// The intermediate representation of the flowgraph between the config and the gnuradio blocks. It is built from the
+/// config, rewritten by optimization passes and then either instantiated with gnuradio or printed for a dry run.
+namespace graph {
+
+/// The number of rx_time tags per second that are added after the source to measure the latency
+[[maybe_unused]] static constexpr unsigned int kTimestampTagsPerSecond = 10;
+/// The symbol rate and the bit rate of TETRA
+[[maybe_unused]] static constexpr unsigned int kSymbolRate = 18000;
+[[maybe_unused]] static constexpr unsigned int kBitRate = 2 * kSymbolRate;
+
+using NodeId = std::size_t;
+
+/// An output port of a node
+class Port {
+public:
+  /// the node the port belongs to
+  NodeId node_ = 0;
+  /// the index of the output of the node
+  unsigned int index_ = 0;
+
+  friend auto operator==(const Port& lhs, const Port& rhs) -> bool {
+    return lhs.node_ == rhs.node_ && lhs.index_ == rhs.index_;
+  };
+
+  friend auto operator!=(const Port& lhs, const Port& rhs) -> bool { return !(lhs == rhs); };
+};
+
+/// The implementations of a frequency translating, decimating filter
+enum class FilterImplementation {
+  /// the implementation is chosen by the select_filter_implementations pass
+  kUnselected,
+  /// the gnuradio freq_xlating_fir_filter_ccf
+  kFreqXlatingFir,
+  /// the int16 kernels on the native integer samples of the SDR
+  kIntegerXlatingFir,
+  /// a rotator followed by a cascade of short low pass filters, for large decimations
+  kMultistage,
+};
+
+/// The samples of the SDR, either from the osmosdr source, from a file or from the Export of another process
+class Source {
+public:
+  static constexpr const char* kName = "Source";
+  static constexpr bool kMergeable = false;
+
+  std::string device_string_;
+  std::string input_file_;
+  std::optional<uint16_t> input_port_;
+  unsigned int rf_gain_ = 0;
+  unsigned int if_gain_ = 0;
+  unsigned int bb_gain_ = 0;
+};
+
+/// Decouple the consumers from the producer with a ring buffer that drops samples when it is full
+class RingBuffer {
+public:
+  static constexpr const char* kName = "RingBuffer";
+  static constexpr bool kMergeable = true;
+
+  /// the number of seconds of samples the ring buffer holds
+  double seconds_ = 0;
+  bool huge_pages_ = false;
+
+  friend auto operator==(const RingBuffer& lhs, const RingBuffer& rhs) -> bool {
+    return lhs.seconds_ == rhs.seconds_ && lhs.huge_pages_ == rhs.huge_pages_;
+  };
+};
+
+/// Tag the samples with the host time every interval samples
+class TimestampTagger {
+public:
+  static constexpr const char* kName = "TimestampTagger";
+  static constexpr bool kMergeable = true;
+
+  uint64_t interval_ = 0;
+
+  friend auto operator==(const TimestampTagger& lhs, const TimestampTagger& rhs) -> bool {
+    return lhs.interval_ == rhs.interval_;
+  };
+};
+
+/// Convert integer samples to complex floats
+class NativeToComplex {
+public:
+  static constexpr const char* kName = "NativeToComplex";
+  static constexpr bool kMergeable = true;
+
+  friend auto operator==(const NativeToComplex&, const NativeToComplex&) -> bool { return true; };
+};
+
+/// Shift the samples by offset, low pass filter and decimate them
+class ChannelFilter {
+public:
+  static constexpr const char* kName = "ChannelFilter";
+  static constexpr bool kMergeable = true;
+
+  /// the frequency that is shifted to baseband
+  int offset_ = 0;
+  /// the integer decimation of the filter
+  unsigned int decimation_ = 1;
+  /// the cutoff frequency and the transition width of the low pass
+  double cutoff_ = 0;
+  double transition_width_ = 0;
+  /// the implementation of the filter
+  FilterImplementation implementation_ = FilterImplementation::kUnselected;
+
+  friend auto operator==(const ChannelFilter& lhs, const ChannelFilter& rhs) -> bool {
+    return lhs.offset_ == rhs.offset_ && lhs.decimation_ == rhs.decimation_ && lhs.cutoff_ == rhs.cutoff_ &&
+           lhs.transition_width_ == rhs.transition_width_ && lhs.implementation_ == rhs.implementation_;
+  };
+};
+
+/// Shift the carrier a slot of a Scan dwells on to baseband, low pass filter and decimate it to the TETRA sample rate
+class ScanFilter {
+public:
+  static constexpr const char* kName = "ScanFilter";
+  static constexpr bool kMergeable = false;
+
+  /// the scan the slot belongs to
+  config::Scan scan_;
+  /// the index of the scan in the graph, the slots of a scan share its scheduler
+  std::size_t scan_id_ = 0;
+  /// the slot of the scan
+  std::size_t slot_ = 0;
+  /// the cutoff frequency and the transition width of the low pass
+  double cutoff_ = 0;
+  double transition_width_ = 0;
+};
+
+/// Resample the samples by an arbitrary rate
+class Resampler {
+public:
+  static constexpr const char* kName = "Resampler";
+  static constexpr bool kMergeable = true;
+
+  double rate_ = 1.0;
+
+  friend auto operator==(const Resampler& lhs, const Resampler& rhs) -> bool { return lhs.rate_ == rhs.rate_; };
+};
+
+/// Recover the differentially decoded symbols of a TETRA stream
+class Demodulator {
+public:
+  static constexpr const char* kName = "Demodulator";
+  static constexpr bool kMergeable = true;
+
+  /// the number of samples per symbol the symbols are recovered at, with more than one an equalizer is added
+  unsigned int samples_per_symbol_ = 1;
+  /// true if the demodulator may run in a lane of a BatchDemodulator together with others of the same input
+  bool batched_ = false;
+
+  friend auto operator==(const Demodulator& lhs, const Demodulator& rhs) -> bool {
+    return lhs.samples_per_symbol_ == rhs.samples_per_symbol_ && lhs.batched_ == rhs.batched_;
+  };
+};
+
+/// Recover the differentially decoded symbols of several TETRA streams in the SIMD lanes of one block. Each input is
+/// one stream and the output with the same index carries its symbols.
+class BatchDemodulator {
+public:
+  static constexpr const char* kName = "BatchDemodulator";
+  static constexpr bool kMergeable = false;
+
+  /// the number of streams
+  unsigned int lanes_ = 0;
+};
+
+/// Detect, acquire and demodulate the bursts of an uplink carrier into frames of their soft bits
+class BurstDemodulator {
+public:
+  static constexpr const char* kName = "BurstDemodulator";
+  static constexpr bool kMergeable = true;
+
+  friend auto operator==(const BurstDemodulator&, const BurstDemodulator&) -> bool { return true; };
+};
+
+/// Decide the bits of the symbols
+class BitDecoder {
+public:
+  static constexpr const char* kName = "BitDecoder";
+  static constexpr bool kMergeable = true;
+
+  friend auto operator==(const BitDecoder&, const BitDecoder&) -> bool { return true; };
+};
+
+/// Pack the int8 soft decisions of the bits of the symbols into udp_frame frames
+class SoftBitFramer {
+public:
+  static constexpr const char* kName = "SoftBitFramer";
+  static constexpr bool kMergeable = true;
+
+  friend auto operator==(const SoftBitFramer&, const SoftBitFramer&) -> bool { return true; };
+};
+
+/// Pack the samples into udp_frame frames
+class IqFramer {
+public:
+  static constexpr const char* kName = "IqFramer";
+  static constexpr bool kMergeable = true;
+
+  friend auto operator==(const IqFramer&, const IqFramer&) -> bool { return true; };
+};
+
+/// Send the items via UDP
+class UdpSink {
+public:
+  static constexpr const char* kName = "UdpSink";
+  static constexpr bool kMergeable = false;
+
+  std::string host_;
+  uint16_t port_ = 0;
+};
+
+/// Export the power of the samples to prometheus
+class PowerProbe {
+public:
+  static constexpr const char* kName = "PowerProbe";
+  static constexpr bool kMergeable = false;
+};
+
+/// Export the latency since the timestamp tagger to prometheus
+class LatencyProbe {
+public:
+  static constexpr const char* kName = "LatencyProbe";
+  static constexpr bool kMergeable = false;
+};
+
+/// Export the error vector magnitude, the modulation error ratio and the signal to noise ratio of the symbols to
+/// prometheus
+class QualityProbe {
+public:
+  static constexpr const char* kName = "QualityProbe";
+  static constexpr bool kMergeable = false;
+};
+
+/// Report the carriers of a Scan whose symbols show a TETRA signal to its scheduler, which extends their dwell
+class ScanProbe {
+public:
+  static constexpr const char* kName = "ScanProbe";
+  static constexpr bool kMergeable = false;
+
+  /// the index of the scan in the graph
+  std::size_t scan_id_ = 0;
+};
+
+/// Record the samples to disk when triggered
+class Recorder {
+public:
+  static constexpr const char* kName = "Recorder";
+  static constexpr bool kMergeable = false;
+
+  config::Recorder recorder_;
+};
+
+/// Discard the items, so the input has at least one output connected
+class NullSink {
+public:
+  static constexpr const char* kName = "NullSink";
+  static constexpr bool kMergeable = false;
+};
+
+using NodeData =
+    std::variant<Source, RingBuffer, TimestampTagger, NativeToComplex, ChannelFilter, ScanFilter, Resampler,
+                 Demodulator, BatchDemodulator, BurstDemodulator, BitDecoder, SoftBitFramer, IqFramer, UdpSink,
+                 PowerProbe, LatencyProbe, QualityProbe, ScanProbe, Recorder, NullSink>;
+
+class Node {
+public:
+  /// the name of the config table this node was created from
+  std::string name_;
+  /// the kind and the parameters of this node
+  NodeData data_;
+  /// the ports this node consumes, one per input
+  std::vector<Port> inputs_;
+  /// the center frequency and the sample rate at the outputs
+  unsigned int center_frequency_ = 0;
+  double sample_rate_ = 0;
+  /// the size of the items at the outputs
+  std::size_t item_size_ = 0;
+  /// the format of the samples at the outputs, if the outputs carry samples
+  std::optional<config::SampleFormat> sample_format_;
+  /// true if this node was removed by a pass and is dropped on the next compaction
+  bool removed_ = false;
+  /// the partition whose thread runs the blocks of this node, if the graph was partitioned for the thread pool
+  std::optional<std::size_t> partition_;
+
+  Node() = delete;
+
+  /// Create a node that produces samples
+  Node(std::string name, NodeData data, std::vector<Port> inputs, unsigned int center_frequency, double sample_rate,
+       config::SampleFormat sample_format);
+
+  /// Create a node that produces other items than samples or that does not produce any items
+  Node(std::string name, NodeData data, std::vector<Port> inputs, unsigned int center_frequency, double sample_rate,
+       std::size_t item_size);
+};
+
+class Graph {
+public:
+  /// The nodes of the graph in topological order. The inputs of a node always come before it, except for a pass that
+  /// adds a node after some of its consumers, which is sorted into place by the next compaction.
+  std::vector<Node> nodes_;
+
+  /// Add a node to the graph. Its inputs have to be in the graph already.
+  /// \return the id of the added node
+  auto add(Node node) -> NodeId;
+
+  /// The ids of the nodes that consume any output of the given node
+  [[nodiscard]] auto consumers(NodeId id) const -> std::vector<NodeId>;
+
+  /// The ids of the nodes that consume the given port
+  [[nodiscard]] auto consumers(const Port& port) const -> std::vector<NodeId>;
+
+  /// Drop the removed nodes and renumber the remaining ones in topological order. Nodes that are already in order keep
+  /// their relative order.
+  auto compact() -> void;
+};
+
+/// Build the graph as described by the config.
+auto from_config(const config::TopLevel& top) -> Graph;
+
+/// Merge nodes with the same parameters and the same inputs. Streams that only differ in the UDP sink share one
+/// demodulator which fans out to several sinks.
+auto merge_identical_subchains(Graph& graph) -> void;
+
+/// Remove the null sinks of ports that are consumed by other nodes
+auto drop_unused_null_sinks(Graph& graph) -> void;
+
+/// Choose the implementation of the filters that were not selected yet. Filters of complex floats with a decimation
+/// of at least multistage::kMinimumDecimation that can be split into a cheaper cascade use the multistage decimator.
+auto select_filter_implementations(Graph& graph) -> void;
+
+/// The smallest number of demodulators that are combined into a BatchDemodulator
+[[maybe_unused]] static constexpr std::size_t kMinimumBatchLanes = 2;
+
+/// Replace the batched demodulators of streams whose channel filters consume the same port with one BatchDemodulator.
+/// The consumers of each demodulator are moved to its output of the batch, so the batch comes after some of them until
+/// the next compaction.
+auto batch_demodulators(Graph& graph) -> void;
+
+/// Run all optimization passes
+auto optimize(Graph& graph) -> void;
+
+/// Assign the nodes of a compacted graph to partitions that each run in one thread. The source, the ring buffer after
+/// it and every filter with at least twice the TETRA sample rate, i.e. the filter of each Decimate block, get a
+/// partition of their own together with the nodes other than filters that only consume their partition. The ring
+/// buffer is a bridge itself: its writing side runs in the partition of its input and only its reading side in its
+/// own partition. The remaining chains of the streams
+/// and of the slots of the scans are grouped by their shared nodes and distributed over the worker partitions by their
+/// estimated cost, the most expensive group first to the least loaded worker.
+/// \param graph the graph whose nodes are assigned
+/// \param threads the number of threads the partitions should fit in, the chains always get at least one worker
+/// \return the number of partitions
+auto partition(Graph& graph, unsigned int threads) -> std::size_t;
+
+/// The payload size of the datagrams of a UdpSink. Each udp_frame frame is sent in a datagram of its own, other items
+/// are packed into datagrams of at most udp_frame::kMaxFrameSize bytes.
+/// \param graph the graph of the sink
+/// \param sink the UdpSink node
+/// \return the number of bytes in each datagram, a multiple of the item size of the input of the sink
+auto datagram_size(const Graph& graph, const Node& sink) -> std::size_t;
+
+/// A human readable description of the graph for dry runs
+auto to_string(const Graph& graph) -> std::string;
+
+} // namespace graph
+
+#endif // GRAPH_H
@@ -0,0 +1,37 @@
+#ifndef HUGE_PAGE_BUFFER_H
+#define HUGE_PAGE_BUFFER_H
+
+#include <cstddef>
+
+/// A preallocated, page aligned memory region. If requested it is backed by huge pages, which avoids TLB misses when
+/// large buffers are accessed in a streaming fashion. If no huge pages are available it falls back to normal pages.
+class HugePageBuffer {
+private:
+  /// the start of the memory region
+  void* data_ = nullptr;
+  /// the size of the mapped memory region in bytes
+  std::size_t size_ = 0;
+  /// true if the memory region is backed by huge pages
+  bool huge_pages_ = false;
+
+public:
+  /// The size of a huge page on x86_64 and aarch64
+  static constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+  HugePageBuffer() = delete;
+
+  /// Map a memory region of at least size bytes. Throws std::bad_alloc if no memory could be mapped.
+  /// \param size the minimal size of the memory region in bytes
+  /// \param huge_pages try to back the memory region with huge pages
+  HugePageBuffer(std::size_t size, bool huge_pages);
+  ~HugePageBuffer() noexcept;
+
+  HugePageBuffer(const HugePageBuffer&) = delete;
+  auto operator=(const HugePageBuffer&) -> HugePageBuffer& = delete;
+
+  [[nodiscard]] auto data() const noexcept -> void* { return data_; };
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; };
+  [[nodiscard]] auto huge_pages() const noexcept -> bool { return huge_pages_; };
+};
+
+#endif // HUGE_PAGE_BUFFER_H
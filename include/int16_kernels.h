@@ -0,0 +1,66 @@
+#ifndef INT16_KERNELS_H
+#define INT16_KERNELS_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// SIMD kernels for filtering interleaved int16 IQ samples with complex taps. Each product is accumulated in int32, the
+/// taps have to be scaled so that the sum can not overflow.
+namespace int16_kernels {
+
+/// The number of int16 values the kernels process at once. The length of the taps has to be a multiple of it.
+constexpr std::size_t kBlockLength = 16;
+
+/// Computes the complex dot product of interleaved int16 IQ samples with complex taps.
+/// \param samples the interleaved IQ samples
+/// \param taps_re the taps for the real part of the product, interleaved as (re, -im)
+/// \param taps_im the taps for the imaginary part of the product, interleaved as (im, re)
+/// \param length the number of int16 values in the samples and taps, a multiple of kBlockLength
+/// \param re the real part of the dot product
+/// \param im the imaginary part of the dot product
+using ComplexDotProduct = void (*)(const int16_t* samples, const int16_t* taps_re, const int16_t* taps_im,
+                                   std::size_t length, int32_t* re, int32_t* im);
+
+auto complex_dot_product_generic(const int16_t* samples, const int16_t* taps_re, const int16_t* taps_im,
+                                 std::size_t length, int32_t* re, int32_t* im) -> void;
+#if defined(__x86_64__) || defined(__i386__)
+auto complex_dot_product_sse2(const int16_t* samples, const int16_t* taps_re, const int16_t* taps_im,
+                              std::size_t length, int32_t* re, int32_t* im) -> void;
+auto complex_dot_product_avx2(const int16_t* samples, const int16_t* taps_re, const int16_t* taps_im,
+                              std::size_t length, int32_t* re, int32_t* im) -> void;
+#endif
+
+/// Select the fastest kernel the CPU supports
+auto best_complex_dot_product() -> ComplexDotProduct;
+
+class QuantizedTaps {
+public:
+  /// the taps for the real part of the product, interleaved as (re, -im) and zero padded to kBlockLength
+  std::vector<int16_t> re_;
+  /// the taps for the imaginary part of the product, interleaved as (im, re) and zero padded to kBlockLength
+  std::vector<int16_t> im_;
+  /// the factor the float taps were multiplied by
+  float scale_ = 0;
+
+  QuantizedTaps() = delete;
+
+  /// Quantize complex float taps to int16, so that the dot product with samples with a magnitude of up to
+  /// max_sample neither overflows the int16 taps nor the int32 accumulators.
+  /// \param taps the complex float taps
+  /// \param max_sample the maximal magnitude of the real or imaginary part of the samples
+  QuantizedTaps(const std::vector<std::complex<float>>& taps, float max_sample);
+
+  /// the number of int16 values in the quantized taps
+  [[nodiscard]] auto length() const noexcept -> std::size_t { return re_.size(); };
+};
+
+/// Widen interleaved signed 8-bit samples to int16
+auto widen_cs8(const int8_t* in, int16_t* out, std::size_t length) -> void;
+/// Widen interleaved offset binary unsigned 8-bit samples, as produced by the RTL-SDR, to signed int16
+auto widen_cu8(const uint8_t* in, int16_t* out, std::size_t length) -> void;
+
+} // namespace int16_kernels
+
+#endif // INT16_KERNELS_H
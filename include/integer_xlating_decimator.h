@@ -0,0 +1,65 @@
+#ifndef INTEGER_XLATING_DECIMATOR_H
+#define INTEGER_XLATING_DECIMATOR_H
+
+#include <vector>
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_decimator.h>
+
+#include "int16_kernels.h"
+#include "sample_format.h"
+
+namespace gr::tetra {
+
+/// This block is the integer counterpart of the freq_xlating_fir_filter_ccf. It takes interleaved integer IQ samples in
+/// the native format of an SDR, shifts them by the center frequency and filters and decimates them with int16 SIMD
+/// kernels. The samples are only converted to complex floats at the decimated rate, which saves memory bandwidth and
+/// per-sample cost at the sample rate of the SDR.
+class IntegerXlatingDecimator : virtual public sync_decimator {
+private:
+  /// the format of the input samples
+  const config::SampleFormat format_;
+  /// the band pass taps shifted to the center frequency, reversed and quantized to int16
+  const int16_kernels::QuantizedTaps taps_;
+  /// the number of complex taps
+  const unsigned int ntaps_;
+  /// the SIMD kernel selected for this CPU
+  const int16_kernels::ComplexDotProduct dot_product_;
+  /// the factor that converts the integer products to floats with full scale at one
+  const float output_scale_;
+  /// the rotation of the decimated samples back to baseband
+  gr_complex phase_ = 1;
+  const gr_complex phase_increment_;
+  /// the input samples widened to int16, or for cs16 the samples of the last outputs, zero padded for the taps
+  std::vector<int16_t> samples_;
+
+  /// Filter and decimate the samples into outputs. The samples have to be readable up to the padded length of the
+  /// taps after the first sample of the last output.
+  /// \param samples the interleaved int16 IQ samples of the first output
+  /// \param noutput_items the number of outputs
+  /// \param out the outputs
+  auto filter(const int16_t* samples, int noutput_items, gr_complex* out) -> void;
+
+public:
+  using sptr = boost::shared_ptr<IntegerXlatingDecimator>;
+
+  IntegerXlatingDecimator() = delete;
+
+  /// \param format the format of the input samples
+  /// \param decimation the decimation of the block
+  /// \param taps the real low pass taps
+  /// \param center_frequency the frequency that is shifted to baseband
+  /// \param sample_rate the sample rate of the input
+  IntegerXlatingDecimator(config::SampleFormat format, unsigned int decimation, const std::vector<float>& taps,
+                          double center_frequency, double sample_rate);
+
+  static auto make(config::SampleFormat format, unsigned int decimation, const std::vector<float>& taps,
+                   double center_frequency, double sample_rate) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // INTEGER_XLATING_DECIMATOR_H
@@ -0,0 +1,56 @@
+#ifndef IQ_DEFRAMER_H
+#define IQ_DEFRAMER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_block.h>
+
+#include "udp_frame.h"
+
+namespace gr::tetra {
+
+/// This block receives the frames of an IqFramer of another process on a UDP port and outputs their samples, as if
+/// they came from a local Decimate block. The samples of lost frames are replaced by zeros, so the timing of the
+/// stream is kept, and the first of them is tagged with rx_drop and the number of replaced samples. Frames with
+/// another sample rate or center frequency than configured are dropped with an error.
+class IqDeframer : virtual public sync_block {
+private:
+  /// the socket bound to the port
+  int socket_ = -1;
+  /// check the frames and find the lost ones
+  udp_frame::Deframer deframer_;
+  /// the last received datagram
+  std::vector<uint8_t> datagram_;
+  /// the samples of the last frame that were not output yet
+  std::vector<gr_complex> samples_;
+  std::size_t samples_read_ = 0;
+  /// the number of zeros that replace lost frames and were not output yet
+  std::size_t zeros_ = 0;
+
+  /// wait for the next frame and keep its samples
+  /// \param position the absolute position of the next output sample, where lost samples are tagged
+  /// \return false if no frame arrived before the timeout
+  auto receive(uint64_t position) -> bool;
+
+public:
+  using sptr = boost::shared_ptr<IqDeframer>;
+
+  IqDeframer() = delete;
+
+  /// \param port the UDP port the frames are received on
+  /// \param sample_rate the expected sample rate of the frames
+  /// \param center_frequency the expected center frequency of the frames
+  IqDeframer(uint16_t port, unsigned int sample_rate, unsigned int center_frequency);
+  ~IqDeframer() override;
+
+  static auto make(uint16_t port, unsigned int sample_rate, unsigned int center_frequency) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // IQ_DEFRAMER_H
@@ -0,0 +1,35 @@
+#ifndef IQ_FRAMER_H
+#define IQ_FRAMER_H
+
+#include <gnuradio/sync_decimator.h>
+
+#include "udp_frame.h"
+
+namespace gr::tetra {
+
+/// This block packs complex float samples into udp_frame frames with the sample rate and the center frequency of the
+/// samples. Each output item is one complete frame of udp_frame::kComplexFloat32PerFrame samples, which is sent as
+/// one UDP datagram and unpacked again by the IqDeframer of another process.
+class IqFramer : virtual public sync_decimator {
+private:
+  /// the header of the next frame
+  udp_frame::Header header_;
+
+public:
+  using sptr = boost::shared_ptr<IqFramer>;
+
+  IqFramer() = delete;
+
+  /// \param sample_rate the sample rate of the input
+  /// \param center_frequency the center frequency of the input in Hz
+  IqFramer(unsigned int sample_rate, unsigned int center_frequency);
+
+  static auto make(unsigned int sample_rate, unsigned int center_frequency) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // IQ_FRAMER_H
@@ -0,0 +1,116 @@
+#ifndef IQ_RING_RECORDER_H
+#define IQ_RING_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_block.h>
+#include <prometheus/counter.h>
+
+#include "huge_page_buffer.h"
+
+namespace gr::tetra {
+
+/// This block continuously writes its input into a fixed-size ring buffer in memory that covers the last seconds of
+/// samples. When it is triggered by SIGUSR1 or by the power threshold, a dedicated writer thread flushes the ring
+/// buffer and the following seconds of samples to disk. The samples are written as raw interleaved 32-bit floats
+/// (cf32). The block never waits on the writer thread, so recording never back-pressures the flowgraph. If the writer
+/// falls behind by more than the slack of the ring buffer, also while it writes a chunk, the recording is truncated
+/// to the samples before the overwritten ones and the rest of it counts as dropped.
+class IqRingRecorder : virtual public sync_block {
+private:
+  /// the name of the recorded stream, used as a prefix of the file names
+  const std::string name_;
+  /// the sample rate and the center frequency of the recorded samples
+  const unsigned int sample_rate_;
+  const unsigned int center_frequency_;
+  /// the number of samples before and after the trigger that are recorded
+  const uint64_t pre_trigger_samples_;
+  const uint64_t post_trigger_samples_;
+  /// the directory to which the recordings are written
+  const std::string directory_;
+  /// the optional power threshold that triggers a recording
+  const std::optional<float> power_threshold_;
+  /// the optional prometheus counter of the samples of recordings that were lost because the writer fell behind
+  const std::optional<std::reference_wrapper<::prometheus::Counter>> dropped_;
+
+  /// the memory of the ring buffer
+  HugePageBuffer buffer_;
+  /// the ring buffer inside the memory
+  gr_complex* const ring_;
+  /// the number of samples the ring buffer holds
+  const uint64_t capacity_;
+  /// the number of samples that were written into the ring buffer in total
+  std::atomic<uint64_t> written_ = 0;
+  /// the number of SIGUSR1 triggers this block has already handled
+  uint64_t handled_signal_triggers_ = 0;
+  /// the scratch space for the power calculation
+  std::vector<float> magnitudes_;
+
+  /// the synchronization with the writer thread
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::thread writer_;
+  std::atomic<bool> stop_writer_ = false;
+  /// the pending or running recording from (inclusive) to (exclusive) the absolute sample positions
+  std::optional<std::pair<uint64_t, uint64_t>> recording_;
+
+  /// the number of SIGUSR1 signals received by the process
+  static std::atomic<uint64_t> signal_triggers_;
+
+  /// the signal handler counting the SIGUSR1 signals
+  static auto handle_signal(int signal) -> void;
+
+  /// start a recording if none is running
+  auto trigger() -> void;
+
+  /// the loop of the writer thread
+  auto write_recordings() -> void;
+
+  /// Write one recording to disk.
+  /// \param start the absolute sample position of the first sample to write
+  /// \param end the absolute sample position after the last sample to write
+  auto write_recording(uint64_t start, uint64_t end) -> void;
+
+public:
+  using sptr = boost::shared_ptr<IqRingRecorder>;
+
+  IqRingRecorder() = delete;
+
+  /// \param name the name of the recorded stream
+  /// \param sample_rate the sample rate of the recorded samples
+  /// \param center_frequency the center frequency of the recorded samples
+  /// \param pre_trigger_seconds the number of seconds before the trigger that are recorded
+  /// \param post_trigger_seconds the number of seconds after the trigger that are recorded
+  /// \param directory the directory to which the recordings are written
+  /// \param power_threshold the optional power threshold that triggers a recording
+  /// \param huge_pages back the ring buffer with huge pages
+  /// \param dropped the optional prometheus counter of the samples of recordings that were lost
+  IqRingRecorder(const std::string& name, unsigned int sample_rate, unsigned int center_frequency,
+                 unsigned int pre_trigger_seconds, unsigned int post_trigger_seconds, const std::string& directory,
+                 std::optional<float> power_threshold, bool huge_pages,
+                 std::optional<std::reference_wrapper<::prometheus::Counter>> dropped);
+
+  static auto make(const std::string& name, unsigned int sample_rate, unsigned int center_frequency,
+                   unsigned int pre_trigger_seconds, unsigned int post_trigger_seconds, const std::string& directory,
+                   std::optional<float> power_threshold, bool huge_pages,
+                   std::optional<std::reference_wrapper<::prometheus::Counter>> dropped) -> sptr;
+
+  auto start() -> bool override;
+  auto stop() -> bool override;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // IQ_RING_RECORDER_H
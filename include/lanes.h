@@ -0,0 +1,168 @@
+#ifndef LANES_H
+#define LANES_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+/// The demodulation of many continuous TETRA carriers at once. The state of the loops of all carriers is kept as
+/// struct-of-arrays with one element per carrier, so that each step of the demodulator is a loop over the carriers
+/// that the compiler turns into one SIMD lane per carrier. All carriers share the same sample rate, so the resampling
+/// to two samples per symbol and the matched filter have the same timing for every lane. Only the automatic gain
+/// control, the frequency locked loop, the symbol timing recovery and the differential decoding differ per lane.
+namespace lanes {
+
+/// The number of lanes the state is padded to, the number of floats in an AVX-512 register
+constexpr std::size_t kLaneBlock = 16;
+/// The number of samples per symbol after the resampling, at which the symbol timing is recovered
+constexpr unsigned int kSamplesPerSymbol = 2;
+/// The number of input samples the polyphase resampler sums for each output sample
+constexpr unsigned int kTapsPerPhase = 16;
+/// The excess bandwidth of the root raised cosine pulse of TETRA
+constexpr double kRolloff = 0.35;
+/// The number of rows of the ring of samples the symbol timing interpolates from
+constexpr std::size_t kInterpolatorRows = 5;
+/// The number of input samples of each lane that are transposed and processed at once
+constexpr std::size_t kChunkSize = 256;
+
+/// The taps of a root raised cosine filter with unit energy
+/// \param sample_rate the sample rate of the filter
+/// \param symbol_rate the symbol rate of the pulse
+/// \param rolloff the excess bandwidth
+/// \param taps the number of taps
+auto root_raised_cosine(double sample_rate, double symbol_rate, double rolloff, std::size_t taps)
+    -> std::vector<float>;
+
+/// The state of all lanes. Every vector of per lane values holds lanes_ elements, the vectors of rows hold lanes_
+/// elements for each row.
+class State {
+public:
+  /// the number of lanes padded to kLaneBlock
+  std::size_t lanes_ = 0;
+  /// the number of lanes that are used, the others are padding whose symbols are dropped
+  std::size_t active_lanes_ = 0;
+
+  /// the interpolation and decimation factors of the polyphase resampler to kSamplesPerSymbol
+  unsigned int interpolation_ = 0;
+  unsigned int decimation_ = 0;
+  /// the taps of the resampler, the matched filter, as kTapsPerPhase taps for each of the interpolation_ phases
+  std::vector<float> taps_;
+  /// the phase of the next output sample of the resampler
+  unsigned int phase_ = 0;
+  /// the derotated input samples as ring of kTapsPerPhase rows, which is written twice so that the newest
+  /// kTapsPerPhase rows are always contiguous
+  std::vector<float> history_re_;
+  std::vector<float> history_im_;
+  /// the row of the newest input sample in the ring
+  std::size_t history_position_ = 0;
+
+  /// the phasor that derotates the frequency offset
+  std::vector<float> rotation_re_;
+  std::vector<float> rotation_im_;
+  /// the frequency offset in radians per input sample
+  std::vector<float> frequency_;
+  /// the gain of the automatic gain control
+  std::vector<float> gain_;
+
+  /// the last kInterpolatorRows matched filtered and gain controlled samples as ring of rows
+  std::vector<float> samples_re_;
+  std::vector<float> samples_im_;
+  /// the row of the newest sample in the ring
+  std::size_t samples_position_ = 0;
+
+  /// the counter of the symbol timing, a symbol is strobed when it underflows
+  std::vector<float> counter_;
+  /// the decrement of the counter per sample, nominally 1 / kSamplesPerSymbol
+  std::vector<float> step_;
+  /// the integrator of the loop filter of the symbol timing
+  std::vector<float> integrator_;
+  /// the previous symbol
+  std::vector<float> previous_re_;
+  std::vector<float> previous_im_;
+
+  /// one for the lanes that strobed a symbol in the last sample, zero otherwise
+  std::vector<float> strobe_;
+  /// the differentially decoded symbols of the last strobe
+  std::vector<float> symbol_re_;
+  std::vector<float> symbol_im_;
+  /// the sum of the resampler of the last output sample
+  std::vector<float> sum_re_;
+  std::vector<float> sum_im_;
+
+  /// the input samples of a chunk transposed to rows of lanes
+  std::vector<float> input_re_;
+  std::vector<float> input_im_;
+
+  State() = delete;
+
+  /// \param lanes the number of lanes
+  /// \param input_sample_rate the sample rate of every lane
+  /// \param symbol_rate the symbol rate of every lane
+  State(std::size_t lanes, unsigned int input_sample_rate, unsigned int symbol_rate);
+};
+
+/// Demodulates count transposed input samples of each lane in state.input_re_ and state.input_im_.
+/// \param state the state of all lanes
+/// \param count the number of input samples of each lane, at most kChunkSize
+/// \param outputs the differentially decoded symbols of each lane, the first produced[lane] are already used
+/// \param produced the number of symbols written to each lane, incremented for each new symbol
+using Kernel = void (*)(State& state, std::size_t count, std::complex<float>* const* outputs, std::size_t* produced);
+
+auto process_generic(State& state, std::size_t count, std::complex<float>* const* outputs, std::size_t* produced)
+    -> void;
+#if defined(__x86_64__) || defined(__i386__)
+auto process_avx2(State& state, std::size_t count, std::complex<float>* const* outputs, std::size_t* produced)
+    -> void;
+auto process_avx512(State& state, std::size_t count, std::complex<float>* const* outputs, std::size_t* produced)
+    -> void;
+#endif
+
+/// Select the fastest kernel the CPU supports
+auto best_kernel() -> Kernel;
+
+/// Demodulates a fixed number of carriers with the same sample rate into differentially decoded π/4-DQPSK symbols
+class Demodulator {
+private:
+  /// the number of lanes that are used
+  const std::size_t lanes_;
+  /// the sample rate of the lanes
+  const unsigned int input_sample_rate_;
+  /// the kernel that processes the chunks
+  const Kernel kernel_;
+  /// the state of all lanes
+  State state_;
+
+public:
+  Demodulator() = delete;
+
+  /// \param lanes the number of carriers
+  /// \param input_sample_rate the sample rate of the carriers
+  /// \param symbol_rate the symbol rate of the carriers
+  /// \param kernel the kernel that processes the chunks
+  Demodulator(std::size_t lanes, unsigned int input_sample_rate, unsigned int symbol_rate,
+              Kernel kernel = best_kernel());
+
+  /// Demodulate the same number of samples of every lane
+  /// \param inputs the samples of each lane
+  /// \param count the number of samples of each lane
+  /// \param outputs the symbols of each lane, with room for max_symbols(count) symbols each
+  /// \param produced the number of symbols written to each lane
+  auto process(const std::complex<float>* const* inputs, std::size_t count, std::complex<float>* const* outputs,
+               std::size_t* produced) -> void;
+
+  /// the largest number of symbols a lane may produce for count input samples
+  [[nodiscard]] auto max_symbols(std::size_t count) const noexcept -> std::size_t;
+
+  /// the largest number of input samples for which no lane produces more than the number of symbols
+  [[nodiscard]] auto max_samples(std::size_t symbols) const noexcept -> std::size_t;
+
+  /// the frequency offset the loop of a lane has locked to in Hz
+  [[nodiscard]] auto frequency_offset(std::size_t lane) const -> double;
+
+  /// the number of lanes
+  [[nodiscard]] auto lanes() const noexcept -> std::size_t { return lanes_; };
+};
+
+} // namespace lanes
+
+#endif // LANES_H
@@ -0,0 +1,54 @@
+#ifndef MULTISTAGE_H
+#define MULTISTAGE_H
+
+#include <vector>
+
+/// Plan the cascade of low pass filters of a multistage decimator. A decimation by a large factor at a high sample rate
+/// needs a long filter, because its transition width is small compared to the sample rate. Split into a cascade, the
+/// first stages only have to keep the aliases out of the final passband and can use a wide transition band, and only
+/// the last stage, which runs at a low rate, needs the narrow transition width.
+namespace multistage {
+
+/// The smallest decimation for which a multistage decimator is considered
+[[maybe_unused]] static constexpr unsigned int kMinimumDecimation = 8;
+/// The maximum number of stages of a plan
+[[maybe_unused]] static constexpr unsigned int kMaximumStages = 4;
+/// The stopband attenuation in dB of the Hamming window that firdes::low_pass designs the taps with
+[[maybe_unused]] static constexpr double kWindowAttenuation = 53;
+/// The factor by which the transition width of the stages before the last is narrowed. The number of taps firdes
+/// estimates for a transition width results in a transition band about 1.4 times as wide, which would otherwise let
+/// the droop of the early stages into the passband and the aliases into the final band.
+[[maybe_unused]] static constexpr double kTransitionMargin = 1.6;
+
+/// A low pass filter that decimates its input
+class Stage {
+public:
+  /// the decimation of the stage
+  unsigned int decimation_ = 1;
+  /// the sample rate of the input of the stage
+  double input_sample_rate_ = 0;
+  /// the cutoff frequency and the transition width of the low pass
+  double cutoff_ = 0;
+  double transition_width_ = 0;
+};
+
+/// The number of taps firdes::low_pass designs for the transition width with the Hamming window
+auto estimated_taps(double sample_rate, double transition_width) -> unsigned int;
+
+/// The number of taps multiplied per input sample of the stages
+auto cost(const std::vector<Stage>& stages) -> double;
+
+/// The stages of the cheapest cascade that decimates by the given factor and passes the same band as a single low pass
+/// with the cutoff and the transition width. The last stage is this low pass at the reduced rate, the stages before it
+/// pass its passband and attenuate everything that would alias into its transition band by the stopband attenuation
+/// of the window. A plan of a single stage is returned if no cascade is cheaper, for example for a prime decimation.
+/// \param input_sample_rate the sample rate of the input
+/// \param decimation the total decimation
+/// \param cutoff the cutoff frequency of the low pass
+/// \param transition_width the transition width of the low pass
+auto plan(double input_sample_rate, unsigned int decimation, double cutoff, double transition_width)
+    -> std::vector<Stage>;
+
+} // namespace multistage
+
+#endif // MULTISTAGE_H
@@ -0,0 +1,70 @@
+#ifndef MULTISTAGE_DECIMATOR_H
+#define MULTISTAGE_DECIMATOR_H
+
+#include <vector>
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_decimator.h>
+
+namespace gr::tetra {
+
+/// This block is a drop-in replacement of the freq_xlating_fir_filter_ccf for large decimations. It shifts the samples
+/// by the center frequency with the VOLK rotator and then filters and decimates them with a cascade of short low pass
+/// filters, as planned by multistage::plan. Only the first stage runs at the input rate, and its taps are few because
+/// its transition band is wide.
+class MultistageDecimator : virtual public sync_decimator {
+public:
+  /// A low pass filter of the cascade
+  class FilterStage {
+  public:
+    /// the decimation of the stage
+    unsigned int decimation_ = 1;
+    /// the real low pass taps
+    std::vector<float> taps_;
+  };
+
+private:
+  /// A stage with its taps in the order of the dot product and the samples it has not consumed yet
+  class State {
+  public:
+    unsigned int decimation_ = 1;
+    std::vector<float> reversed_taps_;
+    /// the last samples of the previous call followed by the samples of the current one
+    std::vector<gr_complex> samples_;
+  };
+
+  /// the stages of the cascade
+  std::vector<State> stages_;
+  /// the sample rate of the input
+  const double sample_rate_;
+  /// the rotation of the input samples to baseband
+  gr_complex phase_ = 1;
+  gr_complex phase_increment_;
+
+public:
+  using sptr = boost::shared_ptr<MultistageDecimator>;
+
+  MultistageDecimator() = delete;
+
+  /// \param stages the low pass filters of the cascade in the order they are applied
+  /// \param center_frequency the frequency that is shifted to baseband
+  /// \param sample_rate the sample rate of the input
+  MultistageDecimator(const std::vector<FilterStage>& stages, double center_frequency, double sample_rate);
+
+  static auto make(const std::vector<FilterStage>& stages, double center_frequency, double sample_rate) -> sptr;
+
+  /// The product of the decimations of the stages
+  static auto total_decimation(const std::vector<FilterStage>& stages) -> unsigned int;
+
+  /// Shift another frequency to baseband from the next input sample on. The samples of the previous frequency in the
+  /// history of the filters still reach the output for the length of the filters.
+  /// \param center_frequency the frequency that is shifted to baseband
+  auto set_center_frequency(double center_frequency) -> void;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // MULTISTAGE_DECIMATOR_H
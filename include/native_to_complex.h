@@ -0,0 +1,37 @@
+#ifndef NATIVE_TO_COMPLEX_H
+#define NATIVE_TO_COMPLEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include <gnuradio/sync_block.h>
+
+#include "sample_format.h"
+
+namespace gr::tetra {
+
+/// This block converts interleaved integer IQ samples in the native format of an SDR to complex floats, scaled so that
+/// full scale is one like the samples of the osmosdr source.
+class NativeToComplex : virtual public sync_block {
+private:
+  /// the format of the input samples
+  const config::SampleFormat format_;
+  /// the scratch space for the conversion of offset binary to signed samples
+  std::vector<int8_t> signed_samples_;
+
+public:
+  using sptr = boost::shared_ptr<NativeToComplex>;
+
+  NativeToComplex() = delete;
+
+  explicit NativeToComplex(config::SampleFormat format);
+
+  static auto make(config::SampleFormat format) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // NATIVE_TO_COMPLEX_H
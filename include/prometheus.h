@@ -5,8 +5,13 @@
 
 #include <prometheus/counter.h>
 #include <prometheus/exposer.h>
+#include <prometheus/histogram.h>
 #include <prometheus/registry.h>
 
+/// The bucket boundaries in seconds of the end-to-end latency histogram
+const prometheus::Histogram::BucketBoundaries kLatencyBucketBoundaries = {0.001, 0.002, 0.005, 0.01, 0.02, 0.05,
+                                                                          0.1,   0.2,   0.5,   1.0,  2.0,  5.0};
+
 class PrometheusExporter {
 private:
   std::shared_ptr<prometheus::Registry> registry_;
@@ -17,6 +22,20 @@ public:
   ~PrometheusExporter() noexcept = default;
 
   auto signal_strength() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto latency() noexcept -> prometheus::Family<prometheus::Histogram>&;
+  auto frequency_offset() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto timing_error() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto error_vector_magnitude() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto modulation_error_ratio() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto signal_to_noise_ratio() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto ring_buffer_fill() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto ring_buffer_high_water() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto ring_buffer_dropped() noexcept -> prometheus::Family<prometheus::Counter>&;
+  auto scheduler_threads() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto bridge_backlog() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto bridge_backlog_high_water() noexcept -> prometheus::Family<prometheus::Gauge>&;
+  auto bridge_dropped() noexcept -> prometheus::Family<prometheus::Counter>&;
+  auto recorder_dropped() noexcept -> prometheus::Family<prometheus::Counter>&;
 };
 
 #endif // PROMETHEUS_H
@@ -0,0 +1,57 @@
+#ifndef PROMETHEUS_GAUGE_REDUCER_H
+#define PROMETHEUS_GAUGE_REDUCER_H
+
+#include <cstdint>
+
+#include <gnuradio/sync_block.h>
+
+#include <prometheus/gauge.h>
+
+namespace gr::prometheus {
+
+/// This block takes a float as an input and writes the mean or the root mean square of every interval items, scaled
+/// by a factor, into a prometheus gauge. It reduces the high rate outputs of the loops of the demodulator to a few
+/// values per second.
+class PrometheusGaugeReducer : virtual public sync_block {
+public:
+  /// How the items of an interval are reduced
+  enum class Reduction {
+    kMean,
+    kRootMeanSquare,
+  };
+
+private:
+  /// the prometheus gauge we are populating with this block
+  ::prometheus::Gauge& gauge_;
+  /// how the items are reduced
+  const Reduction reduction_;
+  /// the factor the reduced value is scaled with
+  const double scale_;
+  /// the number of items that are reduced to one value
+  const uint64_t interval_;
+
+  /// the sum of the items or of their squares of the current interval
+  double sum_ = 0;
+  /// the number of items in the current interval
+  uint64_t count_ = 0;
+
+public:
+  using sptr = boost::shared_ptr<PrometheusGaugeReducer>;
+
+  PrometheusGaugeReducer() = delete;
+
+  /// \param gauge the prometheus gauge we are populating
+  /// \param reduction how the items are reduced
+  /// \param scale the factor the reduced value is scaled with
+  /// \param interval the number of items that are reduced to one value
+  PrometheusGaugeReducer(::prometheus::Gauge& gauge, Reduction reduction, double scale, uint64_t interval);
+
+  static auto make(::prometheus::Gauge& gauge, Reduction reduction, double scale, uint64_t interval) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::prometheus
+
+#endif // PROMETHEUS_GAUGE_REDUCER_H
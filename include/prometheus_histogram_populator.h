@@ -0,0 +1,35 @@
+#ifndef PROMETHEUS_HISTOGRAM_POPULATOR_H
+#define PROMETHEUS_HISTOGRAM_POPULATOR_H
+
+#include <cstddef>
+
+#include <gnuradio/sync_block.h>
+
+#include <prometheus/histogram.h>
+
+namespace gr::prometheus {
+
+/// This block takes items of any size as an input and observes the difference between the current host time and the
+/// time of the rx_time tags on the input in a prometheus histogram. It measures the latency between the block that
+/// added the tags and this block.
+class PrometheusHistogramPopulator : virtual public sync_block {
+private:
+  /// the prometheus histogram we are populating with this block
+  ::prometheus::Histogram& histogram_;
+
+public:
+  using sptr = boost::shared_ptr<PrometheusHistogramPopulator>;
+
+  PrometheusHistogramPopulator() = delete;
+
+  PrometheusHistogramPopulator(::prometheus::Histogram& histogram, std::size_t item_size);
+
+  static auto make(::prometheus::Histogram& histogram, std::size_t item_size) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::prometheus
+
+#endif // PROMETHEUS_HISTOGRAM_POPULATOR_H
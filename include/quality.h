@@ -0,0 +1,49 @@
+#ifndef QUALITY_H
+#define QUALITY_H
+
+#include <complex>
+#include <cstddef>
+
+/// Measures of how well a TETRA stream is demodulated, computed from the differentially decoded π/4-DQPSK symbols.
+namespace quality {
+
+/// Accumulates the error vectors of differentially decoded symbols to the nearest ideal symbol. The ideal symbols are
+/// the four phase changes ±π/4 and ±3π/4 with the amplitude that fits the symbols best, so the measures do not depend
+/// on the gain of the chain.
+class ConstellationError {
+private:
+  /// the number of symbols
+  std::size_t count_ = 0;
+  /// the sum of the power of the symbols
+  double symbol_power_ = 0;
+  /// the sum of the projections of the symbols onto the direction of their ideal symbol
+  double projection_ = 0;
+
+  /// the power of the ideal symbols and of the error vectors of all symbols at the best fitting amplitude
+  [[nodiscard]] auto ideal_power() const noexcept -> double;
+  [[nodiscard]] auto error_power() const noexcept -> double;
+
+public:
+  /// Add a differentially decoded symbol
+  auto add(std::complex<float> symbol) noexcept -> void;
+
+  /// Forget all symbols
+  auto reset() noexcept -> void;
+
+  /// the number of symbols that were added since the last reset
+  [[nodiscard]] auto count() const noexcept -> std::size_t { return count_; };
+
+  /// the root mean square error vector magnitude in percent of the ideal symbols
+  [[nodiscard]] auto error_vector_magnitude() const noexcept -> double;
+
+  /// the modulation error ratio in dB, the power of the ideal symbols to the power of the error vectors
+  [[nodiscard]] auto modulation_error_ratio() const noexcept -> double;
+
+  /// the estimated signal to noise ratio of the symbols before the differential decoding in dB. The product of two
+  /// noisy symbols has about twice their noise power, so it is 3 dB above the modulation error ratio.
+  [[nodiscard]] auto signal_to_noise_ratio() const noexcept -> double;
+};
+
+} // namespace quality
+
+#endif // QUALITY_H
@@ -0,0 +1,53 @@
+#ifndef QUALITY_PROBE_H
+#define QUALITY_PROBE_H
+
+#include <cstdint>
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_block.h>
+#include <prometheus/gauge.h>
+
+#include "quality.h"
+
+namespace gr::tetra {
+
+/// The prometheus metrics of the constellation of a stream
+class QualityMetrics {
+public:
+  /// the root mean square error vector magnitude in percent
+  ::prometheus::Gauge& error_vector_magnitude_;
+  /// the modulation error ratio in dB
+  ::prometheus::Gauge& modulation_error_ratio_;
+  /// the estimated signal to noise ratio in dB
+  ::prometheus::Gauge& signal_to_noise_ratio_;
+};
+
+/// This block takes the differentially decoded symbols of a stream and writes the error vector magnitude, the
+/// modulation error ratio and the estimated signal to noise ratio of every interval symbols into prometheus gauges.
+class QualityProbe : virtual public sync_block {
+private:
+  /// the gauges we are populating with this block
+  QualityMetrics metrics_;
+  /// the number of symbols of each value of the gauges
+  const uint64_t interval_;
+  /// the error of the symbols of the current interval
+  quality::ConstellationError error_;
+
+public:
+  using sptr = boost::shared_ptr<QualityProbe>;
+
+  QualityProbe() = delete;
+
+  /// \param metrics the gauges we are populating
+  /// \param interval the number of symbols of each value of the gauges
+  QualityProbe(QualityMetrics metrics, uint64_t interval);
+
+  static auto make(QualityMetrics metrics, uint64_t interval) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // QUALITY_PROBE_H
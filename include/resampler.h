@@ -0,0 +1,27 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <vector>
+
+/// The anti-aliasing filter of the polyphase arbitrary resampler that follows a Decimate block whose sample rate does
+/// not divide its input sample rate. The resampler runs a prototype low pass at the number of filters times its input
+/// rate. Its passband has to reach the edge of the band that is accepted for the streams, and everything that aliases
+/// into this band has to be in its stopband.
+namespace resampler {
+
+/// The stopband attenuation in dB the taps are designed for
+[[maybe_unused]] static constexpr double kAttenuation = 100;
+
+/// The taps of the prototype low pass, designed like firdes::low_pass_2 with the Blackman-Harris window and a gain of
+/// filters. The passband ends at passband / 2 of the output sample rate. Frequencies above (1 - passband / 2) of the
+/// output sample rate alias into the passband and are attenuated by the stopband. The transition width is narrowed by
+/// multistage::kTransitionMargin, as the window spreads the transition band over more than the width it is designed
+/// for.
+/// \param filters the number of filters of the resampler
+/// \param rate the ratio of the output and the input sample rate, below one
+/// \param passband the fraction of the output bandwidth that is passed
+auto taps(unsigned int filters, double rate, double passband) -> std::vector<float>;
+
+} // namespace resampler
+
+#endif // RESAMPLER_H
@@ -0,0 +1,47 @@
+#ifndef RING_BUFFER_SINK_H
+#define RING_BUFFER_SINK_H
+
+#include <cstdint>
+#include <memory>
+
+#include <gnuradio/sync_block.h>
+
+#include "sample_ring.h"
+#include "tag_queue.h"
+
+namespace gr::tetra {
+
+/// This block writes its input into a ring that is read by a RingBufferSource in another thread. It never
+/// back-pressures its upstream blocks: samples that do not fit into the ring are dropped and recorded as a gap, which
+/// the RingBufferSource tags. The tags of the written samples are passed on to the RingBufferSource, the tags of the
+/// dropped samples are dropped with them.
+class RingBufferSink : virtual public sync_block {
+private:
+  /// the ring shared with the RingBufferSource
+  const std::shared_ptr<SampleRing> ring_;
+  /// the tags shared with the RingBufferSource
+  const std::shared_ptr<TagQueue> tags_;
+  /// the number of samples that were written to the ring
+  uint64_t written_ = 0;
+
+public:
+  using sptr = boost::shared_ptr<RingBufferSink>;
+
+  RingBufferSink() = delete;
+
+  /// \param ring the ring shared with the RingBufferSource
+  /// \param tags the tags shared with the RingBufferSource
+  RingBufferSink(std::shared_ptr<SampleRing> ring, std::shared_ptr<TagQueue> tags);
+
+  static auto make(std::shared_ptr<SampleRing> ring, std::shared_ptr<TagQueue> tags) -> sptr;
+
+  /// Signal the RingBufferSource that no more samples will arrive
+  auto stop() -> bool override;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // RING_BUFFER_SINK_H
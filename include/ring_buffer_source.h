@@ -0,0 +1,90 @@
+#ifndef RING_BUFFER_SOURCE_H
+#define RING_BUFFER_SOURCE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <gnuradio/sync_block.h>
+#include <pmt/pmt.h>
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include "sample_ring.h"
+#include "tag_queue.h"
+
+namespace gr::tetra {
+
+/// The key of the tags that mark the first sample after samples were dropped. The value is the number of dropped
+/// samples.
+const pmt::pmt_t kRxDropKey = pmt::mp("rx_drop");
+
+/// The time the RingBufferSource waits for samples before it returns to the scheduler
+constexpr std::chrono::milliseconds kDefaultReadTimeout(100);
+
+/// The prometheus metrics of a ring buffer
+class RingBufferMetrics {
+public:
+  /// the seconds of samples currently in the ring
+  ::prometheus::Gauge& fill_;
+  /// the maximum seconds of samples that were in the ring
+  ::prometheus::Gauge& high_water_;
+  /// the number of samples that were dropped because the ring was full
+  ::prometheus::Counter& dropped_;
+};
+
+/// This block reads the samples that a RingBufferSink wrote into a ring in another thread. It waits for samples with a
+/// timeout if the ring is empty and finishes when the RingBufferSink was stopped and the ring is drained. The first
+/// sample after a gap is tagged with rx_drop and the number of dropped samples. The tags that the RingBufferSink passed
+/// on are added to the samples they belong to, or to the first sample of the call if they arrived late.
+class RingBufferSource : virtual public sync_block {
+private:
+  /// the ring shared with the RingBufferSink
+  const std::shared_ptr<SampleRing> ring_;
+  /// the tags shared with the RingBufferSink
+  const std::shared_ptr<TagQueue> tags_;
+  /// the sample rate of the samples in the ring
+  const double sample_rate_;
+  /// the time to wait for samples before returning to the scheduler
+  const std::chrono::milliseconds read_timeout_;
+  /// the optional prometheus metrics of the ring
+  std::optional<RingBufferMetrics> metrics_;
+  /// the number of dropped samples that were already added to the metrics
+  uint64_t reported_dropped_ = 0;
+  /// the next gap that was read from the ring but not tagged yet
+  std::optional<SampleRing::Gap> gap_;
+
+  /// tag the gaps before the given absolute sample position
+  auto tag_gaps(uint64_t start, uint64_t end) -> void;
+
+  /// add the tags of the RingBufferSink before the given absolute sample position
+  auto forward_tags(uint64_t start, uint64_t end) -> void;
+
+  /// update the prometheus metrics with the state of the ring
+  auto update_metrics() -> void;
+
+public:
+  using sptr = boost::shared_ptr<RingBufferSource>;
+
+  RingBufferSource() = delete;
+
+  /// \param ring the ring shared with the RingBufferSink
+  /// \param tags the tags shared with the RingBufferSink
+  /// \param sample_rate the sample rate of the samples in the ring
+  /// \param metrics the optional prometheus metrics of the ring
+  /// \param read_timeout the time to wait for samples before returning to the scheduler
+  RingBufferSource(std::shared_ptr<SampleRing> ring, std::shared_ptr<TagQueue> tags, double sample_rate,
+                   std::optional<RingBufferMetrics> metrics, std::chrono::milliseconds read_timeout);
+
+  static auto make(std::shared_ptr<SampleRing> ring, std::shared_ptr<TagQueue> tags, double sample_rate,
+                   std::optional<RingBufferMetrics> metrics,
+                   std::chrono::milliseconds read_timeout = kDefaultReadTimeout) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // RING_BUFFER_SOURCE_H
@@ -0,0 +1,73 @@
+#ifndef RING_RECORDING_H
+#define RING_RECORDING_H
+
+#include <cstdint>
+#include <optional>
+
+/// The reading side of a recording of the samples in a ring whose writer never waits for the reader. The writer
+/// overwrites the oldest samples at any time, so the recording is read in chunks and each chunk is checked against the
+/// number of written samples before and after it is read. A chunk whose samples were overwritten while it was read is
+/// never taken as recorded: the recording ends before it and the rest of the recording counts as dropped.
+class RingRecording {
+public:
+  /// A range of samples that is read at once. It starts at a multiple of the chunk size and does not wrap around the
+  /// end of the ring.
+  class Chunk {
+  public:
+    /// the absolute position of the first sample
+    uint64_t position_ = 0;
+    /// the number of samples
+    uint64_t count_ = 0;
+  };
+
+private:
+  /// the number of samples the ring holds, a multiple of the chunk size
+  const uint64_t capacity_;
+  /// the maximum number of samples of a chunk, which is also the maximum number of samples the writer writes at once
+  const uint64_t chunk_size_;
+  /// the absolute positions of the first sample and after the last sample of the recording
+  const uint64_t start_;
+  const uint64_t end_;
+  /// the absolute position of the first sample that was not recorded yet
+  uint64_t position_;
+  /// true if the writer overwrote samples before they were recorded
+  bool lapped_ = false;
+
+  /// True if the sample at the position may already be overwritten, either by the written samples or by the samples
+  /// the writer is writing right now
+  [[nodiscard]] auto overwritten(uint64_t position, uint64_t written) const noexcept -> bool;
+
+public:
+  RingRecording() = delete;
+
+  /// Throws std::invalid_argument if the capacity is not a multiple of the chunk size or the start is not aligned to a
+  /// chunk.
+  /// \param capacity the number of samples the ring holds
+  /// \param chunk_size the maximum number of samples that are read at once and that the writer writes at once
+  /// \param start the absolute position of the first sample of the recording
+  /// \param end the absolute position after the last sample of the recording
+  RingRecording(uint64_t capacity, uint64_t chunk_size, uint64_t start, uint64_t end);
+
+  /// The next chunk to read. The recording ends as lapped if its first sample was overwritten already.
+  /// \param written the number of samples the writer wrote into the ring in total
+  /// \return the next chunk, or nothing if the recording ended or a full chunk is not written yet
+  auto next(uint64_t written) -> std::optional<Chunk>;
+
+  /// Take a chunk that was read as recorded if none of its samples were overwritten while it was read. Otherwise the
+  /// recording ends as lapped before the chunk.
+  /// \param chunk the chunk returned by the last call to next
+  /// \param written the number of samples the writer wrote into the ring in total, loaded after the chunk was read
+  /// \return true if the chunk is recorded
+  auto commit(const Chunk& chunk, uint64_t written) -> bool;
+
+  /// True if all samples were recorded or the recording was lapped
+  [[nodiscard]] auto finished() const noexcept -> bool { return lapped_ || position_ >= end_; };
+  /// True if the writer overwrote samples before they were recorded
+  [[nodiscard]] auto lapped() const noexcept -> bool { return lapped_; };
+  /// The number of samples that were recorded
+  [[nodiscard]] auto recorded() const noexcept -> uint64_t { return position_ - start_; };
+  /// The number of samples of the recording that are lost because the recording was lapped
+  [[nodiscard]] auto dropped() const noexcept -> uint64_t { return lapped_ ? end_ - position_ : 0; };
+};
+
+#endif // RING_RECORDING_H
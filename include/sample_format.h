@@ -0,0 +1,82 @@
+#ifndef SAMPLE_FORMAT_H
+#define SAMPLE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace config {
+
+/// The formats of interleaved IQ samples of an SDR
+enum class SampleFormat {
+  /// 32-bit float, as produced by the osmosdr source
+  kComplexFloat32,
+  /// signed 16-bit integer, as produced by 12-bit ADCs like the Airspy
+  kComplexInt16,
+  /// signed 8-bit integer, as produced by the HackRF
+  kComplexInt8,
+  /// offset binary unsigned 8-bit integer, as produced by the RTL-SDR
+  kComplexUint8,
+};
+
+/// Parse the name of a sample format as used by the common SDR tools
+[[maybe_unused]] static auto sample_format_from_string(const std::string& name) -> SampleFormat {
+  if (name == "cf32")
+    return SampleFormat::kComplexFloat32;
+  if (name == "cs16")
+    return SampleFormat::kComplexInt16;
+  if (name == "cs8")
+    return SampleFormat::kComplexInt8;
+  if (name == "cu8")
+    return SampleFormat::kComplexUint8;
+
+  throw std::invalid_argument("Unknown sample format " + name + ". Use one of cf32, cs16, cs8 or cu8.");
+}
+
+/// The name of a sample format as used by the common SDR tools
+[[maybe_unused]] static auto sample_format_to_string(const SampleFormat format) -> std::string {
+  switch (format) {
+  case SampleFormat::kComplexFloat32:
+    return "cf32";
+  case SampleFormat::kComplexInt16:
+    return "cs16";
+  case SampleFormat::kComplexInt8:
+    return "cs8";
+  case SampleFormat::kComplexUint8:
+    return "cu8";
+  }
+  return "";
+}
+
+/// The size in bytes of one complex sample
+[[maybe_unused]] static constexpr auto sample_format_size(const SampleFormat format) -> std::size_t {
+  switch (format) {
+  case SampleFormat::kComplexFloat32:
+    return 2 * sizeof(float);
+  case SampleFormat::kComplexInt16:
+    return 2 * sizeof(int16_t);
+  case SampleFormat::kComplexInt8:
+  case SampleFormat::kComplexUint8:
+    return 2 * sizeof(int8_t);
+  }
+  return 0;
+}
+
+/// The magnitude of the real or imaginary part of a sample at full scale
+[[maybe_unused]] static constexpr auto sample_format_full_scale(const SampleFormat format) -> float {
+  switch (format) {
+  case SampleFormat::kComplexFloat32:
+    return 1.0f;
+  case SampleFormat::kComplexInt16:
+    return 32768.0f;
+  case SampleFormat::kComplexInt8:
+  case SampleFormat::kComplexUint8:
+    return 128.0f;
+  }
+  return 1.0f;
+}
+
+} // namespace config
+
+#endif // SAMPLE_FORMAT_H
@@ -0,0 +1,105 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#include "spsc_ring.h"
+
+/// A ring of samples that decouples a writer thread, which must never block, from a reader thread. If the ring is
+/// full the writer drops the samples that do not fit and records a gap, so the reader can mark the discontinuity. The
+/// ring keeps track of its high-water mark and the number of dropped samples.
+class SampleRing {
+public:
+  /// A discontinuity in the samples
+  class Gap {
+  public:
+    /// the number of samples that were written to the ring before the gap
+    uint64_t position_ = 0;
+    /// the number of samples that were dropped
+    uint64_t dropped_ = 0;
+  };
+
+  /// The number of gaps the ring can hold before further gaps are merged
+  static constexpr std::size_t kGapCapacity = 1024;
+
+private:
+  /// the size of one sample in bytes
+  const std::size_t item_size_;
+  /// the bytes of the samples
+  SpscRing<uint8_t> samples_;
+  /// the gaps that were not read yet
+  SpscRing<Gap> gaps_;
+
+  /// the number of samples that were written in total, only used by the writer
+  uint64_t written_ = 0;
+  /// the number of dropped samples that are not in the gaps yet, only used by the writer
+  uint64_t pending_dropped_ = 0;
+
+  /// the maximum number of samples that were in the ring
+  std::atomic<std::size_t> high_water_ = 0;
+  /// the number of samples that were dropped in total
+  std::atomic<uint64_t> dropped_ = 0;
+  /// true if the writer will not write any more samples
+  std::atomic<bool> finished_ = false;
+
+  /// wake up the reader when samples arrive
+  std::mutex mutex_;
+  std::condition_variable condition_;
+
+  /// move the pending dropped samples into a gap if there is space for it
+  auto push_pending_gap() noexcept -> void;
+
+public:
+  SampleRing() = delete;
+
+  /// \param item_size the size of one sample in bytes
+  /// \param capacity the number of samples the ring holds
+  /// \param huge_pages back the ring with huge pages
+  SampleRing(std::size_t item_size, std::size_t capacity, bool huge_pages);
+
+  [[nodiscard]] auto item_size() const noexcept -> std::size_t { return item_size_; };
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t { return samples_.capacity() / item_size_; };
+  [[nodiscard]] auto huge_pages() const noexcept -> bool { return samples_.huge_pages(); };
+
+  /// The number of samples that can be read
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return samples_.size() / item_size_; };
+
+  /// The maximum number of samples that were in the ring
+  [[nodiscard]] auto high_water() const noexcept -> std::size_t {
+    return high_water_.load(std::memory_order_relaxed);
+  };
+
+  /// The number of samples that were dropped in total
+  [[nodiscard]] auto dropped() const noexcept -> uint64_t { return dropped_.load(std::memory_order_relaxed); };
+
+  /// Write the samples that fit into the ring and drop the rest. Only called by the writer thread.
+  /// \return the number of samples that were written
+  auto write(const void* samples, std::size_t count) -> std::size_t;
+
+  /// Read up to count samples. Only called by the reader thread.
+  /// \return the number of samples that were read
+  auto read(void* samples, std::size_t count) noexcept -> std::size_t;
+
+  /// The next gap, if the writer recorded one. Only called by the reader thread.
+  auto pop_gap() noexcept -> std::optional<Gap>;
+
+  /// Wait until samples can be read, the writer finished or the timeout passed.
+  /// \return true if samples can be read
+  auto wait(std::chrono::milliseconds timeout) -> bool;
+
+  /// Signal the reader that no more samples will be written
+  auto finish() -> void;
+
+  /// True if the writer finished and all samples were read
+  [[nodiscard]] auto drained() const noexcept -> bool {
+    return finished_.load(std::memory_order_acquire) && samples_.size() == 0;
+  };
+};
+
+#endif // SAMPLE_RING_H
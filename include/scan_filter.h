@@ -0,0 +1,65 @@
+#ifndef SCAN_FILTER_H
+#define SCAN_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <pmt/pmt.h>
+
+#include "multistage_decimator.h"
+#include "scan_scheduler.h"
+
+namespace gr::tetra {
+
+/// The key of the tags that carry the center frequency of the carrier a slot of a scan was tuned to
+const pmt::pmt_t kScanFrequencyKey = pmt::mp("scan_freq");
+
+/// This block is the channel filter of one slot of a scan. It is a MultistageDecimator whose center frequency follows
+/// the carriers the ScanScheduler assigns to the slot. The dwells are counted in output samples, so the filter retunes
+/// at an exact sample, and the first sample of each carrier is tagged with its center frequency.
+class ScanFilter : public MultistageDecimator {
+private:
+  /// the scheduler that assigns the carriers to the slots of the scan
+  const std::shared_ptr<ScanScheduler> scheduler_;
+  /// the slot of this filter
+  const std::size_t slot_;
+  /// the center frequency of the input
+  const unsigned int input_center_frequency_;
+  /// the sample rate of the output
+  const double output_sample_rate_;
+  /// the carrier of the current dwell
+  std::optional<std::size_t> carrier_;
+  /// the number of output samples until the current dwell ends
+  uint64_t remaining_ = 0;
+  /// true if the next output sample is the first one of the carrier and has to be tagged
+  bool retuned_ = false;
+
+  /// Start a dwell and retune the filter if the carrier changes
+  auto start(const ScanScheduler::Dwell& dwell) -> void;
+
+public:
+  using sptr = boost::shared_ptr<ScanFilter>;
+
+  ScanFilter() = delete;
+
+  /// \param stages the low pass filters of the cascade in the order they are applied
+  /// \param scheduler the scheduler that assigns the carriers to the slots
+  /// \param slot the slot of this filter
+  /// \param input_center_frequency the center frequency of the input
+  /// \param sample_rate the sample rate of the input
+  ScanFilter(const std::vector<FilterStage>& stages, std::shared_ptr<ScanScheduler> scheduler, std::size_t slot,
+             unsigned int input_center_frequency, double sample_rate);
+
+  static auto make(const std::vector<FilterStage>& stages, std::shared_ptr<ScanScheduler> scheduler,
+                   std::size_t slot, unsigned int input_center_frequency, double sample_rate) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // SCAN_FILTER_H
@@ -0,0 +1,56 @@
+#ifndef SCAN_PROBE_H
+#define SCAN_PROBE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_block.h>
+#include <gnuradio/tags.h>
+
+#include "quality.h"
+#include "scan_scheduler.h"
+
+namespace gr::tetra {
+
+/// This block takes the differentially decoded symbols of a slot of a scan and reports the carrier they were
+/// demodulated from to the ScanScheduler whenever the modulation error ratio of interval symbols shows a TETRA signal.
+/// The carrier is taken from the kScanFrequencyKey tags of the ScanFilter, and the error restarts at each of them, so
+/// the symbols of two carriers are never mixed.
+class ScanProbe : virtual public sync_block {
+private:
+  /// the scheduler that assigns the carriers to the slots of the scan
+  const std::shared_ptr<ScanScheduler> scheduler_;
+  /// the number of symbols of each decision
+  const uint64_t interval_;
+  /// the smallest modulation error ratio in dB of a carrier that is reported
+  const double threshold_;
+  /// the carrier of the current symbols, unknown until the first tag
+  std::optional<std::size_t> carrier_;
+  /// the error of the symbols of the current interval
+  quality::ConstellationError error_;
+  /// the tags of the current call
+  std::vector<tag_t> tags_;
+
+public:
+  using sptr = boost::shared_ptr<ScanProbe>;
+
+  ScanProbe() = delete;
+
+  /// \param scheduler the scheduler that assigns the carriers to the slots
+  /// \param interval the number of symbols of each decision
+  /// \param threshold the smallest modulation error ratio in dB of a carrier that is reported
+  ScanProbe(std::shared_ptr<ScanScheduler> scheduler, uint64_t interval, double threshold);
+
+  static auto make(std::shared_ptr<ScanScheduler> scheduler, uint64_t interval, double threshold) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // SCAN_PROBE_H
@@ -0,0 +1,74 @@
+#ifndef SCAN_SCHEDULER_H
+#define SCAN_SCHEDULER_H
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/// Shares a fixed number of demodulator slots between a larger list of carriers. Each slot dwells on a carrier for a
+/// fixed time. When the dwell ends, a carrier that was reported active during it keeps the slot for another dwell until
+/// it held it for the maximum dwell, every other carrier goes to the back of the queue and the slot takes the carrier
+/// at its front. A carrier therefore waits at most ceil((carriers - slots) / slots) maximum dwells until it is visited
+/// again. The slots run in different threads, so all methods may be called concurrently.
+class ScanScheduler {
+public:
+  /// The carrier a slot dwells on next
+  class Dwell {
+  public:
+    /// the index of the carrier in the frequencies
+    std::size_t carrier_ = 0;
+    /// the number of seconds the slot dwells on the carrier before it asks for the next dwell
+    double seconds_ = 0;
+  };
+
+private:
+  /// the center frequencies of the carriers
+  const std::vector<unsigned int> frequencies_;
+  /// the time of one dwell and the longest time a carrier holds a slot
+  const double dwell_seconds_;
+  const double max_dwell_seconds_;
+
+  /// the carrier of each slot and the time it held the slot
+  std::vector<std::size_t> carriers_;
+  std::vector<double> held_seconds_;
+  /// the carriers that wait for a slot, in the order they are visited
+  std::deque<std::size_t> queue_;
+  /// true for the carriers that were reported active during their current dwell
+  std::vector<bool> active_;
+
+  mutable std::mutex mutex_;
+
+public:
+  ScanScheduler() = delete;
+
+  /// \param frequencies the center frequencies of the carriers
+  /// \param slots the number of slots, the first slots start on the first carriers
+  /// \param dwell_seconds the time of one dwell
+  /// \param max_dwell_seconds the longest time an active carrier holds a slot
+  ScanScheduler(std::vector<unsigned int> frequencies, std::size_t slots, double dwell_seconds,
+                double max_dwell_seconds);
+
+  /// the number of slots
+  [[nodiscard]] auto slots() const noexcept -> std::size_t { return carriers_.size(); };
+
+  /// the center frequency of a carrier
+  [[nodiscard]] auto frequency(std::size_t carrier) const -> unsigned int { return frequencies_.at(carrier); };
+
+  /// the index of the carrier with the center frequency
+  [[nodiscard]] auto carrier(unsigned int frequency) const -> std::size_t;
+
+  /// The longest time between two visits of a carrier
+  [[nodiscard]] auto max_revisit_seconds() const noexcept -> double;
+
+  /// The first dwell of a slot
+  [[nodiscard]] auto first(std::size_t slot) const -> Dwell;
+
+  /// The dwell of a slot after its current dwell ended
+  auto next(std::size_t slot) -> Dwell;
+
+  /// Report that a carrier carries a signal that can be demodulated, which extends its visit by another dwell
+  auto report(std::size_t carrier) -> void;
+};
+
+#endif // SCAN_SCHEDULER_H
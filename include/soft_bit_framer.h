@@ -0,0 +1,59 @@
+#ifndef SOFT_BIT_FRAMER_H
+#define SOFT_BIT_FRAMER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <gnuradio/digital/constellation.h>
+#include <gnuradio/block.h>
+#include <gnuradio/tags.h>
+
+#include "udp_frame.h"
+
+namespace gr::tetra {
+
+/// This block turns differentially decoded symbols into int8 log-likelihood ratios of their bits and packs them into
+/// udp_frame frames. The soft decisions are looked up in the soft decision table of the constellation, so they carry
+/// the same bits in the same order as the hard decisions of the constellation_decoder_cb, map_bb and unpack_k_bits_bb
+/// chain. Each output item is one frame of udp_frame::kSoftBitsPerFrame soft bits, which is sent as one UDP datagram.
+/// Behind a slot of a scan the frames are split at the kScanFrequencyKey tags, so the frame before a retune ends early
+/// and is padded with zeros, and each frame carries the center frequency of the one carrier its symbols were
+/// demodulated from.
+class SoftBitFramer : virtual public block {
+private:
+  /// the constellation with the generated soft decision table
+  const gr::digital::constellation_sptr constellation_;
+  /// the number of symbols whose soft bits are sent in one frame
+  const unsigned int symbols_per_frame_;
+  /// the header of the next frame
+  udp_frame::Header header_;
+  /// the split of the symbols into frames at the retunes
+  udp_frame::FrameSplitter splitter_;
+  /// the position of the input up to which the tags were read
+  uint64_t tags_read_ = 0;
+  /// the tags of the current call
+  std::vector<tag_t> tags_;
+
+public:
+  using sptr = boost::shared_ptr<SoftBitFramer>;
+
+  SoftBitFramer() = delete;
+
+  /// \param constellation the constellation of the symbols with a generated soft decision table
+  /// \param symbol_rate the symbol rate of the input
+  /// \param center_frequency the center frequency of the stream in Hz
+  SoftBitFramer(gr::digital::constellation_sptr constellation, unsigned int symbol_rate,
+                unsigned int center_frequency);
+
+  static auto make(gr::digital::constellation_sptr constellation, unsigned int symbol_rate,
+                   unsigned int center_frequency) -> sptr;
+
+  auto forecast(int noutput_items, gr_vector_int& ninput_items_required) -> void override;
+
+  auto general_work(int noutput_items, gr_vector_int& ninput_items, gr_vector_const_void_star& input_items,
+                    gr_vector_void_star& output_items) -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // SOFT_BIT_FRAMER_H
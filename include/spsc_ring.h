@@ -0,0 +1,98 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "huge_page_buffer.h"
+
+/// The size of a cache line, the positions of the reader and the writer are kept on separate ones
+[[maybe_unused]] static constexpr std::size_t kCacheLineSize = 64;
+
+/// A lock-free ring buffer between exactly one writer thread and one reader thread. The writer never blocks. If the
+/// ring is full, write returns how many items fit and the caller decides what to do with the rest.
+template <typename T> class SpscRing {
+  static_assert(std::is_trivially_copyable_v<T>, "The items of the ring are copied with memcpy.");
+
+private:
+  /// the memory of the ring
+  HugePageBuffer buffer_;
+  /// the items of the ring inside the memory
+  T* const items_;
+  /// the number of items the ring holds
+  const std::size_t capacity_;
+
+  /// the number of items that were written and read in total
+  alignas(kCacheLineSize) std::atomic<uint64_t> write_position_ = 0;
+  alignas(kCacheLineSize) std::atomic<uint64_t> read_position_ = 0;
+
+public:
+  SpscRing() = delete;
+
+  /// \param capacity the number of items the ring holds
+  /// \param huge_pages back the ring with huge pages
+  SpscRing(std::size_t capacity, bool huge_pages)
+      : buffer_(std::max<std::size_t>(capacity, 1) * sizeof(T), huge_pages)
+      , items_(static_cast<T*>(buffer_.data()))
+      , capacity_(std::max<std::size_t>(capacity, 1)){};
+
+  SpscRing(const SpscRing&) = delete;
+  auto operator=(const SpscRing&) -> SpscRing& = delete;
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t { return capacity_; };
+  [[nodiscard]] auto huge_pages() const noexcept -> bool { return buffer_.huge_pages(); };
+
+  /// The number of items that can be read
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    return write_position_.load(std::memory_order_acquire) - read_position_.load(std::memory_order_acquire);
+  };
+
+  /// The number of items that can be written
+  [[nodiscard]] auto space() const noexcept -> std::size_t { return capacity_ - size(); };
+
+  /// The number of items that were written and read in total
+  [[nodiscard]] auto write_position() const noexcept -> uint64_t {
+    return write_position_.load(std::memory_order_acquire);
+  };
+  [[nodiscard]] auto read_position() const noexcept -> uint64_t {
+    return read_position_.load(std::memory_order_acquire);
+  };
+
+  /// Write as many of the items as fit into the ring. Only called by the writer thread.
+  /// \return the number of items that were written
+  auto write(const T* items, const std::size_t count) noexcept -> std::size_t {
+    const auto write_position = write_position_.load(std::memory_order_relaxed);
+    const auto read_position = read_position_.load(std::memory_order_acquire);
+    const auto written = std::min<std::size_t>(count, capacity_ - (write_position - read_position));
+
+    const auto index = write_position % capacity_;
+    const auto first = std::min(written, capacity_ - index);
+    std::memcpy(items_ + index, items, first * sizeof(T));
+    std::memcpy(items_, items + first, (written - first) * sizeof(T));
+
+    write_position_.store(write_position + written, std::memory_order_release);
+    return written;
+  };
+
+  /// Read as many items as are available up to count. Only called by the reader thread.
+  /// \return the number of items that were read
+  auto read(T* items, const std::size_t count) noexcept -> std::size_t {
+    const auto read_position = read_position_.load(std::memory_order_relaxed);
+    const auto write_position = write_position_.load(std::memory_order_acquire);
+    const auto read = std::min<std::size_t>(count, write_position - read_position);
+
+    const auto index = read_position % capacity_;
+    const auto first = std::min(read, capacity_ - index);
+    std::memcpy(items, items_ + index, first * sizeof(T));
+    std::memcpy(items + first, items_, (read - first) * sizeof(T));
+
+    read_position_.store(read_position + read, std::memory_order_release);
+    return read;
+  };
+};
+
+#endif // SPSC_RING_H
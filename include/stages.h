@@ -0,0 +1,126 @@
+#ifndef STAGES_H
+#define STAGES_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gnuradio/block.h>
+#include <gnuradio/digital/fll_band_edge_cc.h>
+#include <gnuradio/digital/pfb_clock_sync_ccf.h>
+
+#include "graph.h"
+#include "sample_format.h"
+#include "scan_scheduler.h"
+
+/// The gnuradio blocks of each stage of the receiver, configured the same way for the flowgraph and for the
+/// benchmarks.
+namespace stages {
+
+/// The number of filters of the polyphase arbitrary resampler and of the polyphase clock sync
+[[maybe_unused]] static constexpr unsigned int kPolyphaseFilters = 32;
+
+/// A block of a chain and the sample rate at its output
+class Stage {
+public:
+  /// the name of the stage, used by the benchmarks
+  std::string name_;
+  /// the block of the stage
+  gr::block_sptr block_;
+  /// the sample rate at the output of the block
+  double output_sample_rate_ = 0;
+};
+
+/// The number of outputs of the loops of the demodulator, the samples followed by three outputs of their state. The
+/// loops of gnuradio only write their state if all of their outputs are connected, so exporting one of them needs the
+/// others connected to null sinks.
+[[maybe_unused]] static constexpr int kLoopOutputs = 4;
+/// The output of the frequency loop of the demodulator with the frequency it turns the carrier by in radians per sample
+[[maybe_unused]] static constexpr int kFrequencyLoopFrequencyPort = 1;
+/// The output of the timing loop of the demodulator with its timing error
+[[maybe_unused]] static constexpr int kTimingLoopErrorPort = 1;
+static_assert(kFrequencyLoopFrequencyPort < kLoopOutputs && kTimingLoopErrorPort < kLoopOutputs,
+              "The exported state is one of the outputs of the loops.");
+
+/// The stages of the demodulator of a TETRA stream together with its loops, whose state is exported
+class DemodulatorStages {
+public:
+  /// the stages in the order they are connected
+  std::vector<Stage> stages_;
+  /// the loop that tracks the frequency offset of the carrier, one of the stages
+  gr::digital::fll_band_edge_cc::sptr frequency_loop_;
+  /// the loop that recovers the timing of the symbols, one of the stages
+  gr::digital::pfb_clock_sync_ccf::sptr timing_loop_;
+  /// the sample rate the loops run at
+  double loop_sample_rate_ = 0;
+};
+
+/// The real low pass taps of a channel filter
+/// \param input_sample_rate the sample rate of the input of the filter
+/// \param cutoff the cutoff frequency of the low pass
+/// \param transition_width the transition width of the low pass
+auto channel_filter_taps(double input_sample_rate, double cutoff, double transition_width) -> std::vector<float>;
+
+/// Create the frequency translating filter that decimates its input.
+/// \param implementation the implementation of the filter
+/// \param input_format the format of the input samples
+/// \param decimation the decimation of the filter
+/// \param cutoff the cutoff frequency of the low pass
+/// \param transition_width the transition width of the low pass
+/// \param offset the frequency that is shifted to baseband
+/// \param input_sample_rate the sample rate of the input
+auto make_channel_filter(graph::FilterImplementation implementation, config::SampleFormat input_format,
+                         unsigned int decimation, double cutoff, double transition_width, int offset,
+                         double input_sample_rate) -> gr::block_sptr;
+
+/// Create the channel filter of a slot of a scan, which retunes to the carriers the scheduler assigns to the slot.
+/// \param scheduler the scheduler of the scan
+/// \param slot the slot of the filter
+/// \param decimation the decimation of the filter
+/// \param cutoff the cutoff frequency of the low pass
+/// \param transition_width the transition width of the low pass
+/// \param input_center_frequency the center frequency of the input
+/// \param input_sample_rate the sample rate of the input
+auto make_scan_filter(std::shared_ptr<ScanScheduler> scheduler, std::size_t slot, unsigned int decimation,
+                      double cutoff, double transition_width, unsigned int input_center_frequency,
+                      double input_sample_rate) -> gr::block_sptr;
+
+/// Create the polyphase arbitrary resampler
+/// \param rate the ratio of the output and the input sample rate
+auto make_resampler(double rate) -> gr::block_sptr;
+
+/// The stages of the demodulator of a TETRA stream in the order they are connected and its loops. The demodulator
+/// produces differentially decoded iq symbols.
+/// \param samples_per_symbol the number of samples per symbol the symbols are recovered at, with more than one an
+/// equalizer is added
+/// \param input_sample_rate the sample rate of the input of the demodulator
+auto demodulator_stages(unsigned int samples_per_symbol, double input_sample_rate) -> DemodulatorStages;
+
+/// Create the block that demodulates several streams in its SIMD lanes. It has one input and one output per stream.
+/// \param lanes the number of streams
+/// \param input_sample_rate the sample rate of the streams
+auto make_batch_demodulator(unsigned int lanes, double input_sample_rate) -> gr::block_sptr;
+
+/// The stages of the demodulator of the bursts of an uplink in the order they are connected. The samples are
+/// resampled to burst::kSamplesPerSymbol samples per symbol and matched filtered before the bursts are detected and
+/// demodulated into frames of their soft bits.
+/// \param input_sample_rate the sample rate of the input of the demodulator
+/// \param center_frequency the center frequency of the stream, which is sent in each frame
+auto burst_demodulator_stages(double input_sample_rate, unsigned int center_frequency) -> std::vector<Stage>;
+
+/// The stages that decide the bits of the differentially decoded symbols, in the order they are connected.
+auto bit_decoder_stages() -> std::vector<Stage>;
+
+/// Create the block that packs the soft decisions of the bits of the differentially decoded symbols into frames
+/// \param center_frequency the center frequency of the stream, which is sent in each frame
+auto make_soft_bit_framer(unsigned int center_frequency) -> gr::block_sptr;
+
+/// The stages that compute the power of a stream averaged over one second at ten values per second, in the order
+/// they are connected.
+/// \param input_sample_rate the sample rate of the stream
+auto power_meter_stages(double input_sample_rate) -> std::vector<Stage>;
+
+} // namespace stages
+
+#endif // STAGES_H
@@ -0,0 +1,33 @@
+#ifndef TAG_QUEUE_H
+#define TAG_QUEUE_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <gnuradio/tags.h>
+
+namespace gr::tetra {
+
+/// The tags of the samples in a SampleRing, which the RingBufferSink passes to the RingBufferSource in another thread.
+/// The offsets of the tags count the samples that were written to the ring, so they match the output of the
+/// RingBufferSource.
+class TagQueue {
+private:
+  /// the tags in the order of their offsets
+  std::deque<tag_t> tags_;
+  /// the tags are only added and removed once per call of the blocks, so a mutex is cheap enough
+  std::mutex mutex_;
+
+public:
+  /// Add the tags of the samples that were written to the ring. Only called by the writer thread.
+  auto push(const std::vector<tag_t>& tags) -> void;
+
+  /// Remove the tags of the samples before the end offset. Only called by the reader thread.
+  auto pop(uint64_t end) -> std::vector<tag_t>;
+};
+
+} // namespace gr::tetra
+
+#endif // TAG_QUEUE_H
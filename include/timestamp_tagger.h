@@ -0,0 +1,42 @@
+#ifndef TIMESTAMP_TAGGER_H
+#define TIMESTAMP_TAGGER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <gnuradio/sync_block.h>
+#include <pmt/pmt.h>
+
+namespace gr::tetra {
+
+/// The key of the tags that carry the host time at which samples left the source
+const pmt::pmt_t kRxTimeKey = pmt::mp("rx_time");
+
+/// This block passes its input through unchanged and adds an rx_time tag with the current host time to every
+/// interval-th sample. The tags propagate through the stream chains and are used to measure the end-to-end latency.
+/// Tags arriving at the input are not propagated, so the output only carries the host time tags.
+class TimestampTagger : virtual public sync_block {
+private:
+  /// the size of the items in bytes
+  const std::size_t item_size_;
+  /// the number of samples between two tags
+  const uint64_t interval_;
+
+public:
+  using sptr = boost::shared_ptr<TimestampTagger>;
+
+  TimestampTagger() = delete;
+
+  /// \param item_size the size of the items in bytes
+  /// \param interval the number of samples between two tags
+  TimestampTagger(std::size_t item_size, uint64_t interval);
+
+  static auto make(std::size_t item_size, uint64_t interval) -> sptr;
+
+  auto work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+      -> int override;
+};
+
+} // namespace gr::tetra
+
+#endif // TIMESTAMP_TAGGER_H
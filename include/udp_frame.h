@@ -0,0 +1,196 @@
+#ifndef UDP_FRAME_H
+#define UDP_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <utility>
+
+/// The framing of the data that is sent via UDP. Each datagram carries one frame of a header followed by the payload.
+/// All fields of the header are big-endian, the floats of the payload are little-endian.
+///
+/// offset  size  field
+///      0     4  magic "TETR"
+///      4     1  version
+///      5     1  payload type
+///      6     2  reserved, zero
+///      8     4  sequence number, incremented by one per frame of a sender
+///     12     4  sample rate of the items of the payload in items per second
+///     16     4  center frequency of the items in Hz
+///     20     4  number of items in the payload
+///
+/// A sender with a fixed frame size may pad the payload after its items, e.g. a frame that ends early at a retune of a
+/// scan.
+namespace udp_frame {
+
+/// The magic at the start of each frame, "TETR" in ASCII
+[[maybe_unused]] static constexpr uint32_t kMagic = 0x54455452;
+/// The version of the frame format
+[[maybe_unused]] static constexpr uint8_t kVersion = 1;
+/// The size of the header in bytes
+[[maybe_unused]] static constexpr std::size_t kHeaderSize = 24;
+/// The maximum size of a frame, so it fits into one UDP datagram on Ethernet without fragmentation
+[[maybe_unused]] static constexpr std::size_t kMaxFrameSize = 1472;
+
+/// The number of soft bits in a frame, 40 ms of a TETRA stream
+[[maybe_unused]] static constexpr std::size_t kSoftBitsPerFrame = 1440;
+/// The number of complex float samples in a frame, as many as fit into one datagram
+[[maybe_unused]] static constexpr std::size_t kComplexFloat32PerFrame = (kMaxFrameSize - kHeaderSize) / 8;
+/// The size of the header of an uplink burst at the start of the payload
+[[maybe_unused]] static constexpr std::size_t kBurstHeaderSize = 12;
+/// The maximum number of soft bits of an uplink burst, those of a normal uplink burst
+[[maybe_unused]] static constexpr std::size_t kMaxBurstBits = 462;
+/// The maximum number of frames that may be lost in a row. A larger jump of the sequence number is taken as a restart
+/// of the sender.
+[[maybe_unused]] static constexpr uint32_t kMaxLostFrames = 1024;
+/// The maximum number of frames a frame may arrive late. A frame that is further behind is taken as a restart of the
+/// sender.
+[[maybe_unused]] static constexpr uint32_t kMaxLateFrames = 64;
+
+/// The kinds of items in the payload
+enum class PayloadType : uint8_t {
+  /// int8 log-likelihood ratios of the bits, positive values are ones
+  kSoftBits = 1,
+  /// interleaved IQ samples as 32-bit floats
+  kComplexFloat32 = 2,
+  /// a BurstHeader followed by the int8 log-likelihood ratios of the bits of one uplink burst
+  kUplinkBurst = 3,
+};
+
+class Header {
+public:
+  /// the kind of items in the payload
+  PayloadType payload_type_ = PayloadType::kSoftBits;
+  /// the sequence number of the frame
+  uint32_t sequence_ = 0;
+  /// the sample rate of the items in the payload in items per second
+  uint32_t sample_rate_ = 0;
+  /// the center frequency of the items in Hz
+  uint32_t center_frequency_ = 0;
+  /// the number of items in the payload
+  uint32_t item_count_ = 0;
+};
+
+/// Write the header to the first kHeaderSize bytes of the frame
+auto write_header(const Header& header, uint8_t* frame) noexcept -> void;
+
+/// Read the header from the first bytes of the frame. Throws std::invalid_argument if the frame is shorter than the
+/// header or if the magic or the version do not match.
+/// \param frame the frame
+/// \param size the size of the frame in bytes
+auto read_header(const uint8_t* frame, std::size_t size) -> Header;
+
+/// The header at the start of the payload of an uplink burst. All fields are big-endian.
+///
+/// offset  size  field
+///      0     1  kind of burst, 1 and 2 for normal uplink bursts with training sequence 1 and 2, 3 for control uplink
+///      1     1  reserved, zero
+///      2     2  frequency offset of the burst in Hz, signed
+///      4     8  number of the first symbol of the burst, counted from the start of the stream
+class BurstHeader {
+public:
+  /// the kind of burst
+  uint8_t burst_type_ = 0;
+  /// the frequency offset of the burst to the center frequency of the stream in Hz
+  int16_t frequency_offset_ = 0;
+  /// the number of the first symbol of the burst
+  uint64_t symbol_ = 0;
+};
+
+/// Split a stream of items into frames of at most a capacity of items. A frame ends early at a retune of the stream,
+/// so the items of each frame are from one carrier and carry its center frequency.
+class FrameSplitter {
+private:
+  /// the maximum number of items of a frame
+  const std::size_t capacity_;
+  /// the position of the first item of the next frame in the stream
+  uint64_t position_ = 0;
+  /// the center frequency of the items of the next frame
+  uint32_t center_frequency_;
+  /// the positions in the stream of the retunes that were not reached yet, with their center frequencies
+  std::deque<std::pair<uint64_t, uint32_t>> retunes_;
+
+public:
+  FrameSplitter() = delete;
+
+  /// \param capacity the maximum number of items of a frame
+  /// \param center_frequency the center frequency of the stream until its first retune
+  FrameSplitter(std::size_t capacity, uint32_t center_frequency);
+
+  /// Retune the stream. The retunes have to be added in the order of their positions and before the frames that reach
+  /// them are split off. Throws std::invalid_argument if the position is before the next frame or a previous retune.
+  /// \param position the position in the stream of the first item of the new carrier
+  /// \param center_frequency the center frequency of the new carrier
+  auto retune(uint64_t position, uint32_t center_frequency) -> void;
+
+  /// Split off the next frame.
+  /// \param available the number of items of the stream from the start of the next frame on
+  /// \return the number of items of the frame, or nothing if it needs more items than are available
+  auto next(std::size_t available) -> std::optional<std::size_t>;
+
+  /// the position of the first item of the next frame in the stream
+  [[nodiscard]] auto position() const noexcept -> uint64_t { return position_; };
+  /// the center frequency of the items of the frame that was split off last
+  [[nodiscard]] auto center_frequency() const noexcept -> uint32_t { return center_frequency_; };
+};
+
+/// Write the burst header to the first kBurstHeaderSize bytes of the payload
+auto write_burst_header(const BurstHeader& header, uint8_t* payload) noexcept -> void;
+
+/// Read the burst header from the first bytes of the payload. Throws std::invalid_argument if the payload is shorter
+/// than the burst header.
+/// \param payload the payload of the frame
+/// \param size the size of the payload in bytes
+auto read_burst_header(const uint8_t* payload, std::size_t size) -> BurstHeader;
+
+/// The payload of a received frame
+class Frame {
+public:
+  /// the number of items in the frames that were lost between the previous frame and this one
+  std::size_t lost_items_ = 0;
+  /// the items of this frame
+  const uint8_t* payload_ = nullptr;
+  /// the number of items of this frame
+  std::size_t items_ = 0;
+};
+
+/// Check the received frames of one sender against the expected kind of items, and find the frames that were lost or
+/// arrived late from the sequence numbers.
+class Deframer {
+private:
+  /// the expected kind of items
+  const PayloadType payload_type_;
+  /// the size of one item in bytes
+  const std::size_t item_size_;
+  /// the expected sample rate and center frequency of the items
+  const uint32_t sample_rate_;
+  const uint32_t center_frequency_;
+  /// the sequence number of the next frame, unknown until the first frame arrived
+  std::optional<uint32_t> next_sequence_;
+  /// the number of frames that arrived late and were dropped
+  uint64_t late_frames_ = 0;
+
+public:
+  Deframer() = delete;
+
+  /// \param payload_type the expected kind of items
+  /// \param item_size the size of one item in bytes
+  /// \param sample_rate the expected sample rate of the items
+  /// \param center_frequency the expected center frequency of the items
+  Deframer(PayloadType payload_type, std::size_t item_size, uint32_t sample_rate, uint32_t center_frequency);
+
+  /// Read a received frame. Throws std::invalid_argument if the frame is invalid or carries other items than
+  /// expected.
+  /// \param frame the frame
+  /// \param size the size of the frame in bytes
+  /// \return the payload of the frame, or nothing if the frame arrived too late and is dropped
+  auto push(const uint8_t* frame, std::size_t size) -> std::optional<Frame>;
+
+  /// the number of frames that arrived late and were dropped
+  [[nodiscard]] auto late_frames() const noexcept -> uint64_t { return late_frames_; };
+};
+
+} // namespace udp_frame
+
+#endif // UDP_FRAME_H
@@ -75,6 +75,7 @@ stdenv.mkDerivation rec {
 	installPhase = ''
 		mkdir -p $out/bin
     cp ./test/unit_tests $out/bin/test
+    cp ./bench/benchmarks $out/bin/benchmarks
     cp ./tetra-receiver $out/bin/tetra-receiver
 	'';
 }
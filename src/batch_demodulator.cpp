@@ -0,0 +1,58 @@
+#include <algorithm>
+
+#include <gnuradio/io_signature.h>
+
+#include "batch_demodulator.h"
+
+namespace gr::tetra {
+
+BatchDemodulator::sptr BatchDemodulator::make(const unsigned int lanes, const unsigned int input_sample_rate,
+                                              const unsigned int symbol_rate) {
+  return gnuradio::get_initial_sptr(new BatchDemodulator(lanes, input_sample_rate, symbol_rate));
+}
+
+BatchDemodulator::BatchDemodulator(const unsigned int lanes, const unsigned int input_sample_rate,
+                                   const unsigned int symbol_rate)
+    : block(
+          /*name=*/"BatchDemodulator",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/lanes, /*max_streams=*/lanes, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/lanes, /*max_streams=*/lanes, /*sizeof_stream_items=*/sizeof(gr_complex)))
+    , demodulator_(lanes, input_sample_rate, symbol_rate)
+    , inputs_(lanes)
+    , outputs_(lanes)
+    , produced_(lanes) {
+  set_relative_rate(/*interpolation=*/symbol_rate, /*decimation=*/input_sample_rate);
+  // the tags of each stream stay on the output of its lane
+  set_tag_propagation_policy(TPP_ONE_TO_ONE);
+  // at least one input sample fits the outputs
+  set_min_noutput_items(static_cast<int>(demodulator_.max_symbols(1)));
+}
+
+auto BatchDemodulator::forecast(const int noutput_items, gr_vector_int& ninput_items_required) -> void {
+  const auto samples = std::max<std::size_t>(1, demodulator_.max_samples(static_cast<std::size_t>(noutput_items)));
+  std::fill(ninput_items_required.begin(), ninput_items_required.end(), static_cast<int>(samples));
+}
+
+auto BatchDemodulator::general_work(const int noutput_items, gr_vector_int& ninput_items,
+                                    gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+    -> int {
+  // the lanes advance together, so every input is consumed as far as the shortest one and no output can overflow
+  auto count = demodulator_.max_samples(static_cast<std::size_t>(noutput_items));
+  for (std::size_t lane = 0; lane < inputs_.size(); lane++) {
+    count = std::min(count, static_cast<std::size_t>(ninput_items[lane]));
+    inputs_[lane] = (const gr_complex*)input_items[lane];
+    outputs_[lane] = (gr_complex*)output_items[lane];
+  }
+
+  demodulator_.process(inputs_.data(), count, outputs_.data(), produced_.data());
+
+  consume_each(static_cast<int>(count));
+  for (std::size_t lane = 0; lane < produced_.size(); lane++) {
+    produce(static_cast<int>(lane), static_cast<int>(produced_[lane]));
+  }
+  return WORK_CALLED_PRODUCE;
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "burst.h"
+
+namespace burst {
+
+/// The int8 value of a certain one
+static constexpr float kSoftBitScale = 127.0f;
+
+auto training_sequences() -> const std::vector<TrainingSequence>& {
+  static const std::vector<TrainingSequence> kTrainingSequences = {
+      // the normal training sequences 1 and 2 after the 4 tail bits and the 216 bits of the first block
+      {BurstType::kNormalUplink, kNormalBurstBits, /*position=*/220,
+       {1, 1, 0, 1, 0, 0, 0, 0, 1, 1, 1, 0, 1, 0, 0, 1, 1, 1, 0, 1, 0, 0}},
+      {BurstType::kNormalUplinkStolen, kNormalBurstBits, /*position=*/220,
+       {0, 1, 1, 1, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 1, 1, 0, 1, 1, 1, 1, 0}},
+      // the extended training sequence after the 4 tail bits and the 84 bits of the first block
+      {BurstType::kControlUplink, kControlBurstBits, /*position=*/88,
+       {1, 0, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 1, 1, 1, 0, 1, 0, 0, 1, 1, 1, 0, 1, 0, 0, 0, 0, 1, 1}},
+  };
+
+  return kTrainingSequences;
+}
+
+auto phase_change(const uint8_t first_bit, const uint8_t second_bit) noexcept -> float {
+  const auto magnitude = second_bit ? 3 * M_PI / 4 : M_PI / 4;
+  return static_cast<float>(first_bit ? -magnitude : magnitude);
+}
+
+EnergyDetector::EnergyDetector(const unsigned int samples_per_symbol, const float threshold)
+    : power_smoothing_(1.0f / samples_per_symbol)
+    , floor_smoothing_(1.0f / (samples_per_symbol * kSlotSymbols))
+    , threshold_(threshold)
+    , max_burst_samples_(2 * samples_per_symbol * kSlotSymbols) {}
+
+auto EnergyDetector::push(const std::complex<float> sample) noexcept -> bool {
+  if (!noise_floor_) {
+    power_ = std::norm(sample);
+    noise_floor_ = power_;
+    return false;
+  }
+
+  power_ += power_smoothing_ * (std::norm(sample) - power_);
+  auto& noise_floor = *noise_floor_;
+
+  if (power_ <= threshold_ * noise_floor) {
+    noise_floor += floor_smoothing_ * (power_ - noise_floor);
+    samples_above_ = 0;
+    armed_ = true;
+    return false;
+  }
+
+  if (++samples_above_ > max_burst_samples_) {
+    noise_floor = power_;
+    armed_ = false;
+    return false;
+  }
+
+  const auto detected = armed_;
+  armed_ = false;
+  return detected;
+}
+
+BurstEstimator::BurstEstimator(const unsigned int samples_per_symbol, const double symbol_rate,
+                               const float minimum_quality)
+    : samples_per_symbol_(samples_per_symbol)
+    , symbol_rate_(symbol_rate)
+    , minimum_quality_(minimum_quality) {
+  if (samples_per_symbol == 0) {
+    throw std::invalid_argument("The bursts need at least one sample per symbol.");
+  }
+
+  for (const auto& sequence : training_sequences()) {
+    std::vector<std::complex<float>> reference;
+    for (std::size_t bit = 0; bit + 1 < sequence.bits_.size(); bit += 2) {
+      reference.push_back(std::polar(1.0f, -phase_change(sequence.bits_[bit], sequence.bits_[bit + 1])));
+    }
+    references_.push_back(std::move(reference));
+  }
+}
+
+auto BurstEstimator::estimate(const std::complex<float>* samples, const std::size_t count, const std::size_t max_start)
+    -> std::optional<Estimate> {
+  const std::size_t sps = samples_per_symbol_;
+  if (count <= sps) {
+    return std::nullopt;
+  }
+
+  // the phase change of each sample to the sample one symbol before it
+  products_.assign(count, 0);
+  for (std::size_t i = sps; i < count; i++) {
+    products_[i] = samples[i] * std::conj(samples[i - sps]);
+  }
+
+  std::optional<Estimate> best;
+  const auto& sequences = training_sequences();
+  for (std::size_t i = 0; i < sequences.size(); i++) {
+    const auto& sequence = sequences[i];
+    const auto& reference = references_[i];
+    // the distance from the first symbol of the burst to its last and to the first symbol of the training sequence
+    const std::size_t burst_length = (sequence.burst_bits_ / 2 - 1) * sps;
+    const std::size_t training_offset = sequence.position_ / 2 * sps;
+
+    // the first symbol needs the sample one symbol before it, the last one has to be in the window
+    if (count < sps + burst_length + 1) {
+      continue;
+    }
+    const auto last = std::min(max_start, count - 1 - burst_length);
+    if (last < sps) {
+      continue;
+    }
+
+    const auto correlate = [&](const std::size_t start) {
+      std::complex<float> correlation = 0;
+      for (std::size_t symbol = 0; symbol < reference.size(); symbol++) {
+        correlation += products_[start + training_offset + symbol * sps] * reference[symbol];
+      }
+      return correlation;
+    };
+
+    auto peak = sps;
+    auto peak_correlation = correlate(peak);
+    for (auto start = sps + 1; start <= last; start++) {
+      const auto correlation = correlate(start);
+      if (std::norm(correlation) > std::norm(peak_correlation)) {
+        peak = start;
+        peak_correlation = correlation;
+      }
+    }
+
+    // the correlation is at most the square root of the number of symbols times their energy, which it reaches if all
+    // products have the same magnitude and are rotated by the same angle, and is far from it for noise, whose
+    // correlation is dominated by a few large products
+    float energy = 0;
+    for (std::size_t symbol = 0; symbol < reference.size(); symbol++) {
+      energy += std::norm(products_[peak + training_offset + symbol * sps]);
+    }
+    if (energy == 0) {
+      continue;
+    }
+    const auto quality = std::abs(peak_correlation) / std::sqrt(static_cast<float>(reference.size()) * energy);
+    if (quality < minimum_quality_ || (best && quality <= best->quality_)) {
+      continue;
+    }
+
+    // interpolate the timing between the samples with a parabola through the peak and its neighbours
+    double fraction = 0;
+    if (peak > sps && peak < last) {
+      const auto before = std::abs(correlate(peak - 1));
+      const auto after = std::abs(correlate(peak + 1));
+      const auto curvature = before - 2 * std::abs(peak_correlation) + after;
+      if (curvature < 0) {
+        fraction = std::clamp(0.5 * (before - after) / curvature, -0.5, 0.5);
+      }
+    }
+
+    const auto phase_drift = std::arg(peak_correlation);
+    best = Estimate{/*burst_type=*/sequence.burst_type_, /*burst_bits=*/sequence.burst_bits_,
+                    /*start=*/static_cast<double>(peak) + fraction, /*phase_drift=*/phase_drift,
+                    /*frequency_offset=*/phase_drift * symbol_rate_ / (2 * M_PI), /*quality=*/quality};
+  }
+
+  return best;
+}
+
+/// The int8 log-likelihood ratio of a soft decision between -1 and 1
+static auto to_soft_bit(const float soft_decision) noexcept -> int8_t {
+  return static_cast<int8_t>(std::clamp(std::round(soft_decision * kSoftBitScale), -kSoftBitScale, kSoftBitScale));
+}
+
+auto BurstEstimator::demodulate(const std::complex<float>* samples, const std::size_t count, const Estimate& estimate,
+                                int8_t* soft_bits) const noexcept -> void {
+  const double sps = samples_per_symbol_;
+  // undo the phase drift of the frequency offset between the symbols
+  const auto correction = std::polar(1.0f, -estimate.phase_drift_);
+
+  // the sample at a fractional position, linearly interpolated between its neighbours
+  const auto sample_at = [samples, count](const double position, std::complex<float>& sample) {
+    if (position < 0 || position > static_cast<double>(count - 1)) {
+      return false;
+    }
+    const auto index = static_cast<std::size_t>(position);
+    const auto fraction = static_cast<float>(position - static_cast<double>(index));
+    sample = index + 1 < count ? (1 - fraction) * samples[index] + fraction * samples[index + 1] : samples[index];
+    return true;
+  };
+
+  for (unsigned int symbol = 0; symbol < estimate.burst_bits_ / 2; symbol++) {
+    const auto position = estimate.start_ + symbol * sps;
+    std::complex<float> current;
+    std::complex<float> previous;
+    soft_bits[2 * symbol] = 0;
+    soft_bits[2 * symbol + 1] = 0;
+    if (!sample_at(position, current) || !sample_at(position - sps, previous)) {
+      continue;
+    }
+
+    const auto change = current * std::conj(previous) * correction;
+    const auto magnitude = std::abs(change);
+    if (magnitude == 0) {
+      continue;
+    }
+
+    // the first bit is one for a negative, the second bit for a negative real part of the phase change
+    soft_bits[2 * symbol] = to_soft_bit(-change.imag() / magnitude * static_cast<float>(M_SQRT2));
+    soft_bits[2 * symbol + 1] = to_soft_bit(-change.real() / magnitude * static_cast<float>(M_SQRT2));
+  }
+}
+
+} // namespace burst
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+
+#include <gnuradio/io_signature.h>
+
+#include "burst_demodulator.h"
+
+namespace gr::tetra {
+
+/// The size of the frames in bytes
+static constexpr std::size_t kFrameSize =
+    udp_frame::kHeaderSize + udp_frame::kBurstHeaderSize + udp_frame::kMaxBurstBits;
+
+BurstDemodulator::sptr BurstDemodulator::make(const unsigned int symbol_rate, const unsigned int center_frequency) {
+  return gnuradio::get_initial_sptr(new BurstDemodulator(symbol_rate, center_frequency));
+}
+
+BurstDemodulator::BurstDemodulator(const unsigned int symbol_rate, const unsigned int center_frequency)
+    : block(
+          /*name=*/"BurstDemodulator",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/kFrameSize))
+    , guard_samples_(burst::kGuardSymbols * burst::kSamplesPerSymbol)
+    // a normal uplink burst and its reference symbol between the guard symbols
+    , window_samples_((2 * burst::kGuardSymbols + 1 + burst::kNormalBurstBits / 2) * burst::kSamplesPerSymbol)
+    // the first symbol follows the reference symbol at the rise of the energy, which is detected with some delay
+    , max_start_((2 * burst::kGuardSymbols + 1) * burst::kSamplesPerSymbol)
+    , detector_(burst::kSamplesPerSymbol)
+    , estimator_(burst::kSamplesPerSymbol, symbol_rate) {
+  static_assert(kFrameSize <= udp_frame::kMaxFrameSize, "A frame has to fit into one UDP datagram.");
+  static_assert(burst::kNormalBurstBits <= udp_frame::kMaxBurstBits, "The soft bits of a burst have to fit a frame.");
+
+  // at most one burst per half timeslot, so the tags keep their approximate position
+  set_relative_rate(/*interpolation=*/2, /*decimation=*/burst::kSlotSymbols * burst::kSamplesPerSymbol);
+
+  header_.payload_type_ = udp_frame::PayloadType::kUplinkBurst;
+  header_.sample_rate_ = 2 * symbol_rate;
+  header_.center_frequency_ = center_frequency;
+}
+
+auto BurstDemodulator::write_frame(const burst::Estimate& estimate, const std::size_t window, uint8_t* frame) -> void {
+  header_.item_count_ = estimate.burst_bits_;
+  udp_frame::write_header(header_, frame);
+  header_.sequence_++;
+
+  const auto first_sample = static_cast<double>(first_sample_ + window) + estimate.start_;
+  udp_frame::BurstHeader burst_header;
+  burst_header.burst_type_ = static_cast<uint8_t>(estimate.burst_type_);
+  burst_header.frequency_offset_ = static_cast<int16_t>(std::lround(estimate.frequency_offset_));
+  burst_header.symbol_ = static_cast<uint64_t>(std::llround(first_sample / burst::kSamplesPerSymbol));
+  auto* payload = frame + udp_frame::kHeaderSize;
+  udp_frame::write_burst_header(burst_header, payload);
+
+  auto* soft_bits = (int8_t*)(payload + udp_frame::kBurstHeaderSize);
+  estimator_.demodulate(&samples_[window], window_samples_, estimate, soft_bits);
+  std::fill(soft_bits + estimate.burst_bits_, soft_bits + udp_frame::kMaxBurstBits, 0);
+}
+
+auto BurstDemodulator::general_work(const int noutput_items, gr_vector_int& ninput_items,
+                                    gr_vector_const_void_star& input_items, gr_vector_void_star& output_items)
+    -> int {
+  const auto* in = (const gr_complex*)input_items[0];
+  auto* out = (uint8_t*)output_items[0];
+
+  // buffer at most two windows, so the samples do not pile up while the output is full
+  const auto capacity = 2 * window_samples_ - std::min(2 * window_samples_, samples_.size());
+  const auto consumed = std::min(static_cast<std::size_t>(ninput_items[0]), capacity);
+  samples_.insert(samples_.end(), in, in + consumed);
+
+  int produced = 0;
+  while (produced < noutput_items) {
+    // look for the start of the next burst
+    while (!trigger_ && scanned_ < samples_.size()) {
+      if (detector_.push(samples_[scanned_])) {
+        trigger_ = scanned_;
+      }
+      scanned_++;
+    }
+    if (!trigger_) {
+      break;
+    }
+
+    // wait until the window around the burst is complete
+    const auto window = *trigger_ - std::min(*trigger_, guard_samples_);
+    if (window + window_samples_ > samples_.size()) {
+      break;
+    }
+    trigger_.reset();
+
+    if (const auto estimate = estimator_.estimate(&samples_[window], window_samples_, max_start_)) {
+      write_frame(*estimate, window, out + produced * kFrameSize);
+      produced++;
+    }
+  }
+
+  // drop the samples that can no longer be part of a window
+  const auto keep = trigger_ ? *trigger_ : scanned_;
+  const auto drop = keep - std::min(keep, guard_samples_);
+  samples_.erase(samples_.begin(), samples_.begin() + static_cast<std::ptrdiff_t>(drop));
+  first_sample_ += drop;
+  scanned_ -= drop;
+  if (trigger_) {
+    *trigger_ -= drop;
+  }
+
+  consume_each(static_cast<int>(consumed));
+  return produced;
+}
+
+} // namespace gr::tetra
@@ -2,26 +2,90 @@
 
 namespace config {
 
+Recorder::Recorder(const unsigned int pre_trigger_seconds, const unsigned int post_trigger_seconds,
+                   std::string directory, const std::optional<float> power_threshold, const bool huge_pages)
+    : pre_trigger_seconds_(pre_trigger_seconds)
+    , post_trigger_seconds_(post_trigger_seconds)
+    , directory_(std::move(directory))
+    , power_threshold_(power_threshold)
+    , huge_pages_(huge_pages) {
+  if (pre_trigger_seconds + post_trigger_seconds == 0) {
+    throw std::invalid_argument("Recorder would not record any samples.");
+  }
+}
+
+SourceBuffer::SourceBuffer(const double seconds, const bool huge_pages)
+    : seconds_(seconds)
+    , huge_pages_(huge_pages) {
+  if (!(seconds > 0)) {
+    throw std::invalid_argument("SourceBuffer would not hold any samples.");
+  }
+}
+
 Stream::Stream(const std::string& name, const SpectrumSlice<unsigned int>& input_spectrum,
-               const SpectrumSlice<unsigned int>& spectrum, std::string host, uint16_t port, bool send_iq)
+               const SpectrumSlice<unsigned int>& spectrum, std::string host, uint16_t port, bool send_iq,
+               bool send_soft_bits, const StreamMode mode)
     : name_(name)
     , input_spectrum_(input_spectrum)
     , spectrum_(spectrum)
     , host_(std::move(host))
     , port_(port)
-    , send_iq_(send_iq) {
+    , send_iq_(send_iq)
+    , send_soft_bits_(send_soft_bits)
+    , mode_(mode) {
+  if (send_iq && send_soft_bits) {
+    throw std::invalid_argument("A Stream can either send iq data or soft bits.");
+  }
+  if (mode == StreamMode::kUplink && (send_iq || send_soft_bits)) {
+    throw std::invalid_argument("An uplink Stream always sends the soft bits of its bursts.");
+  }
+
   // check that this Stream is valid
   if (!input_spectrum.frequency_range_.contains(spectrum.frequency_range_)) {
     throw std::invalid_argument("Frequency Range of the Streams in not "
                                 "inside the frequency Range of the input.");
   }
 
-  const auto& input_sample_rate = input_spectrum.sample_rate_;
-  const auto& sample_rate = spectrum.sample_rate_;
-  decimation_ = input_sample_rate / sample_rate;
-  auto remainder = input_sample_rate % sample_rate;
-  if (remainder != 0) {
-    throw std::invalid_argument("Input sample rate is not divisible by Stream block sample rate.");
+  // decimate to the next higher integer fraction of the input sample rate, the demodulator resamples the rest
+  decimation_ = input_spectrum.sample_rate_ / spectrum.sample_rate_;
+  if (decimation_ == 0) {
+    throw std::invalid_argument("Input sample rate is smaller than the Stream sample rate.");
+  }
+}
+
+Scan::Scan(const std::string& name, const SpectrumSlice<unsigned int>& input_spectrum,
+           std::vector<unsigned int> frequencies, const std::size_t slots, const double dwell_seconds,
+           const double max_dwell_seconds, std::string host, const uint16_t port)
+    : name_(name)
+    , input_spectrum_(input_spectrum)
+    , frequencies_(std::move(frequencies))
+    , slots_(slots)
+    , dwell_seconds_(dwell_seconds)
+    , max_dwell_seconds_(max_dwell_seconds)
+    , host_(std::move(host))
+    , port_(port) {
+  if (frequencies_.empty()) {
+    throw std::invalid_argument("A Scan needs at least one frequency.");
+  }
+  if (slots == 0 || slots > frequencies_.size()) {
+    throw std::invalid_argument("A Scan needs at least one and at most as many slots as frequencies.");
+  }
+  if (!(dwell_seconds > 0) || max_dwell_seconds < dwell_seconds) {
+    throw std::invalid_argument("The Dwell of a Scan has to be positive and at most its MaxDwell.");
+  }
+
+  for (const auto frequency : frequencies_) {
+    const SpectrumSlice<unsigned int> spectrum(frequency, kTetraSampleRate);
+    if (!input_spectrum.frequency_range_.contains(spectrum.frequency_range_)) {
+      throw std::invalid_argument("Frequency Range of a carrier of the Scan is not inside the frequency Range of the "
+                                  "input.");
+    }
+  }
+
+  // decimate to the next higher integer fraction of the input sample rate, the demodulator resamples the rest
+  decimation_ = input_spectrum.sample_rate_ / kTetraSampleRate;
+  if (decimation_ == 0) {
+    throw std::invalid_argument("Input sample rate is smaller than the Scan sample rate.");
   }
 }
 
@@ -40,8 +104,13 @@ Decimate::Decimate(const std::string& name, const SpectrumSlice<unsigned int>& i
   decimation_ = input_sample_rate / sample_rate;
   auto remainder = input_sample_rate % sample_rate;
 
+  if (decimation_ == 0) {
+    throw std::invalid_argument("Decimate block sample rate is bigger than the input sample rate.");
+  }
+
+  // If the sample rates are not divisible decimate to the next higher sample rate and resample the rest
   if (remainder != 0) {
-    throw std::invalid_argument("Input sample rate is not divisible by Decimate block sample rate.");
+    resampling_rate_ = static_cast<double>(sample_rate) * decimation_ / input_sample_rate;
   }
 
   for (const auto& stream : streams_) {
@@ -51,17 +120,46 @@ Decimate::Decimate(const std::string& name, const SpectrumSlice<unsigned int>& i
   }
 }
 
-TopLevel::TopLevel(const SpectrumSlice<unsigned int>& spectrum, std::string device_string, const unsigned int rf_gain,
-                   const unsigned int if_gain, const unsigned int bb_gain, const std::vector<Stream>& streams,
-                   const std::vector<Decimate>& decimators, std::unique_ptr<Prometheus>&& prometheus)
+auto Decimate::passband() const noexcept -> Range<unsigned int> {
+  if (resampling_rate_ == 1.0) {
+    return spectrum_.frequency_range_;
+  }
+
+  const auto half_passband = static_cast<unsigned int>(spectrum_.sample_rate_ * kResamplerPassband / 2);
+  return Range<unsigned int>(spectrum_.center_frequency_ - half_passband, spectrum_.center_frequency_ + half_passband);
+}
+
+TopLevel::TopLevel(const SpectrumSlice<unsigned int>& spectrum, std::string device_string, std::string input_file,
+                   std::optional<uint16_t> input_port, const SampleFormat sample_format, const unsigned int rf_gain,
+                   const unsigned int if_gain, const unsigned int bb_gain, const bool low_latency,
+                   const bool batch_demodulators, const bool thread_pool, const std::vector<Stream>& streams,
+                   const std::vector<Decimate>& decimators, const std::vector<Scan>& scans,
+                   std::unique_ptr<Prometheus>&& prometheus,
+                   std::optional<Recorder> recorder, std::optional<SourceBuffer> source_buffer)
     : spectrum_(spectrum)
     , device_string_(std::move(device_string))
+    , input_file_(std::move(input_file))
+    , input_port_(input_port)
+    , sample_format_(sample_format)
     , rf_gain_(rf_gain)
     , if_gain_(if_gain)
     , bb_gain_(bb_gain)
+    , low_latency_(low_latency)
+    , batch_demodulators_(batch_demodulators)
+    , thread_pool_(thread_pool)
     , streams_(streams)
     , decimators_(decimators)
-    , prometheus_(std::move(prometheus)) {
+    , scans_(scans)
+    , prometheus_(std::move(prometheus))
+    , recorder_(std::move(recorder))
+    , source_buffer_(source_buffer) {
+  if (!input_file_.empty() && input_port_) {
+    throw std::invalid_argument("Either read the samples from the InputFile or receive them on the InputPort.");
+  }
+  if (sample_format != SampleFormat::kComplexFloat32 && input_file_.empty()) {
+    throw std::invalid_argument("The osmosdr source and the InputPort only produce cf32 samples. Specify an InputFile "
+                                "for other formats.");
+  }
   for (const auto& stream : streams) {
     if (stream.input_spectrum_ != spectrum) {
       throw std::invalid_argument("The output of Decimate does not match to the input of Stream.");
@@ -71,6 +169,22 @@ TopLevel::TopLevel(const SpectrumSlice<unsigned int>& spectrum, std::string devi
     if (decimator.input_spectrum_ != spectrum) {
       throw std::invalid_argument("The output of Decimate does not match to the input of Stream.");
     }
+
+    for (const auto& stream : decimator.streams_) {
+      if (!decimator.passband().contains(stream.spectrum_.frequency_range_)) {
+        throw std::invalid_argument("Frequency Range of the Stream is not inside the passband of the resampling "
+                                    "Decimate block.");
+      }
+    }
+
+    for (const auto& scan : decimator.scans_) {
+      for (const auto frequency : scan.frequencies_) {
+        if (!decimator.passband().contains(SpectrumSlice<unsigned int>(frequency, kTetraSampleRate).frequency_range_)) {
+          throw std::invalid_argument("Frequency Range of a carrier of the Scan is not inside the passband of the "
+                                      "resampling Decimate block.");
+        }
+      }
+    }
   }
 }
 
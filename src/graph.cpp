@@ -0,0 +1,688 @@
+#include "graph.h"
+#include "burst.h"
+#include "multistage.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace graph {
+
+Node::Node(std::string name, NodeData data, std::vector<Port> inputs, const unsigned int center_frequency,
+           const double sample_rate, const config::SampleFormat sample_format)
+    : name_(std::move(name))
+    , data_(std::move(data))
+    , inputs_(std::move(inputs))
+    , center_frequency_(center_frequency)
+    , sample_rate_(sample_rate)
+    , item_size_(config::sample_format_size(sample_format))
+    , sample_format_(sample_format) {}
+
+Node::Node(std::string name, NodeData data, std::vector<Port> inputs, const unsigned int center_frequency,
+           const double sample_rate, const std::size_t item_size)
+    : name_(std::move(name))
+    , data_(std::move(data))
+    , inputs_(std::move(inputs))
+    , center_frequency_(center_frequency)
+    , sample_rate_(sample_rate)
+    , item_size_(item_size) {}
+
+auto Graph::add(Node node) -> NodeId {
+  for (const auto& input : node.inputs_) {
+    if (input.node_ >= nodes_.size()) {
+      throw std::invalid_argument("The input of a node has to be added to the graph before the node.");
+    }
+  }
+
+  nodes_.push_back(std::move(node));
+  return nodes_.size() - 1;
+}
+
+auto Graph::consumers(const NodeId id) const -> std::vector<NodeId> {
+  std::vector<NodeId> ids;
+  for (NodeId i = id + 1; i < nodes_.size(); i++) {
+    const auto& node = nodes_[i];
+    if (node.removed_) {
+      continue;
+    }
+    if (std::any_of(node.inputs_.begin(), node.inputs_.end(), [id](const Port& port) { return port.node_ == id; })) {
+      ids.push_back(i);
+    }
+  }
+  return ids;
+}
+
+auto Graph::consumers(const Port& port) const -> std::vector<NodeId> {
+  std::vector<NodeId> ids;
+  for (NodeId i = port.node_ + 1; i < nodes_.size(); i++) {
+    const auto& node = nodes_[i];
+    if (!node.removed_ && std::find(node.inputs_.begin(), node.inputs_.end(), port) != node.inputs_.end()) {
+      ids.push_back(i);
+    }
+  }
+  return ids;
+}
+
+auto Graph::compact() -> void {
+  // the new id of each node once it is placed
+  std::vector<std::optional<NodeId>> new_ids(nodes_.size());
+  std::vector<Node> nodes;
+  const auto remaining =
+      std::count_if(nodes_.begin(), nodes_.end(), [](const Node& node) { return !node.removed_; });
+
+  // Each scan places the nodes whose inputs are placed. Nodes that are already in topological order are all placed by
+  // the first scan, the others by the scan after their inputs.
+  while (static_cast<std::ptrdiff_t>(nodes.size()) < remaining) {
+    const auto placed = nodes.size();
+
+    for (NodeId i = 0; i < nodes_.size(); i++) {
+      auto& node = nodes_[i];
+      if (node.removed_ || new_ids[i]) {
+        continue;
+      }
+
+      bool ready = true;
+      for (const auto& input : node.inputs_) {
+        if (nodes_[input.node_].removed_) {
+          throw std::invalid_argument("A node consumes the output of a removed node.");
+        }
+        ready = ready && new_ids[input.node_].has_value();
+      }
+      if (!ready) {
+        continue;
+      }
+
+      for (auto& input : node.inputs_) {
+        input.node_ = *new_ids[input.node_];
+      }
+      new_ids[i] = nodes.size();
+      nodes.push_back(std::move(node));
+    }
+
+    if (nodes.size() == placed) {
+      throw std::invalid_argument("The nodes of the graph form a cycle.");
+    }
+  }
+
+  nodes_ = std::move(nodes);
+}
+
+/// Add the chain of a Stream to the graph
+static auto add_stream(Graph& graph, const config::Stream& stream, const Port input, const bool prometheus,
+                       const bool batch) -> void {
+  const auto center_frequency = stream.spectrum_.center_frequency_;
+  const auto sample_rate = stream.spectrum_.sample_rate_;
+  const auto offset =
+      static_cast<int>(center_frequency) - static_cast<int>(stream.input_spectrum_.center_frequency_);
+  const double half_sample_rate = sample_rate / 2;
+  // the filter decimates to the next higher integer fraction of the input sample rate
+  const auto filter_sample_rate = static_cast<double>(stream.input_spectrum_.sample_rate_) / stream.decimation_;
+
+  const auto filter = graph.add(Node(stream.name_,
+                                     ChannelFilter{/*offset=*/offset, /*decimation=*/stream.decimation_,
+                                                   /*cutoff=*/half_sample_rate,
+                                                   /*transition_width=*/half_sample_rate * 0.2},
+                                     {input}, center_frequency, filter_sample_rate,
+                                     config::SampleFormat::kComplexFloat32));
+
+  NodeId output = 0;
+  if (stream.mode_ == config::StreamMode::kUplink) {
+    // the bursts are sent as frames of their soft bits, at most one burst per half timeslot
+    output = graph.add(Node(stream.name_, BurstDemodulator{}, {Port{filter}}, center_frequency,
+                            2.0 * kSymbolRate / burst::kSlotSymbols,
+                            /*item_size=*/udp_frame::kHeaderSize + udp_frame::kBurstHeaderSize +
+                                udp_frame::kMaxBurstBits));
+  } else {
+    // iq symbols are recovered at one sample per symbol, bits at two samples per symbol followed by an equalizer
+    const auto demodulator = graph.add(
+        Node(stream.name_, Demodulator{/*samples_per_symbol=*/stream.send_iq_ ? 1U : 2U, /*batched=*/batch},
+             {Port{filter}}, center_frequency, kSymbolRate, config::SampleFormat::kComplexFloat32));
+
+    if (prometheus) {
+      graph.add(Node(stream.name_, QualityProbe{}, {Port{demodulator}}, center_frequency, 0, /*item_size=*/0));
+    }
+
+    // the stream sends either the symbols, the bits or frames of soft bits
+    output = demodulator;
+    if (stream.send_soft_bits_) {
+      output = graph.add(Node(stream.name_, SoftBitFramer{}, {Port{demodulator}}, center_frequency,
+                              static_cast<double>(kBitRate) / udp_frame::kSoftBitsPerFrame,
+                              /*item_size=*/udp_frame::kHeaderSize + udp_frame::kSoftBitsPerFrame));
+    } else if (!stream.send_iq_) {
+      output = graph.add(Node(stream.name_, BitDecoder{}, {Port{demodulator}}, center_frequency, kBitRate,
+                              /*item_size=*/sizeof(char)));
+    }
+  }
+
+  graph.add(
+      Node(stream.name_, UdpSink{stream.host_, stream.port_}, {Port{output}}, center_frequency, 0, /*item_size=*/0));
+
+  if (prometheus) {
+    graph.add(Node(stream.name_, PowerProbe{}, {Port{filter}}, center_frequency, 0, /*item_size=*/0));
+    graph.add(Node(stream.name_, LatencyProbe{}, {Port{output}}, center_frequency, 0, /*item_size=*/0));
+  }
+}
+
+/// Add the chains of the slots of a Scan to the graph. All slots send to the same host and port, each frame carries
+/// the frequency of the carrier it was demodulated from.
+static auto add_scan(Graph& graph, const config::Scan& scan, Port input) -> void {
+  // the slots of a scan share its scheduler, which is identified by the number of scans before it
+  const auto scan_id =
+      static_cast<std::size_t>(std::count_if(graph.nodes_.begin(), graph.nodes_.end(), [](const Node& node) {
+        const auto* filter = std::get_if<ScanFilter>(&node.data_);
+        return filter != nullptr && filter->slot_ == 0;
+      }));
+
+  // the scan filters retune a rotator on complex floats
+  const auto& input_node = graph.nodes_.at(input.node_);
+  if (input_node.sample_format_ && *input_node.sample_format_ != config::SampleFormat::kComplexFloat32) {
+    const auto center_frequency = input_node.center_frequency_;
+    const auto sample_rate = input_node.sample_rate_;
+    input = Port{graph.add(Node(scan.name_, NativeToComplex{}, {input}, center_frequency, sample_rate,
+                                config::SampleFormat::kComplexFloat32))};
+  }
+
+  const double half_sample_rate = config::kTetraSampleRate / 2.0;
+  const auto filter_sample_rate = static_cast<double>(scan.input_spectrum_.sample_rate_) / scan.decimation_;
+  for (std::size_t slot = 0; slot < scan.slots_; slot++) {
+    // the nodes of a slot start on the carrier of its first dwell
+    const auto center_frequency = scan.frequencies_.at(slot);
+
+    const auto filter = graph.add(Node(scan.name_,
+                                       ScanFilter{/*scan=*/scan, /*scan_id=*/scan_id, /*slot=*/slot,
+                                                  /*cutoff=*/half_sample_rate,
+                                                  /*transition_width=*/half_sample_rate * 0.2},
+                                       {input}, center_frequency, filter_sample_rate,
+                                       config::SampleFormat::kComplexFloat32));
+    const auto demodulator =
+        graph.add(Node(scan.name_, Demodulator{/*samples_per_symbol=*/2, /*batched=*/false}, {Port{filter}},
+                       center_frequency, kSymbolRate, config::SampleFormat::kComplexFloat32));
+    graph.add(Node(scan.name_, ScanProbe{scan_id}, {Port{demodulator}}, center_frequency, 0, /*item_size=*/0));
+    const auto framer = graph.add(Node(scan.name_, SoftBitFramer{}, {Port{demodulator}}, center_frequency,
+                                       static_cast<double>(kBitRate) / udp_frame::kSoftBitsPerFrame,
+                                       /*item_size=*/udp_frame::kHeaderSize + udp_frame::kSoftBitsPerFrame));
+    graph.add(
+        Node(scan.name_, UdpSink{scan.host_, scan.port_}, {Port{framer}}, center_frequency, 0, /*item_size=*/0));
+  }
+}
+
+/// Add the chain of a Decimate block and its Streams to the graph
+static auto add_decimate(Graph& graph, const config::Decimate& decimate, const Port input, const bool prometheus,
+                         const bool batch) -> void {
+  const auto center_frequency = decimate.spectrum_.center_frequency_;
+  const auto input_sample_rate = decimate.input_spectrum_.sample_rate_;
+  const auto offset =
+      static_cast<int>(center_frequency) - static_cast<int>(decimate.input_spectrum_.center_frequency_);
+  const double half_sample_rate = decimate.spectrum_.sample_rate_ / 2;
+
+  auto output = graph.add(Node(decimate.name_,
+                               ChannelFilter{/*offset=*/offset, /*decimation=*/decimate.decimation_,
+                                             /*cutoff=*/half_sample_rate,
+                                             /*transition_width=*/half_sample_rate * 0.2},
+                               {input}, center_frequency, static_cast<double>(input_sample_rate) / decimate.decimation_,
+                               config::SampleFormat::kComplexFloat32));
+
+  // resample the rest if the input sample rate is not divisible by the sample rate of the decimator
+  if (decimate.resampling_rate_ != 1.0) {
+    output = graph.add(Node(decimate.name_, Resampler{decimate.resampling_rate_}, {Port{output}}, center_frequency,
+                            decimate.spectrum_.sample_rate_, config::SampleFormat::kComplexFloat32));
+  }
+
+  for (const auto& stream : decimate.streams_) {
+    add_stream(graph, stream, Port{output}, prometheus, batch);
+  }
+  for (const auto& scan : decimate.scans_) {
+    add_scan(graph, scan, Port{output});
+  }
+
+  if (decimate.recorder_) {
+    graph.add(
+        Node(decimate.name_, Recorder{*decimate.recorder_}, {Port{output}}, center_frequency, 0, /*item_size=*/0));
+  }
+
+  // send the decimated samples to another process, which imports them with its InputPort
+  if (decimate.export_) {
+    const auto framer = graph.add(
+        Node(decimate.name_, IqFramer{}, {Port{output}}, center_frequency,
+             static_cast<double>(decimate.spectrum_.sample_rate_) / udp_frame::kComplexFloat32PerFrame,
+             /*item_size=*/udp_frame::kHeaderSize + udp_frame::kComplexFloat32PerFrame * sizeof(float) * 2));
+    graph.add(Node(decimate.name_, UdpSink{decimate.export_->host_, decimate.export_->port_}, {Port{framer}},
+                   center_frequency, 0, /*item_size=*/0));
+  }
+
+  // add a null sink to have at least one connected
+  graph.add(Node(decimate.name_, NullSink{}, {Port{output}}, center_frequency, 0, /*item_size=*/0));
+}
+
+auto from_config(const config::TopLevel& top) -> Graph {
+  Graph graph;
+
+  const auto center_frequency = top.spectrum_.center_frequency_;
+  const auto sample_rate = top.spectrum_.sample_rate_;
+  const bool prometheus = static_cast<bool>(top.prometheus_);
+
+  const Source source{top.device_string_, top.input_file_, top.input_port_, top.rf_gain_, top.if_gain_, top.bb_gain_};
+  auto input = graph.add(Node("src", source, {}, center_frequency, sample_rate, top.sample_format_));
+
+  // decouple the SDR from the flowgraph, so a stall drops samples in the ring buffer and not in the driver of the SDR
+  if (top.source_buffer_) {
+    const RingBuffer ring_buffer{top.source_buffer_->seconds_, top.source_buffer_->huge_pages_};
+    input = graph.add(Node("src", ring_buffer, {Port{input}}, center_frequency, sample_rate, top.sample_format_));
+  }
+
+  // tag the samples with the host time after the source to measure the latency of each stream
+  if (prometheus) {
+    input = graph.add(Node("src", TimestampTagger{sample_rate / kTimestampTagsPerSecond}, {Port{input}},
+                           center_frequency, sample_rate, top.sample_format_));
+  }
+
+  for (const auto& decimate : top.decimators_) {
+    add_decimate(graph, decimate, Port{input}, prometheus, top.batch_demodulators_);
+  }
+  for (const auto& stream : top.streams_) {
+    add_stream(graph, stream, Port{input}, prometheus, top.batch_demodulators_);
+  }
+  for (const auto& scan : top.scans_) {
+    add_scan(graph, scan, Port{input});
+  }
+
+  if (top.recorder_) {
+    // the recorder always writes complex floats
+    auto recorder_input = input;
+    if (top.sample_format_ != config::SampleFormat::kComplexFloat32) {
+      recorder_input = graph.add(Node("src", NativeToComplex{}, {Port{input}}, center_frequency, sample_rate,
+                                      config::SampleFormat::kComplexFloat32));
+    }
+    graph.add(Node("src", Recorder{*top.recorder_}, {Port{recorder_input}}, center_frequency, 0, /*item_size=*/0));
+  }
+
+  // add a null sink to have at least one connected
+  graph.add(Node("src", NullSink{}, {Port{input}}, center_frequency, 0, /*item_size=*/0));
+
+  return graph;
+}
+
+/// Check if two nodes of the same kind have the same parameters. Nodes that may not be merged are never the same.
+static auto same_data(const NodeData& lhs, const NodeData& rhs) -> bool {
+  if (lhs.index() != rhs.index()) {
+    return false;
+  }
+
+  return std::visit(
+      [&rhs](const auto& data) -> bool {
+        using T = std::decay_t<decltype(data)>;
+        if constexpr (T::kMergeable) {
+          return data == std::get<T>(rhs);
+        } else {
+          return false;
+        }
+      },
+      lhs);
+}
+
+auto merge_identical_subchains(Graph& graph) -> void {
+  auto& nodes = graph.nodes_;
+
+  // The nodes are in topological order, so the inputs of a node are already merged when it is compared. A single pass
+  // therefore merges whole chains.
+  for (NodeId id = 0; id < nodes.size(); id++) {
+    auto& node = nodes[id];
+    if (node.removed_) {
+      continue;
+    }
+
+    for (NodeId other_id = 0; other_id < id; other_id++) {
+      auto& other = nodes[other_id];
+      if (other.removed_ || other.inputs_ != node.inputs_ || !same_data(other.data_, node.data_)) {
+        continue;
+      }
+
+      // redirect the consumers of the node to the identical one
+      for (NodeId consumer_id = id + 1; consumer_id < nodes.size(); consumer_id++) {
+        for (auto& input : nodes[consumer_id].inputs_) {
+          if (input.node_ == id) {
+            input.node_ = other_id;
+          }
+        }
+      }
+      if (other.name_ != node.name_) {
+        other.name_ += "+" + node.name_;
+      }
+      node.removed_ = true;
+      break;
+    }
+  }
+}
+
+auto drop_unused_null_sinks(Graph& graph) -> void {
+  for (NodeId id = 0; id < graph.nodes_.size(); id++) {
+    auto& node = graph.nodes_[id];
+    if (node.removed_ || !std::holds_alternative<NullSink>(node.data_)) {
+      continue;
+    }
+
+    // the null sink is only needed if it is the only consumer of its input
+    if (graph.consumers(node.inputs_.at(0)).size() > 1) {
+      node.removed_ = true;
+    }
+  }
+}
+
+auto select_filter_implementations(Graph& graph) -> void {
+  for (auto& node : graph.nodes_) {
+    auto* filter = std::get_if<ChannelFilter>(&node.data_);
+    if (node.removed_ || filter == nullptr || filter->implementation_ != FilterImplementation::kUnselected) {
+      continue;
+    }
+
+    // integer samples of the SDR are filtered with the int16 kernels and only converted to floats at the decimated rate
+    const auto& input = graph.nodes_.at(node.inputs_.at(0).node_);
+    if (input.sample_format_ && *input.sample_format_ != config::SampleFormat::kComplexFloat32) {
+      filter->implementation_ = FilterImplementation::kIntegerXlatingFir;
+      continue;
+    }
+
+    // large decimations are split into a cascade if it has more than one stage
+    if (filter->decimation_ >= multistage::kMinimumDecimation &&
+        multistage::plan(input.sample_rate_, filter->decimation_, filter->cutoff_, filter->transition_width_).size() >
+            1) {
+      filter->implementation_ = FilterImplementation::kMultistage;
+    } else {
+      filter->implementation_ = FilterImplementation::kFreqXlatingFir;
+    }
+  }
+}
+
+auto batch_demodulators(Graph& graph) -> void {
+  // the batched demodulators of each port that their channel filters consume
+  std::vector<std::pair<Port, std::vector<NodeId>>> groups;
+  for (NodeId id = 0; id < graph.nodes_.size(); id++) {
+    const auto& node = graph.nodes_[id];
+    const auto* demodulator = std::get_if<Demodulator>(&node.data_);
+    if (node.removed_ || demodulator == nullptr || !demodulator->batched_) {
+      continue;
+    }
+
+    // the lanes share the timing of the resampler, so only streams at the TETRA sample rate are batched
+    const auto& filter = graph.nodes_.at(node.inputs_.at(0).node_);
+    if (!std::holds_alternative<ChannelFilter>(filter.data_) || filter.sample_rate_ != config::kTetraSampleRate) {
+      continue;
+    }
+
+    const auto input = filter.inputs_.at(0);
+    auto group =
+        std::find_if(groups.begin(), groups.end(), [&input](const auto& candidate) { return candidate.first == input; });
+    if (group == groups.end()) {
+      groups.emplace_back(input, std::vector<NodeId>{id});
+    } else {
+      group->second.push_back(id);
+    }
+  }
+
+  for (const auto& [input, demodulators] : groups) {
+    if (demodulators.size() < kMinimumBatchLanes) {
+      continue;
+    }
+
+    std::string name;
+    std::vector<Port> inputs;
+    for (const auto id : demodulators) {
+      const auto& node = graph.nodes_[id];
+      name += (name.empty() ? "" : "+") + node.name_;
+      inputs.push_back(node.inputs_.at(0));
+    }
+    const auto center_frequency = graph.nodes_.at(input.node_).center_frequency_;
+    const auto batch = graph.add(Node(name, BatchDemodulator{static_cast<unsigned int>(demodulators.size())}, inputs,
+                                      center_frequency, kSymbolRate, config::SampleFormat::kComplexFloat32));
+
+    // move the consumers of each demodulator to its output of the batch
+    for (unsigned int lane = 0; lane < demodulators.size(); lane++) {
+      for (auto& node : graph.nodes_) {
+        for (auto& port : node.inputs_) {
+          if (port.node_ == demodulators[lane]) {
+            port = Port{batch, lane};
+          }
+        }
+      }
+      graph.nodes_[demodulators[lane]].removed_ = true;
+    }
+  }
+}
+
+auto optimize(Graph& graph) -> void {
+  merge_identical_subchains(graph);
+  drop_unused_null_sinks(graph);
+  select_filter_implementations(graph);
+  batch_demodulators(graph);
+  graph.compact();
+}
+
+/// Check if a node gets a partition of its own: the source and the filters of the Decimate blocks, which process the
+/// most samples, and the ring buffer, whose reading side blocks while it is empty and must not stall the source
+static auto dedicated(const Node& node) -> bool {
+  if (std::holds_alternative<Source>(node.data_) || std::holds_alternative<RingBuffer>(node.data_)) {
+    return true;
+  }
+  // the filter of a Stream decimates to less than twice the TETRA sample rate, a Decimate block below it is cheap
+  return std::holds_alternative<ChannelFilter>(node.data_) && node.sample_rate_ >= 2.0 * config::kTetraSampleRate;
+}
+
+/// The estimated cost of a node, the number of input items it processes per second
+static auto cost(const Graph& graph, const Node& node) -> double {
+  double items = 0;
+  for (const auto& input : node.inputs_) {
+    items += graph.nodes_.at(input.node_).sample_rate_;
+  }
+  return items;
+}
+
+auto partition(Graph& graph, const unsigned int threads) -> std::size_t {
+  auto& nodes = graph.nodes_;
+  std::size_t partitions = 0;
+
+  // the group of shared nodes of each node that is not in a dedicated partition, merged with union-find
+  std::vector<std::optional<std::size_t>> groups(nodes.size());
+  std::vector<std::size_t> parents;
+  const auto root = [&parents](std::size_t group) {
+    while (parents[group] != group) {
+      group = parents[group] = parents[parents[group]];
+    }
+    return group;
+  };
+
+  for (NodeId id = 0; id < nodes.size(); id++) {
+    auto& node = nodes[id];
+    node.partition_.reset();
+    if (node.removed_) {
+      continue;
+    }
+
+    if (dedicated(node)) {
+      node.partition_ = partitions++;
+      continue;
+    }
+
+    // nodes other than filters that only consume one dedicated partition join it
+    const auto& first = nodes.at(node.inputs_.at(0).node_);
+    const bool filter =
+        std::holds_alternative<ChannelFilter>(node.data_) || std::holds_alternative<ScanFilter>(node.data_);
+    const bool joins = !filter && first.partition_ &&
+                       std::all_of(node.inputs_.begin(), node.inputs_.end(), [&nodes, &first](const Port& input) {
+                         return nodes[input.node_].partition_ == first.partition_;
+                       });
+    if (joins) {
+      node.partition_ = first.partition_;
+      continue;
+    }
+
+    // the other nodes are in the same group as their inputs that are not in a dedicated partition
+    for (const auto& input : node.inputs_) {
+      const auto& input_group = groups[input.node_];
+      if (!input_group) {
+        continue;
+      }
+      if (!groups[id]) {
+        groups[id] = root(*input_group);
+      } else {
+        parents[root(*input_group)] = root(*groups[id]);
+      }
+    }
+    if (!groups[id]) {
+      groups[id] = parents.size();
+      parents.push_back(parents.size());
+    }
+  }
+
+  // the cost of each group
+  std::vector<double> costs(parents.size(), 0);
+  for (NodeId id = 0; id < nodes.size(); id++) {
+    if (groups[id]) {
+      costs[root(*groups[id])] += cost(graph, nodes[id]);
+    }
+  }
+
+  // longest processing time first: the most expensive group goes to the least loaded worker
+  std::vector<std::size_t> order;
+  for (std::size_t group = 0; group < parents.size(); group++) {
+    if (root(group) == group) {
+      order.push_back(group);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&costs](const std::size_t lhs, const std::size_t rhs) { return costs[lhs] > costs[rhs]; });
+
+  const std::size_t workers = std::min<std::size_t>(order.size(), threads > partitions ? threads - partitions : 1);
+  std::vector<double> loads(workers, 0);
+  std::vector<std::size_t> workers_of_groups(parents.size());
+  for (const auto group : order) {
+    const auto worker = std::min_element(loads.begin(), loads.end()) - loads.begin();
+    loads[worker] += costs[group];
+    workers_of_groups[group] = partitions + worker;
+  }
+
+  for (NodeId id = 0; id < nodes.size(); id++) {
+    if (groups[id]) {
+      nodes[id].partition_ = workers_of_groups[root(*groups[id])];
+    }
+  }
+
+  return partitions + workers;
+}
+
+auto datagram_size(const Graph& graph, const Node& sink) -> std::size_t {
+  const auto& producer = graph.nodes_.at(sink.inputs_.at(0).node_);
+  if (std::holds_alternative<SoftBitFramer>(producer.data_) || std::holds_alternative<IqFramer>(producer.data_) ||
+      std::holds_alternative<BurstDemodulator>(producer.data_)) {
+    return producer.item_size_;
+  }
+
+  return udp_frame::kMaxFrameSize / producer.item_size_ * producer.item_size_;
+}
+
+/// The parameters of a node for the description of the graph
+class ParameterPrinter {
+public:
+  std::ostream& out_;
+
+  auto operator()(const Source& source) -> void {
+    if (source.input_port_) {
+      out_ << " input_port=" << *source.input_port_;
+    } else if (source.input_file_.empty()) {
+      out_ << " device_string=\"" << source.device_string_ << "\" rf_gain=" << source.rf_gain_
+           << " if_gain=" << source.if_gain_ << " bb_gain=" << source.bb_gain_;
+    } else {
+      out_ << " input_file=\"" << source.input_file_ << "\"";
+    }
+  };
+  auto operator()(const RingBuffer& ring_buffer) -> void {
+    out_ << " seconds=" << ring_buffer.seconds_ << " huge_pages=" << ring_buffer.huge_pages_;
+  };
+  auto operator()(const TimestampTagger& tagger) -> void { out_ << " interval=" << tagger.interval_; };
+  auto operator()(const NativeToComplex&) -> void{};
+  auto operator()(const ChannelFilter& filter) -> void {
+    out_ << " offset=" << filter.offset_ << " decimation=" << filter.decimation_ << " cutoff=" << filter.cutoff_
+         << " transition_width=" << filter.transition_width_ << " implementation=";
+    switch (filter.implementation_) {
+    case FilterImplementation::kUnselected:
+      out_ << "unselected";
+      break;
+    case FilterImplementation::kFreqXlatingFir:
+      out_ << "freq_xlating_fir";
+      break;
+    case FilterImplementation::kIntegerXlatingFir:
+      out_ << "integer_xlating_fir";
+      break;
+    case FilterImplementation::kMultistage:
+      out_ << "multistage";
+      break;
+    }
+  };
+  auto operator()(const ScanFilter& filter) -> void {
+    out_ << " slot=" << filter.slot_ << "/" << filter.scan_.slots_ << " scan=" << filter.scan_id_ << " frequencies=";
+    for (std::size_t i = 0; i < filter.scan_.frequencies_.size(); i++) {
+      out_ << (i == 0 ? "" : ",") << filter.scan_.frequencies_[i];
+    }
+    out_ << " dwell=" << filter.scan_.dwell_seconds_ << " max_dwell=" << filter.scan_.max_dwell_seconds_
+         << " decimation=" << filter.scan_.decimation_ << " cutoff=" << filter.cutoff_
+         << " transition_width=" << filter.transition_width_;
+  };
+  auto operator()(const Resampler& resampler) -> void { out_ << " rate=" << resampler.rate_; };
+  auto operator()(const Demodulator& demodulator) -> void {
+    out_ << " samples_per_symbol=" << demodulator.samples_per_symbol_ << " batched=" << demodulator.batched_;
+  };
+  auto operator()(const BatchDemodulator& demodulator) -> void { out_ << " lanes=" << demodulator.lanes_; };
+  auto operator()(const BurstDemodulator&) -> void{};
+  auto operator()(const BitDecoder&) -> void{};
+  auto operator()(const SoftBitFramer&) -> void{};
+  auto operator()(const IqFramer&) -> void{};
+  auto operator()(const UdpSink& sink) -> void { out_ << " host=" << sink.host_ << " port=" << sink.port_; };
+  auto operator()(const PowerProbe&) -> void{};
+  auto operator()(const LatencyProbe&) -> void{};
+  auto operator()(const QualityProbe&) -> void{};
+  auto operator()(const ScanProbe& probe) -> void { out_ << " scan=" << probe.scan_id_; };
+  auto operator()(const Recorder& recorder) -> void {
+    out_ << " pre_trigger=" << recorder.recorder_.pre_trigger_seconds_
+         << " post_trigger=" << recorder.recorder_.post_trigger_seconds_ << " directory=\""
+         << recorder.recorder_.directory_ << "\"";
+  };
+  auto operator()(const NullSink&) -> void{};
+};
+
+auto to_string(const Graph& graph) -> std::string {
+  std::ostringstream out;
+
+  for (NodeId id = 0; id < graph.nodes_.size(); id++) {
+    const auto& node = graph.nodes_[id];
+    if (node.removed_) {
+      continue;
+    }
+
+    out << "#" << id << " " << std::visit([](const auto& data) { return std::string(data.kName); }, node.data_) << " \""
+        << node.name_ << "\"";
+
+    if (!node.inputs_.empty()) {
+      out << " <-";
+      for (const auto& input : node.inputs_) {
+        out << " #" << input.node_ << ":" << input.index_;
+      }
+    }
+
+    out << " frequency=" << node.center_frequency_;
+    // sinks do not have outputs
+    if (node.item_size_ != 0) {
+      out << " sample_rate=" << node.sample_rate_;
+    }
+    if (node.sample_format_) {
+      out << " format=" << config::sample_format_to_string(*node.sample_format_);
+    }
+
+    std::visit(ParameterPrinter{out}, node.data_);
+    if (node.partition_) {
+      out << " partition=" << *node.partition_;
+    }
+    out << "\n";
+  }
+
+  return out.str();
+}
+
+} // namespace graph
@@ -0,0 +1,41 @@
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "huge_page_buffer.h"
+
+/// Round value up to the next multiple of alignment
+static auto round_up(const std::size_t value, const std::size_t alignment) -> std::size_t {
+  return ((value + alignment - 1) / alignment) * alignment;
+}
+
+HugePageBuffer::HugePageBuffer(const std::size_t size, const bool huge_pages) {
+#ifdef MAP_HUGETLB
+  if (huge_pages) {
+    const auto huge_size = round_up(size, kHugePageSize);
+    auto* data = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (data != MAP_FAILED) {
+      data_ = data;
+      size_ = huge_size;
+      huge_pages_ = true;
+      return;
+    }
+  }
+#endif
+
+  // no huge pages requested or available, fall back to normal pages
+  const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const auto normal_size = round_up(size, page_size);
+  auto* data = mmap(nullptr, normal_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (data == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+
+  data_ = data;
+  size_ = normal_size;
+}
+
+HugePageBuffer::~HugePageBuffer() noexcept { munmap(data_, size_); }
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "int16_kernels.h"
+
+namespace int16_kernels {
+
+auto complex_dot_product_generic(const int16_t* samples, const int16_t* taps_re, const int16_t* taps_im,
+                                 const std::size_t length, int32_t* re, int32_t* im) -> void {
+  int32_t sum_re = 0;
+  int32_t sum_im = 0;
+
+  for (std::size_t i = 0; i < length; i++) {
+    sum_re += static_cast<int32_t>(samples[i]) * taps_re[i];
+    sum_im += static_cast<int32_t>(samples[i]) * taps_im[i];
+  }
+
+  *re = sum_re;
+  *im = sum_im;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/// Sum the four int32 values of a register
+static inline auto horizontal_sum(__m128i value) -> int32_t {
+  value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+  value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(value);
+}
+
+auto complex_dot_product_sse2(const int16_t* samples, const int16_t* taps_re, const int16_t* taps_im,
+                              const std::size_t length, int32_t* re, int32_t* im) -> void {
+  __m128i sum_re = _mm_setzero_si128();
+  __m128i sum_im = _mm_setzero_si128();
+
+  for (std::size_t i = 0; i < length; i += 8) {
+    const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+    // multiply the int16 pairs and add each pair to an int32: re * re - im * im and re * im + im * re
+    sum_re = _mm_add_epi32(sum_re, _mm_madd_epi16(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(taps_re + i))));
+    sum_im = _mm_add_epi32(sum_im, _mm_madd_epi16(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(taps_im + i))));
+  }
+
+  *re = horizontal_sum(sum_re);
+  *im = horizontal_sum(sum_im);
+}
+
+__attribute__((target("avx2"))) auto complex_dot_product_avx2(const int16_t* samples, const int16_t* taps_re,
+                                                              const int16_t* taps_im, const std::size_t length,
+                                                              int32_t* re, int32_t* im) -> void {
+  __m256i sum_re = _mm256_setzero_si256();
+  __m256i sum_im = _mm256_setzero_si256();
+
+  for (std::size_t i = 0; i < length; i += 16) {
+    const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+    sum_re = _mm256_add_epi32(sum_re,
+                              _mm256_madd_epi16(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(taps_re + i))));
+    sum_im = _mm256_add_epi32(sum_im,
+                              _mm256_madd_epi16(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(taps_im + i))));
+  }
+
+  *re = horizontal_sum(_mm_add_epi32(_mm256_castsi256_si128(sum_re), _mm256_extracti128_si256(sum_re, 1)));
+  *im = horizontal_sum(_mm_add_epi32(_mm256_castsi256_si128(sum_im), _mm256_extracti128_si256(sum_im, 1)));
+}
+
+#endif
+
+auto best_complex_dot_product() -> ComplexDotProduct {
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("avx2"))
+    return complex_dot_product_avx2;
+  if (__builtin_cpu_supports("sse2"))
+    return complex_dot_product_sse2;
+#endif
+  return complex_dot_product_generic;
+}
+
+QuantizedTaps::QuantizedTaps(const std::vector<std::complex<float>>& taps, const float max_sample) {
+  float max_tap = 0;
+  float sum_taps = 0;
+  for (const auto& tap : taps) {
+    max_tap = std::max({max_tap, std::abs(tap.real()), std::abs(tap.imag())});
+    sum_taps += std::abs(tap.real()) + std::abs(tap.imag());
+  }
+
+  if (max_tap == 0) {
+    throw std::invalid_argument("Can not quantize taps that are all zero.");
+  }
+
+  // the largest scale that neither overflows a tap nor the sum of all products
+  const float max_int16 = std::numeric_limits<int16_t>::max();
+  const float max_int32 = static_cast<float>(std::numeric_limits<int32_t>::max()) * 0.99f;
+  scale_ = std::min(max_int16 / max_tap, max_int32 / (sum_taps * max_sample));
+
+  const auto length = ((2 * taps.size() + kBlockLength - 1) / kBlockLength) * kBlockLength;
+  re_.resize(length, 0);
+  im_.resize(length, 0);
+
+  for (std::size_t i = 0; i < taps.size(); i++) {
+    const auto tap_re = static_cast<int16_t>(std::lround(taps[i].real() * scale_));
+    const auto tap_im = static_cast<int16_t>(std::lround(taps[i].imag() * scale_));
+
+    re_[2 * i] = tap_re;
+    re_[2 * i + 1] = static_cast<int16_t>(-tap_im);
+    im_[2 * i] = tap_im;
+    im_[2 * i + 1] = tap_re;
+  }
+}
+
+auto widen_cs8(const int8_t* in, int16_t* out, const std::size_t length) -> void {
+  for (std::size_t i = 0; i < length; i++) {
+    out[i] = in[i];
+  }
+}
+
+auto widen_cu8(const uint8_t* in, int16_t* out, const std::size_t length) -> void {
+  // flipping the most significant bit converts offset binary to two's complement
+  for (std::size_t i = 0; i < length; i++) {
+    out[i] = static_cast<int8_t>(in[i] ^ 0x80);
+  }
+}
+
+} // namespace int16_kernels
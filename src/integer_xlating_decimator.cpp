@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <gnuradio/io_signature.h>
+
+#include "integer_xlating_decimator.h"
+
+namespace gr::tetra {
+
+/// The number of samples after which the phase of the rotator is normalized to a magnitude of one
+static constexpr int kPhaseNormalizationInterval = 512;
+
+/// Shift the real low pass taps to the center frequency and reverse them, so the filter is a dot product
+static auto shifted_reversed_taps(const std::vector<float>& taps, const double center_frequency,
+                                  const double sample_rate) -> std::vector<std::complex<float>> {
+  const auto fwT0 = 2 * M_PI * center_frequency / sample_rate;
+
+  std::vector<std::complex<float>> shifted(taps.size());
+  for (std::size_t i = 0; i < taps.size(); i++) {
+    shifted[taps.size() - 1 - i] = taps[i] * std::polar(1.0f, static_cast<float>(i * fwT0));
+  }
+
+  return shifted;
+}
+
+IntegerXlatingDecimator::sptr IntegerXlatingDecimator::make(const config::SampleFormat format,
+                                                            const unsigned int decimation,
+                                                            const std::vector<float>& taps,
+                                                            const double center_frequency, const double sample_rate) {
+  return gnuradio::get_initial_sptr(
+      new IntegerXlatingDecimator(format, decimation, taps, center_frequency, sample_rate));
+}
+
+IntegerXlatingDecimator::IntegerXlatingDecimator(const config::SampleFormat format, const unsigned int decimation,
+                                                 const std::vector<float>& taps, const double center_frequency,
+                                                 const double sample_rate)
+    : sync_decimator(
+          /*name=*/"IntegerXlatingDecimator",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1,
+                             /*sizeof_stream_items=*/config::sample_format_size(format)),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*decimation=*/decimation)
+    , format_(format)
+    , taps_(shifted_reversed_taps(taps, center_frequency, sample_rate), config::sample_format_full_scale(format))
+    , ntaps_(taps.size())
+    , dot_product_(int16_kernels::best_complex_dot_product())
+    , output_scale_(1.0f / (taps_.scale_ * config::sample_format_full_scale(format)))
+    , phase_increment_(std::polar(1.0f, static_cast<float>(-2 * M_PI * center_frequency / sample_rate * decimation))) {
+  if (format == config::SampleFormat::kComplexFloat32) {
+    throw std::invalid_argument("IntegerXlatingDecimator only filters integer samples.");
+  }
+
+  set_history(ntaps_);
+}
+
+auto IntegerXlatingDecimator::filter(const int16_t* samples, const int noutput_items, gr_complex* out) -> void {
+  const auto decimation = this->decimation();
+
+  for (int i = 0; i < noutput_items; i++) {
+    int32_t re = 0;
+    int32_t im = 0;
+    dot_product_(samples + 2 * i * decimation, taps_.re_.data(), taps_.im_.data(), taps_.length(), &re, &im);
+
+    out[i] = gr_complex(static_cast<float>(re), static_cast<float>(im)) * output_scale_ * phase_;
+
+    phase_ *= phase_increment_;
+    if (i % kPhaseNormalizationInterval == 0)
+      phase_ /= std::abs(phase_);
+  }
+}
+
+auto IntegerXlatingDecimator::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                                   gr_vector_void_star& output_items) -> int {
+  auto* out = (gr_complex*)output_items[0];
+  const std::size_t decimation = this->decimation();
+  // the int16 values of the input including the history
+  const std::size_t count = 2 * (noutput_items * decimation + ntaps_ - 1);
+
+  if (format_ == config::SampleFormat::kComplexInt16) {
+    // filter the samples in place as far as the taps that are padded to the block length stay inside the input
+    const auto* in = (const int16_t*)input_items[0];
+    const auto direct =
+        count < taps_.length()
+            ? 0
+            : std::min<std::size_t>(noutput_items, (count - taps_.length()) / (2 * decimation) + 1);
+    filter(in, static_cast<int>(direct), out);
+
+    // the padding of the taps of the last outputs reaches past the input, only their samples are copied and padded
+    const auto tail = 2 * direct * decimation;
+    samples_.assign(in + tail, in + count);
+    samples_.resize(count - tail + taps_.length(), 0);
+    filter(samples_.data(), noutput_items - static_cast<int>(direct), out + direct);
+
+    return noutput_items;
+  }
+
+  // widen the input including the history to int16 and pad it for the taps that are padded to the block length
+  samples_.resize(count + taps_.length());
+  std::memset(samples_.data() + count, 0, taps_.length() * sizeof(int16_t));
+
+  switch (format_) {
+  case config::SampleFormat::kComplexInt8:
+    int16_kernels::widen_cs8((const int8_t*)input_items[0], samples_.data(), count);
+    break;
+  case config::SampleFormat::kComplexUint8:
+    int16_kernels::widen_cu8((const uint8_t*)input_items[0], samples_.data(), count);
+    break;
+  case config::SampleFormat::kComplexInt16:
+  case config::SampleFormat::kComplexFloat32:
+    break;
+  }
+
+  filter(samples_.data(), noutput_items, out);
+
+  return noutput_items;
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/logger.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "iq_deframer.h"
+#include "ring_buffer_source.h"
+
+namespace gr::tetra {
+
+/// The time work waits for a frame before it returns without samples
+static constexpr int kReceiveTimeoutMilliseconds = 100;
+/// The size of the receive buffer of the socket, which bridges the time the flowgraph does not read from it
+static constexpr int kReceiveBufferSize = 8 * 1024 * 1024;
+
+// the floats of the payload are little-endian and copied as they are
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "The IqDeframer only supports little-endian hosts.");
+
+IqDeframer::sptr IqDeframer::make(const uint16_t port, const unsigned int sample_rate,
+                                  const unsigned int center_frequency) {
+  return gnuradio::get_initial_sptr(new IqDeframer(port, sample_rate, center_frequency));
+}
+
+IqDeframer::IqDeframer(const uint16_t port, const unsigned int sample_rate, const unsigned int center_frequency)
+    : sync_block(
+          /*name=*/"IqDeframer",
+          /*input_signature=*/io_signature::make(/*min_streams=*/0, /*max_streams=*/0, /*sizeof_stream_items=*/0),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)))
+    , deframer_(udp_frame::PayloadType::kComplexFloat32, /*item_size=*/sizeof(gr_complex), sample_rate,
+                center_frequency)
+    , datagram_(udp_frame::kMaxFrameSize) {
+  socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (socket_ < 0) {
+    throw std::invalid_argument(std::string("Could not create the socket of the InputPort: ") + std::strerror(errno));
+  }
+
+  // the kernel drops the datagrams that do not fit into the receive buffer, which the deframer replaces by zeros
+  ::setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &kReceiveBufferSize, sizeof(kReceiveBufferSize));
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+  if (::bind(socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+    const auto error = errno;
+    ::close(socket_);
+    throw std::invalid_argument("Could not bind the InputPort " + std::to_string(port) + ": " + std::strerror(error));
+  }
+}
+
+IqDeframer::~IqDeframer() { ::close(socket_); }
+
+auto IqDeframer::receive(const uint64_t position) -> bool {
+  pollfd fd{/*fd=*/socket_, /*events=*/POLLIN, /*revents=*/0};
+  if (::poll(&fd, 1, kReceiveTimeoutMilliseconds) <= 0) {
+    return false;
+  }
+
+  const auto size = ::recv(socket_, datagram_.data(), datagram_.size(), 0);
+  if (size < 0) {
+    return false;
+  }
+
+  try {
+    const auto frame = deframer_.push(datagram_.data(), static_cast<std::size_t>(size));
+    // late frames are dropped
+    if (!frame) {
+      return true;
+    }
+
+    if (frame->lost_items_ > 0) {
+      zeros_ = frame->lost_items_;
+      add_item_tag(/*which_output=*/0, /*abs_offset=*/position, /*key=*/kRxDropKey,
+                   /*value=*/pmt::from_uint64(frame->lost_items_));
+    }
+    samples_.resize(frame->items_);
+    std::memcpy(samples_.data(), frame->payload_, frame->items_ * sizeof(gr_complex));
+    samples_read_ = 0;
+  } catch (const std::invalid_argument& e) {
+    GR_LOG_ERROR(d_logger, std::string("Dropped a frame: ") + e.what());
+  }
+
+  return true;
+}
+
+auto IqDeframer::work(const int noutput_items, gr_vector_const_void_star& /*input_items*/,
+                      gr_vector_void_star& output_items) -> int {
+  auto* out = (gr_complex*)output_items[0];
+  const std::size_t capacity = noutput_items;
+  std::size_t produced = 0;
+
+  while (produced < capacity) {
+    // first the zeros of the lost frames, then the samples of the frame after them
+    if (zeros_ > 0) {
+      const auto count = std::min(zeros_, capacity - produced);
+      std::fill(out + produced, out + produced + count, gr_complex(0));
+      zeros_ -= count;
+      produced += count;
+      continue;
+    }
+    if (samples_read_ < samples_.size()) {
+      const auto count = std::min(samples_.size() - samples_read_, capacity - produced);
+      std::copy_n(samples_.begin() + samples_read_, count, out + produced);
+      samples_read_ += count;
+      produced += count;
+      continue;
+    }
+
+    // return what we have instead of waiting for the next frame
+    if (produced > 0 || !receive(nitems_written(0))) {
+      break;
+    }
+  }
+
+  return static_cast<int>(produced);
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,52 @@
+#include <cstring>
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/io_signature.h>
+
+#include "iq_framer.h"
+
+namespace gr::tetra {
+
+/// The size of the payload of the frames in bytes
+static constexpr std::size_t kPayloadSize = udp_frame::kComplexFloat32PerFrame * sizeof(gr_complex);
+
+// the floats of the payload are little-endian and copied as they are
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "The IqFramer only supports little-endian hosts.");
+
+IqFramer::sptr IqFramer::make(const unsigned int sample_rate, const unsigned int center_frequency) {
+  return gnuradio::get_initial_sptr(new IqFramer(sample_rate, center_frequency));
+}
+
+IqFramer::IqFramer(const unsigned int sample_rate, const unsigned int center_frequency)
+    : sync_decimator(
+          /*name=*/"IqFramer",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1,
+                             /*sizeof_stream_items=*/udp_frame::kHeaderSize + kPayloadSize),
+          /*decimation=*/udp_frame::kComplexFloat32PerFrame) {
+  header_.payload_type_ = udp_frame::PayloadType::kComplexFloat32;
+  header_.sample_rate_ = sample_rate;
+  header_.center_frequency_ = center_frequency;
+  header_.item_count_ = udp_frame::kComplexFloat32PerFrame;
+}
+
+auto IqFramer::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                    gr_vector_void_star& output_items) -> int {
+  const auto* in = (const uint8_t*)input_items[0];
+  auto* out = (uint8_t*)output_items[0];
+
+  for (int i = 0; i < noutput_items; i++) {
+    udp_frame::write_header(header_, out);
+    header_.sequence_++;
+    std::memcpy(out + udp_frame::kHeaderSize, in, kPayloadSize);
+
+    in += kPayloadSize;
+    out += udp_frame::kHeaderSize + kPayloadSize;
+  }
+
+  return noutput_items;
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/logger.h>
+#include <volk/volk.h>
+
+#include "iq_ring_recorder.h"
+#include "ring_recording.h"
+
+namespace gr::tetra {
+
+/// The number of samples the writer thread writes to disk at once. The ring buffer is a multiple of it.
+static constexpr uint64_t kWriteChunkSamples = 512 * 1024;
+/// The seconds of samples the ring buffer holds additionally to the recorded samples, so that the writer thread can
+/// fall behind without losing samples
+static constexpr unsigned int kSlackSeconds = 2;
+/// The interval in which the writer thread checks for new samples
+static constexpr std::chrono::milliseconds kWriterPollInterval(50);
+
+std::atomic<uint64_t> IqRingRecorder::signal_triggers_ = 0;
+
+auto IqRingRecorder::handle_signal(int) -> void { signal_triggers_.fetch_add(1, std::memory_order_relaxed); }
+
+IqRingRecorder::sptr IqRingRecorder::make(const std::string& name, const unsigned int sample_rate,
+                                          const unsigned int center_frequency, const unsigned int pre_trigger_seconds,
+                                          const unsigned int post_trigger_seconds, const std::string& directory,
+                                          const std::optional<float> power_threshold, const bool huge_pages,
+                                          std::optional<std::reference_wrapper<::prometheus::Counter>> dropped) {
+  return gnuradio::get_initial_sptr(new IqRingRecorder(name, sample_rate, center_frequency, pre_trigger_seconds,
+                                                       post_trigger_seconds, directory, power_threshold, huge_pages,
+                                                       dropped));
+}
+
+/// The number of samples the ring buffer needs to hold the recording, the slack and the alignment to the chunks
+static auto ring_capacity(const unsigned int sample_rate, const unsigned int pre_trigger_seconds,
+                          const unsigned int post_trigger_seconds) -> uint64_t {
+  const uint64_t seconds = pre_trigger_seconds + post_trigger_seconds + kSlackSeconds;
+  const uint64_t samples = static_cast<uint64_t>(sample_rate) * seconds;
+  // One chunk for the alignment of the start of the recording and one for the samples currently written by work
+  return ((samples + kWriteChunkSamples - 1) / kWriteChunkSamples + 2) * kWriteChunkSamples;
+}
+
+IqRingRecorder::IqRingRecorder(const std::string& name, const unsigned int sample_rate,
+                               const unsigned int center_frequency, const unsigned int pre_trigger_seconds,
+                               const unsigned int post_trigger_seconds, const std::string& directory,
+                               const std::optional<float> power_threshold, const bool huge_pages,
+                               std::optional<std::reference_wrapper<::prometheus::Counter>> dropped)
+    : sync_block(
+          /*name=*/"IqRingRecorder",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*output_signature=*/io_signature::make(/*min_streams=*/0, /*max_streams=*/0, /*sizeof_stream_items=*/0))
+    , name_(name)
+    , sample_rate_(sample_rate)
+    , center_frequency_(center_frequency)
+    , pre_trigger_samples_(static_cast<uint64_t>(sample_rate) * pre_trigger_seconds)
+    , post_trigger_samples_(static_cast<uint64_t>(sample_rate) * post_trigger_seconds)
+    , directory_(directory)
+    , power_threshold_(power_threshold)
+    , dropped_(dropped)
+    , buffer_(ring_capacity(sample_rate, pre_trigger_seconds, post_trigger_seconds) * sizeof(gr_complex), huge_pages)
+    , ring_(static_cast<gr_complex*>(buffer_.data()))
+    , capacity_(ring_capacity(sample_rate, pre_trigger_seconds, post_trigger_seconds)) {
+  // work must not write more than one chunk at once, otherwise it could overwrite samples the writer is reading
+  set_max_noutput_items(kWriteChunkSamples);
+
+  if (power_threshold_) {
+    magnitudes_.resize(kWriteChunkSamples);
+  }
+
+  static std::once_flag signal_handler_installed;
+  std::call_once(signal_handler_installed, [] { std::signal(SIGUSR1, handle_signal); });
+  handled_signal_triggers_ = signal_triggers_.load(std::memory_order_relaxed);
+}
+
+auto IqRingRecorder::start() -> bool {
+  stop_writer_ = false;
+  writer_ = std::thread(&IqRingRecorder::write_recordings, this);
+
+  return sync_block::start();
+}
+
+auto IqRingRecorder::stop() -> bool {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_writer_ = true;
+  }
+  condition_.notify_one();
+
+  if (writer_.joinable())
+    writer_.join();
+
+  return sync_block::stop();
+}
+
+auto IqRingRecorder::trigger() -> void {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // a recording is already running
+  if (recording_)
+    return;
+
+  const auto written = written_.load(std::memory_order_relaxed);
+  auto start = written > pre_trigger_samples_ ? written - pre_trigger_samples_ : 0;
+  // align the start to a chunk, so all writes start on an aligned position in the ring buffer
+  start -= start % kWriteChunkSamples;
+
+  recording_ = std::make_pair(start, written + post_trigger_samples_);
+  condition_.notify_one();
+}
+
+auto IqRingRecorder::write_recordings() -> void {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    condition_.wait(lock, [this] { return stop_writer_ || recording_.has_value(); });
+
+    if (stop_writer_)
+      return;
+
+    const auto [start, end] = *recording_;
+
+    lock.unlock();
+    write_recording(start, end);
+    lock.lock();
+
+    recording_.reset();
+  }
+}
+
+auto IqRingRecorder::write_recording(const uint64_t start, const uint64_t end) -> void {
+  const auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+  const auto path = directory_ + "/" + name_ + "_" + std::to_string(center_frequency_) + "Hz_" +
+                    std::to_string(sample_rate_) + "sps_" + std::to_string(now.count()) + ".cf32";
+
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    GR_LOG_ERROR(d_logger, "Could not open recording " + path + ": " + std::strerror(errno));
+    return;
+  }
+
+  GR_LOG_INFO(d_logger, "Recording to " + path);
+
+  RingRecording recording(capacity_, kWriteChunkSamples, start, end);
+  while (!recording.finished() && !stop_writer_) {
+    const auto chunk = recording.next(written_.load(std::memory_order_acquire));
+    if (!chunk) {
+      if (!recording.finished()) {
+        std::this_thread::sleep_for(kWriterPollInterval);
+      }
+      continue;
+    }
+
+    // Chunks start aligned in the ring buffer, which is a multiple of the chunk size. They never wrap around.
+    const auto* data = reinterpret_cast<const char*>(ring_ + chunk->position_ % capacity_);
+    auto remaining = chunk->count_ * sizeof(gr_complex);
+
+    while (remaining > 0) {
+      const auto result = ::write(fd, data, remaining);
+      if (result < 0) {
+        GR_LOG_ERROR(d_logger, "Could not write recording " + path + ": " + std::strerror(errno));
+        ::close(fd);
+        return;
+      }
+      data += result;
+      remaining -= result;
+    }
+
+    // work may have overwritten the chunk while it was written, then the file ends before it
+    if (!recording.commit(*chunk, written_.load(std::memory_order_acquire)) &&
+        ::ftruncate(fd, static_cast<off_t>(recording.recorded() * sizeof(gr_complex))) < 0) {
+      GR_LOG_ERROR(d_logger, "Could not truncate recording " + path + ": " + std::strerror(errno));
+    }
+  }
+
+  if (recording.lapped()) {
+    GR_LOG_ERROR(d_logger, "Writer fell behind, recording " + path + " ends after " +
+                               std::to_string(recording.recorded()) + " samples");
+    if (dropped_) {
+      dropped_->get().Increment(static_cast<double>(recording.dropped()));
+    }
+  }
+
+  ::close(fd);
+
+  GR_LOG_INFO(d_logger, "Finished recording " + path);
+}
+
+auto IqRingRecorder::work(const int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star&)
+    -> int {
+  const auto* in = (const gr_complex*)input_items[0];
+
+  bool triggered = false;
+
+  const auto signal_triggers = signal_triggers_.load(std::memory_order_relaxed);
+  if (signal_triggers != handled_signal_triggers_) {
+    handled_signal_triggers_ = signal_triggers;
+    triggered = true;
+  }
+
+  if (power_threshold_) {
+    float power = 0;
+    volk_32fc_magnitude_squared_32f(magnitudes_.data(), in, noutput_items);
+    volk_32f_accumulator_s32f(&power, magnitudes_.data(), noutput_items);
+
+    if (power / noutput_items > *power_threshold_)
+      triggered = true;
+  }
+
+  // copy the samples into the ring buffer, wrapping around at its end
+  const auto written = written_.load(std::memory_order_relaxed);
+  const auto index = written % capacity_;
+  const auto first = std::min<uint64_t>(noutput_items, capacity_ - index);
+  std::memcpy(ring_ + index, in, first * sizeof(gr_complex));
+  std::memcpy(ring_, in + first, (noutput_items - first) * sizeof(gr_complex));
+  written_.store(written + noutput_items, std::memory_order_release);
+
+  if (triggered)
+    trigger();
+
+  // We do not produce any items.
+  return noutput_items;
+}
+
+} // namespace gr::tetra
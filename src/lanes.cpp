@@ -0,0 +1,377 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "lanes.h"
+
+namespace lanes {
+
+/// The largest interpolation factor of the polyphase resampler
+static constexpr unsigned int kMaxInterpolation = 1024;
+/// The relative change of the gain per sample towards a power of one
+static constexpr float kAgcRate = 1e-3f;
+/// The range of the gain
+static constexpr float kMinGain = 1e-6f;
+static constexpr float kMaxGain = 1e6f;
+/// The gains of the proportional and the integral path of the loop filter of the symbol timing
+static constexpr float kTimingProportional = 0.01f;
+static constexpr float kTimingIntegral = 5e-5f;
+/// The largest magnitude of the output of the timing error detector
+static constexpr float kMaxTimingError = 1.0f;
+/// The largest deviation of the decrement of the timing counter from its nominal value
+static constexpr float kMaxStepDeviation = 0.05f;
+/// The gain of the frequency locked loop per symbol
+static constexpr float kFrequencyGain = 2e-3f;
+/// Keeps the normalization of the frequency error finite for lanes without signal
+static constexpr float kEpsilon = 1e-12f;
+
+auto root_raised_cosine(const double sample_rate, const double symbol_rate, const double rolloff,
+                        const std::size_t taps) -> std::vector<float> {
+  std::vector<float> result(taps);
+  double energy = 0;
+
+  for (std::size_t i = 0; i < taps; i++) {
+    // the time from the center of the pulse in symbols
+    const auto t = (static_cast<double>(i) - static_cast<double>(taps - 1) / 2) * symbol_rate / sample_rate;
+    double value = 0;
+    if (std::abs(t) < 1e-9) {
+      value = 1 - rolloff + 4 * rolloff / M_PI;
+    } else if (std::abs(std::abs(t) - 1 / (4 * rolloff)) < 1e-9) {
+      value = rolloff / std::sqrt(2) *
+              ((1 + 2 / M_PI) * std::sin(M_PI / (4 * rolloff)) + (1 - 2 / M_PI) * std::cos(M_PI / (4 * rolloff)));
+    } else {
+      value = (std::sin(M_PI * t * (1 - rolloff)) + 4 * rolloff * t * std::cos(M_PI * t * (1 + rolloff))) /
+              (M_PI * t * (1 - std::pow(4 * rolloff * t, 2)));
+    }
+    result[i] = static_cast<float>(value);
+    energy += value * value;
+  }
+
+  for (auto& tap : result) {
+    tap = static_cast<float>(tap / std::sqrt(energy));
+  }
+
+  return result;
+}
+
+State::State(const std::size_t lanes, const unsigned int input_sample_rate, const unsigned int symbol_rate)
+    : lanes_(((lanes + kLaneBlock - 1) / kLaneBlock) * kLaneBlock)
+    , active_lanes_(lanes) {
+  if (lanes == 0) {
+    throw std::invalid_argument("The demodulator needs at least one lane.");
+  }
+  if (input_sample_rate == 0 || symbol_rate == 0) {
+    throw std::invalid_argument("The sample rate and the symbol rate of the lanes have to be positive.");
+  }
+
+  const auto output_sample_rate = symbol_rate * kSamplesPerSymbol;
+  const auto divisor = std::gcd(input_sample_rate, output_sample_rate);
+  interpolation_ = output_sample_rate / divisor;
+  decimation_ = input_sample_rate / divisor;
+  if (interpolation_ > kMaxInterpolation) {
+    throw std::invalid_argument("The sample rate of the lanes " + std::to_string(input_sample_rate) +
+                                " can not be resampled to " + std::to_string(output_sample_rate) +
+                                " with a polyphase filter of at most " + std::to_string(kMaxInterpolation) +
+                                " phases.");
+  }
+
+  // the matched filter at the interpolated rate, scaled so that each phase has a gain of about one
+  const auto prototype = root_raised_cosine(static_cast<double>(input_sample_rate) * interpolation_, symbol_rate,
+                                            kRolloff, interpolation_ * kTapsPerPhase);
+  const auto sum = std::accumulate(prototype.begin(), prototype.end(), 0.0);
+  taps_.resize(prototype.size());
+  for (unsigned int phase = 0; phase < interpolation_; phase++) {
+    for (unsigned int tap = 0; tap < kTapsPerPhase; tap++) {
+      taps_[phase * kTapsPerPhase + tap] =
+          static_cast<float>(prototype[phase + tap * interpolation_] * interpolation_ / sum);
+    }
+  }
+
+  history_re_.resize(2 * kTapsPerPhase * lanes_, 0);
+  history_im_.resize(2 * kTapsPerPhase * lanes_, 0);
+  rotation_re_.resize(lanes_, 1);
+  rotation_im_.resize(lanes_, 0);
+  frequency_.resize(lanes_, 0);
+  gain_.resize(lanes_, 1);
+  samples_re_.resize(kInterpolatorRows * lanes_, 0);
+  samples_im_.resize(kInterpolatorRows * lanes_, 0);
+  counter_.resize(lanes_, 0);
+  step_.resize(lanes_, 1.0f / kSamplesPerSymbol);
+  integrator_.resize(lanes_, 0);
+  previous_re_.resize(lanes_, 0);
+  previous_im_.resize(lanes_, 0);
+  strobe_.resize(lanes_, 0);
+  symbol_re_.resize(lanes_, 0);
+  symbol_im_.resize(lanes_, 0);
+  sum_re_.resize(lanes_, 0);
+  sum_im_.resize(lanes_, 0);
+  input_re_.resize(kChunkSize * lanes_, 0);
+  input_im_.resize(kChunkSize * lanes_, 0);
+}
+
+/// Derotate the input samples of one row, write them into the ring of the resampler and advance the phasors
+static inline __attribute__((always_inline)) auto derotate(State& state, const std::size_t row) -> void {
+  const auto lanes = state.lanes_;
+  state.history_position_ = (state.history_position_ + 1) % kTapsPerPhase;
+
+  const float* __restrict in_re = state.input_re_.data() + row * lanes;
+  const float* __restrict in_im = state.input_im_.data() + row * lanes;
+  float* __restrict history_re = state.history_re_.data() + state.history_position_ * lanes;
+  float* __restrict history_im = state.history_im_.data() + state.history_position_ * lanes;
+  float* __restrict copy_re = history_re + kTapsPerPhase * lanes;
+  float* __restrict copy_im = history_im + kTapsPerPhase * lanes;
+  float* __restrict rotation_re = state.rotation_re_.data();
+  float* __restrict rotation_im = state.rotation_im_.data();
+  const float* __restrict frequency = state.frequency_.data();
+
+#pragma GCC ivdep
+  for (std::size_t k = 0; k < lanes; k++) {
+    const float x_re = in_re[k] * rotation_re[k] - in_im[k] * rotation_im[k];
+    const float x_im = in_re[k] * rotation_im[k] + in_im[k] * rotation_re[k];
+    history_re[k] = x_re;
+    history_im[k] = x_im;
+    copy_re[k] = x_re;
+    copy_im[k] = x_im;
+
+    // rotate the phasor by minus the frequency with the small angle approximations of the cosine and the sine, and
+    // pull its magnitude back to one with a step of Newton's method
+    const float w = frequency[k];
+    const float c = 1 - w * w / 2;
+    const float s = w - w * w * w / 6;
+    const float r_re = rotation_re[k] * c + rotation_im[k] * s;
+    const float r_im = rotation_im[k] * c - rotation_re[k] * s;
+    const float correction = 1.5f - 0.5f * (r_re * r_re + r_im * r_im);
+    rotation_re[k] = r_re * correction;
+    rotation_im[k] = r_im * correction;
+  }
+}
+
+/// Compute the next output sample of the resampler into sum_re_ and sum_im_
+static inline __attribute__((always_inline)) auto resample(State& state) -> void {
+  const auto lanes = state.lanes_;
+  const float* __restrict taps = state.taps_.data() + state.phase_ * kTapsPerPhase;
+  float* __restrict sum_re = state.sum_re_.data();
+  float* __restrict sum_im = state.sum_im_.data();
+
+  std::fill_n(sum_re, lanes, 0.0f);
+  std::fill_n(sum_im, lanes, 0.0f);
+  for (std::size_t t = 0; t < kTapsPerPhase; t++) {
+    // the input sample t samples before the newest one
+    const auto row = state.history_position_ + kTapsPerPhase - t;
+    const float* __restrict history_re = state.history_re_.data() + row * lanes;
+    const float* __restrict history_im = state.history_im_.data() + row * lanes;
+    const float tap = taps[t];
+#pragma GCC ivdep
+    for (std::size_t k = 0; k < lanes; k++) {
+      sum_re[k] += tap * history_re[k];
+      sum_im[k] += tap * history_im[k];
+    }
+  }
+}
+
+/// Limit a value to a range with selects that the compiler can vectorize
+static inline __attribute__((always_inline)) auto clamp(const float value, const float low, const float high)
+    -> float {
+  const float limited = value < low ? low : value;
+  return limited > high ? high : limited;
+}
+
+/// Control the gain of the output sample of the resampler, recover the symbol timing and decode the strobed symbols
+static inline __attribute__((always_inline)) auto recover(State& state) -> void {
+  const auto lanes = state.lanes_;
+  state.samples_position_ = (state.samples_position_ + 1) % kInterpolatorRows;
+  const auto row = [&state, lanes](const std::size_t age) {
+    return ((state.samples_position_ + kInterpolatorRows - age) % kInterpolatorRows) * lanes;
+  };
+
+  const float* __restrict sum_re = state.sum_re_.data();
+  const float* __restrict sum_im = state.sum_im_.data();
+  float* __restrict gain = state.gain_.data();
+  float* __restrict y0_re = state.samples_re_.data() + row(0);
+  float* __restrict y0_im = state.samples_im_.data() + row(0);
+  const float* __restrict y1_re = state.samples_re_.data() + row(1);
+  const float* __restrict y1_im = state.samples_im_.data() + row(1);
+  const float* __restrict y2_re = state.samples_re_.data() + row(2);
+  const float* __restrict y2_im = state.samples_im_.data() + row(2);
+  const float* __restrict y3_re = state.samples_re_.data() + row(3);
+  const float* __restrict y3_im = state.samples_im_.data() + row(3);
+  const float* __restrict y4_re = state.samples_re_.data() + row(4);
+  const float* __restrict y4_im = state.samples_im_.data() + row(4);
+  float* __restrict counter = state.counter_.data();
+  float* __restrict step = state.step_.data();
+  float* __restrict integrator = state.integrator_.data();
+  float* __restrict frequency = state.frequency_.data();
+  float* __restrict previous_re = state.previous_re_.data();
+  float* __restrict previous_im = state.previous_im_.data();
+  float* __restrict strobe = state.strobe_.data();
+  float* __restrict symbol_re = state.symbol_re_.data();
+  float* __restrict symbol_im = state.symbol_im_.data();
+
+#pragma GCC ivdep
+  for (std::size_t k = 0; k < lanes; k++) {
+    // automatic gain control towards a power of one
+    const float y_re = gain[k] * sum_re[k];
+    const float y_im = gain[k] * sum_im[k];
+    const float power = y_re * y_re + y_im * y_im;
+    gain[k] = clamp(gain[k] + kAgcRate * gain[k] * (1 - power), kMinGain, kMaxGain);
+    y0_re[k] = y_re;
+    y0_im[k] = y_im;
+
+    // the counter underflows once per symbol, its value before the underflow gives the fractional position of the
+    // symbol between the samples two and one before the newest one
+    const float mu = counter[k] / step[k];
+    const float next = counter[k] - step[k];
+
+    // cubic Lagrange interpolation of the symbol and of the sample half a symbol, one sample, before it
+    const float c0 = -mu * (mu - 1) * (mu - 2) / 6;
+    const float c1 = (mu + 1) * (mu - 1) * (mu - 2) / 2;
+    const float c2 = -(mu + 1) * mu * (mu - 2) / 2;
+    const float c3 = (mu + 1) * mu * (mu - 1) / 6;
+    const float on_re = c0 * y3_re[k] + c1 * y2_re[k] + c2 * y1_re[k] + c3 * y_re;
+    const float on_im = c0 * y3_im[k] + c1 * y2_im[k] + c2 * y1_im[k] + c3 * y_im;
+    const float mid_re = c0 * y4_re[k] + c1 * y3_re[k] + c2 * y2_re[k] + c3 * y1_re[k];
+    const float mid_im = c0 * y4_im[k] + c1 * y3_im[k] + c2 * y2_im[k] + c3 * y1_im[k];
+
+    // Gardner timing error detector and proportional-integral loop filter. The error is limited so that the large
+    // errors while the gain settles do not wind up the integrator.
+    const float timing_error = clamp((on_re - previous_re[k]) * mid_re + (on_im - previous_im[k]) * mid_im,
+                                     -kMaxTimingError, kMaxTimingError);
+    const float next_integrator =
+        clamp(integrator[k] + kTimingIntegral * timing_error, -kMaxStepDeviation, kMaxStepDeviation);
+    const float deviation =
+        clamp(kTimingProportional * timing_error + next_integrator, -kMaxStepDeviation, kMaxStepDeviation);
+
+    // differential decoding
+    const float d_re = on_re * previous_re[k] + on_im * previous_im[k];
+    const float d_im = on_im * previous_re[k] - on_re * previous_im[k];
+
+    // the fourth power removes the modulation of the phase changes, which are odd multiples of π/4, and leaves minus
+    // four times the phase change caused by the frequency offset
+    const float d2_re = d_re * d_re - d_im * d_im;
+    const float d2_im = 2 * d_re * d_im;
+    const float frequency_error = -2 * d2_re * d2_im / (d2_re * d2_re + d2_im * d2_im + kEpsilon);
+
+    // the loops only advance in the lanes that strobed a symbol, written as blends of both values so that every lane
+    // takes the same path
+    const float strobed = next < 0 ? 1.0f : 0.0f;
+    integrator[k] += strobed * (next_integrator - integrator[k]);
+    step[k] += strobed * (1.0f / kSamplesPerSymbol + deviation - step[k]);
+    counter[k] = next + strobed;
+    frequency[k] += strobed * kFrequencyGain * frequency_error;
+    previous_re[k] += strobed * (on_re - previous_re[k]);
+    previous_im[k] += strobed * (on_im - previous_im[k]);
+    strobe[k] = strobed;
+    symbol_re[k] = d_re;
+    symbol_im[k] = d_im;
+  }
+}
+
+/// Demodulate the transposed chunk. The loops over the lanes are vectorized by the compiler for the instruction set of
+/// the function this is inlined into.
+static inline __attribute__((always_inline)) auto process_body(State& state, const std::size_t count,
+                                                               std::complex<float>* const* outputs,
+                                                               std::size_t* produced) -> void {
+  for (std::size_t i = 0; i < count; i++) {
+    derotate(state, i);
+
+    while (state.phase_ < state.interpolation_) {
+      resample(state);
+      state.phase_ += state.decimation_;
+      recover(state);
+
+      for (std::size_t k = 0; k < state.active_lanes_; k++) {
+        if (state.strobe_[k] != 0) {
+          outputs[k][produced[k]++] = {state.symbol_re_[k], state.symbol_im_[k]};
+        }
+      }
+    }
+    state.phase_ -= state.interpolation_;
+  }
+}
+
+auto process_generic(State& state, const std::size_t count, std::complex<float>* const* outputs,
+                     std::size_t* produced) -> void {
+  process_body(state, count, outputs, produced);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2"))) auto process_avx2(State& state, const std::size_t count,
+                                                  std::complex<float>* const* outputs, std::size_t* produced)
+    -> void {
+  process_body(state, count, outputs, produced);
+}
+
+__attribute__((target("avx512f"))) auto process_avx512(State& state, const std::size_t count,
+                                                       std::complex<float>* const* outputs, std::size_t* produced)
+    -> void {
+  process_body(state, count, outputs, produced);
+}
+
+#endif
+
+auto best_kernel() -> Kernel {
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("avx512f"))
+    return process_avx512;
+  if (__builtin_cpu_supports("avx2"))
+    return process_avx2;
+#endif
+  return process_generic;
+}
+
+Demodulator::Demodulator(const std::size_t lanes, const unsigned int input_sample_rate,
+                         const unsigned int symbol_rate, const Kernel kernel)
+    : lanes_(lanes)
+    , input_sample_rate_(input_sample_rate)
+    , kernel_(kernel)
+    , state_(lanes, input_sample_rate, symbol_rate) {}
+
+auto Demodulator::process(const std::complex<float>* const* inputs, const std::size_t count,
+                          std::complex<float>* const* outputs, std::size_t* produced) -> void {
+  std::fill_n(produced, lanes_, 0);
+
+  for (std::size_t offset = 0; offset < count; offset += kChunkSize) {
+    const auto chunk = std::min(kChunkSize, count - offset);
+
+    // transpose the chunk into rows of lanes, the padding lanes stay zero
+    for (std::size_t k = 0; k < lanes_; k++) {
+      const auto* in = inputs[k] + offset;
+      for (std::size_t i = 0; i < chunk; i++) {
+        state_.input_re_[i * state_.lanes_ + k] = in[i].real();
+        state_.input_im_[i * state_.lanes_ + k] = in[i].imag();
+      }
+    }
+
+    kernel_(state_, chunk, outputs, produced);
+  }
+}
+
+auto Demodulator::max_symbols(const std::size_t count) const noexcept -> std::size_t {
+  if (count == 0) {
+    return 0;
+  }
+  // the resampler produces at most one sample more than its rate and each sample strobes at most
+  // 1 / kSamplesPerSymbol + kMaxStepDeviation symbols, which is less than 3 / 5
+  const auto samples = count * state_.interpolation_ / state_.decimation_ + 1;
+  return samples * 3 / 5 + 1;
+}
+
+auto Demodulator::max_samples(const std::size_t symbols) const noexcept -> std::size_t {
+  auto count = (symbols * 5 / 3) * state_.decimation_ / state_.interpolation_;
+  while (count > 0 && max_symbols(count) > symbols) {
+    count--;
+  }
+  return count;
+}
+
+auto Demodulator::frequency_offset(const std::size_t lane) const -> double {
+  if (lane >= lanes_) {
+    throw std::invalid_argument("The demodulator has no lane " + std::to_string(lane) + ".");
+  }
+  return state_.frequency_[lane] * input_sample_rate_ / (2 * M_PI);
+}
+
+} // namespace lanes
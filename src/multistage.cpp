@@ -0,0 +1,102 @@
+#include "multistage.h"
+
+#include <functional>
+#include <stdexcept>
+
+namespace multistage {
+
+auto estimated_taps(const double sample_rate, const double transition_width) -> unsigned int {
+  // the same estimate as firdes::compute_ntaps, which rounds up to an odd number of taps
+  auto ntaps = static_cast<unsigned int>(kWindowAttenuation * sample_rate / (22.0 * transition_width));
+  if ((ntaps & 1) == 0) {
+    ntaps++;
+  }
+  return ntaps;
+}
+
+auto cost(const std::vector<Stage>& stages) -> double {
+  double total = 0;
+  // the number of input samples per input sample of the current stage
+  double input_per_stage_input = 1;
+
+  for (const auto& stage : stages) {
+    total += estimated_taps(stage.input_sample_rate_, stage.transition_width_) /
+             (input_per_stage_input * stage.decimation_);
+    input_per_stage_input *= stage.decimation_;
+  }
+
+  return total;
+}
+
+/// The stages for the decimations of each stage, or an empty vector if a stage before the last can not reject the
+/// aliases of the final band
+static auto stages_for(const std::vector<unsigned int>& decimations, const double input_sample_rate,
+                       const double cutoff, const double transition_width) -> std::vector<Stage> {
+  // the edge of the passband and the edge of the band that has to be free of aliases
+  const auto passband_edge = cutoff - transition_width / 2;
+  const auto protected_edge = cutoff + transition_width / 2;
+
+  std::vector<Stage> stages;
+  auto sample_rate = input_sample_rate;
+  for (std::size_t i = 0; i + 1 < decimations.size(); i++) {
+    const auto output_sample_rate = sample_rate / decimations[i];
+    // everything above this frequency aliases into the protected band after the decimation
+    const auto stopband_edge = output_sample_rate - protected_edge;
+    if (stopband_edge <= passband_edge) {
+      return {};
+    }
+
+    stages.push_back(Stage{/*decimation=*/decimations[i], /*input_sample_rate=*/sample_rate,
+                           /*cutoff=*/(passband_edge + stopband_edge) / 2,
+                           /*transition_width=*/(stopband_edge - passband_edge) / kTransitionMargin});
+    sample_rate = output_sample_rate;
+  }
+
+  stages.push_back(Stage{/*decimation=*/decimations.back(), /*input_sample_rate=*/sample_rate, /*cutoff=*/cutoff,
+                         /*transition_width=*/transition_width});
+  return stages;
+}
+
+auto plan(const double input_sample_rate, const unsigned int decimation, const double cutoff,
+          const double transition_width) -> std::vector<Stage> {
+  if (decimation == 0) {
+    throw std::invalid_argument("The decimation of a multistage decimator has to be positive.");
+  }
+  if (!(transition_width > 0)) {
+    throw std::invalid_argument("The transition width of a multistage decimator has to be positive.");
+  }
+
+  auto best = stages_for({decimation}, input_sample_rate, cutoff, transition_width);
+  auto best_cost = cost(best);
+
+  // try every ordered factorization with up to kMaximumStages factors
+  std::vector<unsigned int> decimations;
+  const std::function<void(unsigned int)> factorize = [&](const unsigned int remaining) {
+    if (decimations.size() + 2 > kMaximumStages) {
+      return;
+    }
+    for (unsigned int factor = 2; factor * 2 <= remaining; factor++) {
+      if (remaining % factor != 0) {
+        continue;
+      }
+
+      decimations.push_back(factor);
+      decimations.push_back(remaining / factor);
+      const auto stages = stages_for(decimations, input_sample_rate, cutoff, transition_width);
+      // prefer fewer stages at the same cost
+      if (!stages.empty() && cost(stages) < best_cost) {
+        best = stages;
+        best_cost = cost(stages);
+      }
+      decimations.pop_back();
+
+      factorize(remaining / factor);
+      decimations.pop_back();
+    }
+  };
+  factorize(decimation);
+
+  return best;
+}
+
+} // namespace multistage
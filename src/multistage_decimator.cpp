@@ -0,0 +1,100 @@
+#include <cmath>
+#include <stdexcept>
+
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+#include "multistage_decimator.h"
+
+namespace gr::tetra {
+
+/// The rotation per sample that shifts the center frequency to baseband
+static auto phase_increment(const double center_frequency, const double sample_rate) -> gr_complex {
+  return std::polar(1.0f, static_cast<float>(-2 * M_PI * center_frequency / sample_rate));
+}
+
+auto MultistageDecimator::total_decimation(const std::vector<FilterStage>& stages) -> unsigned int {
+  if (stages.empty()) {
+    throw std::invalid_argument("A MultistageDecimator needs at least one stage.");
+  }
+
+  unsigned int decimation = 1;
+  for (const auto& stage : stages) {
+    decimation *= stage.decimation_;
+  }
+  return decimation;
+}
+
+MultistageDecimator::sptr MultistageDecimator::make(const std::vector<FilterStage>& stages,
+                                                    const double center_frequency, const double sample_rate) {
+  return gnuradio::get_initial_sptr(new MultistageDecimator(stages, center_frequency, sample_rate));
+}
+
+MultistageDecimator::MultistageDecimator(const std::vector<FilterStage>& stages, const double center_frequency,
+                                         const double sample_rate)
+    : sync_decimator(
+          /*name=*/"MultistageDecimator",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*decimation=*/total_decimation(stages))
+    , sample_rate_(sample_rate)
+    , phase_increment_(phase_increment(center_frequency, sample_rate)) {
+  for (const auto& stage : stages) {
+    if (stage.decimation_ == 0 || stage.taps_.empty()) {
+      throw std::invalid_argument("A stage of the MultistageDecimator has no decimation or no taps.");
+    }
+
+    // Each stage starts with the history of a filter that has seen only zeros. With ntaps - 1 samples of history
+    // every multiple of the decimation at the input produces exactly one output per decimation.
+    State state;
+    state.decimation_ = stage.decimation_;
+    state.reversed_taps_.assign(stage.taps_.rbegin(), stage.taps_.rend());
+    state.samples_.assign(stage.taps_.size() - 1, 0);
+    stages_.push_back(std::move(state));
+  }
+}
+
+auto MultistageDecimator::set_center_frequency(const double center_frequency) -> void {
+  phase_increment_ = phase_increment(center_frequency, sample_rate_);
+}
+
+auto MultistageDecimator::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                               gr_vector_void_star& output_items) -> int {
+  const auto* in = (const gr_complex*)input_items[0];
+  auto* out = (gr_complex*)output_items[0];
+  const unsigned int ninput_items = noutput_items * decimation();
+
+  // shift the input to baseband behind the history of the first stage
+  auto& first = stages_.front().samples_;
+  const auto history = first.size();
+  first.resize(history + ninput_items);
+  volk_32fc_s32fc_x2_rotator_32fc(first.data() + history, in, phase_increment_, &phase_, ninput_items);
+
+  for (std::size_t i = 0; i < stages_.size(); i++) {
+    auto& stage = stages_[i];
+    const auto ntaps = stage.reversed_taps_.size();
+    const auto outputs = (stage.samples_.size() - (ntaps - 1)) / stage.decimation_;
+
+    // the last stage writes to the output, the others append to the samples of the next stage
+    gr_complex* stage_out = out;
+    if (i + 1 < stages_.size()) {
+      auto& next = stages_[i + 1].samples_;
+      next.resize(next.size() + outputs);
+      stage_out = next.data() + next.size() - outputs;
+    }
+
+    for (std::size_t j = 0; j < outputs; j++) {
+      volk_32fc_32f_dot_prod_32fc(stage_out + j, stage.samples_.data() + j * stage.decimation_,
+                                  stage.reversed_taps_.data(), ntaps);
+    }
+
+    // keep the history for the next call
+    stage.samples_.erase(stage.samples_.begin(), stage.samples_.begin() + outputs * stage.decimation_);
+  }
+
+  return noutput_items;
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,57 @@
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+#include "native_to_complex.h"
+
+namespace gr::tetra {
+
+NativeToComplex::sptr NativeToComplex::make(const config::SampleFormat format) {
+  return gnuradio::get_initial_sptr(new NativeToComplex(format));
+}
+
+NativeToComplex::NativeToComplex(const config::SampleFormat format)
+    : sync_block(
+          /*name=*/"NativeToComplex",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1,
+                             /*sizeof_stream_items=*/config::sample_format_size(format)),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)))
+    , format_(format) {
+  if (format == config::SampleFormat::kComplexFloat32) {
+    throw std::invalid_argument("NativeToComplex only converts integer samples.");
+  }
+}
+
+auto NativeToComplex::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                           gr_vector_void_star& output_items) -> int {
+  auto* out = (float*)output_items[0];
+  const auto full_scale = config::sample_format_full_scale(format_);
+  const unsigned int count = 2 * noutput_items;
+
+  switch (format_) {
+  case config::SampleFormat::kComplexInt16:
+    volk_16i_s32f_convert_32f(out, (const int16_t*)input_items[0], full_scale, count);
+    break;
+  case config::SampleFormat::kComplexInt8:
+    volk_8i_s32f_convert_32f(out, (const int8_t*)input_items[0], full_scale, count);
+    break;
+  case config::SampleFormat::kComplexUint8: {
+    const auto* in = (const uint8_t*)input_items[0];
+    signed_samples_.resize(count);
+    // flipping the most significant bit converts offset binary to two's complement
+    for (unsigned int i = 0; i < count; i++) {
+      signed_samples_[i] = static_cast<int8_t>(in[i] ^ 0x80);
+    }
+    volk_8i_s32f_convert_32f(out, signed_samples_.data(), full_scale, count);
+    break;
+  }
+  case config::SampleFormat::kComplexFloat32:
+    break;
+  }
+
+  return noutput_items;
+}
+
+} // namespace gr::tetra
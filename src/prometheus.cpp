@@ -10,3 +10,101 @@ PrometheusExporter::PrometheusExporter(const std::string& prometheus_host) noexc
 auto PrometheusExporter::signal_strength() noexcept -> prometheus::Family<prometheus::Gauge>& {
   return prometheus::BuildGauge().Name("signal_strength").Help("Current Signal Strength").Register(*registry_);
 }
+
+auto PrometheusExporter::latency() noexcept -> prometheus::Family<prometheus::Histogram>& {
+  return prometheus::BuildHistogram()
+      .Name("latency_seconds")
+      .Help("Latency between the SDR source and the UDP sink of a stream")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::frequency_offset() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("frequency_offset_hz")
+      .Help("Frequency offset of the carrier of a stream that the frequency locked loop corrects")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::timing_error() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("timing_error")
+      .Help("Root mean square error of the symbol timing recovery of a stream")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::error_vector_magnitude() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("error_vector_magnitude_percent")
+      .Help("Root mean square error vector magnitude of the differentially decoded symbols of a stream")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::modulation_error_ratio() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("modulation_error_ratio_db")
+      .Help("Modulation error ratio of the differentially decoded symbols of a stream")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::signal_to_noise_ratio() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("signal_to_noise_ratio_db")
+      .Help("Signal to noise ratio of the symbols of a stream estimated from the modulation error ratio")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::ring_buffer_fill() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("ring_buffer_fill_seconds")
+      .Help("Seconds of samples currently in the ring buffer")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::ring_buffer_high_water() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("ring_buffer_high_water_seconds")
+      .Help("Maximum seconds of samples that were in the ring buffer")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::ring_buffer_dropped() noexcept -> prometheus::Family<prometheus::Counter>& {
+  return prometheus::BuildCounter()
+      .Name("ring_buffer_dropped_samples_total")
+      .Help("Samples dropped because the ring buffer was full")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::scheduler_threads() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("scheduler_threads")
+      .Help("Threads that run the blocks of the flowgraph")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::bridge_backlog() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("bridge_backlog_seconds")
+      .Help("Seconds of samples waiting for the thread of the consuming partition")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::bridge_backlog_high_water() noexcept -> prometheus::Family<prometheus::Gauge>& {
+  return prometheus::BuildGauge()
+      .Name("bridge_backlog_high_water_seconds")
+      .Help("Maximum seconds of samples that waited for the thread of the consuming partition")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::bridge_dropped() noexcept -> prometheus::Family<prometheus::Counter>& {
+  return prometheus::BuildCounter()
+      .Name("bridge_dropped_samples_total")
+      .Help("Samples dropped because the thread of the consuming partition fell behind")
+      .Register(*registry_);
+}
+
+auto PrometheusExporter::recorder_dropped() noexcept -> prometheus::Family<prometheus::Counter>& {
+  return prometheus::BuildCounter()
+      .Name("recorder_dropped_samples_total")
+      .Help("Samples of recordings lost because the writer fell behind")
+      .Register(*registry_);
+}
@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <cmath>
+
+#include <gnuradio/io_signature.h>
+
+#include "prometheus_gauge_reducer.h"
+
+namespace gr::prometheus {
+
+PrometheusGaugeReducer::sptr PrometheusGaugeReducer::make(::prometheus::Gauge& gauge, const Reduction reduction,
+                                                          const double scale, const uint64_t interval) {
+  return gnuradio::get_initial_sptr(new PrometheusGaugeReducer(gauge, reduction, scale, interval));
+}
+
+PrometheusGaugeReducer::PrometheusGaugeReducer(::prometheus::Gauge& gauge, const Reduction reduction,
+                                               const double scale, const uint64_t interval)
+    : sync_block(
+          /*name=*/"PrometheusGaugeReducer",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(float)),
+          /*output_signature=*/io_signature::make(/*min_streams=*/0, /*max_streams=*/0, /*sizeof_stream_items=*/0))
+    , gauge_(gauge)
+    , reduction_(reduction)
+    , scale_(scale)
+    , interval_(interval > 0 ? interval : 1) {}
+
+auto PrometheusGaugeReducer::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                                  gr_vector_void_star& /*output_items*/) -> int {
+  const auto* in = static_cast<const float*>(input_items[0]);
+
+  for (int i = 0; i < noutput_items; i++) {
+    const double item = in[i];
+    sum_ += reduction_ == Reduction::kMean ? item : item * item;
+
+    if (++count_ < interval_) {
+      continue;
+    }
+
+    const auto mean = sum_ / static_cast<double>(count_);
+    gauge_.Set(scale_ * (reduction_ == Reduction::kMean ? mean : std::sqrt(mean)));
+    sum_ = 0;
+    count_ = 0;
+  }
+
+  // We only reduce the items and do not produce any.
+  return noutput_items;
+}
+
+} // namespace gr::prometheus
@@ -0,0 +1,47 @@
+#include <chrono>
+#include <vector>
+
+#include <gnuradio/io_signature.h>
+
+#include "prometheus_histogram_populator.h"
+#include "timestamp_tagger.h"
+
+namespace gr::prometheus {
+
+PrometheusHistogramPopulator::sptr PrometheusHistogramPopulator::make(::prometheus::Histogram& histogram,
+                                                                      const std::size_t item_size) {
+  return gnuradio::get_initial_sptr(new PrometheusHistogramPopulator(histogram, item_size));
+}
+
+PrometheusHistogramPopulator::PrometheusHistogramPopulator(::prometheus::Histogram& histogram,
+                                                           const std::size_t item_size)
+    : sync_block(
+          /*name=*/"PrometheusHistogramPopulator",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/item_size),
+          /*output_signature=*/io_signature::make(/*min_streams=*/0, /*max_streams=*/0, /*sizeof_stream_items=*/0))
+    , histogram_(histogram) {}
+
+auto PrometheusHistogramPopulator::work(const int noutput_items, gr_vector_const_void_star&, gr_vector_void_star&)
+    -> int {
+  std::vector<tag_t> tags;
+  get_tags_in_range(tags, /*which_input=*/0, /*abs_start=*/nitems_read(0),
+                    /*abs_end=*/nitems_read(0) + noutput_items, /*key=*/tetra::kRxTimeKey);
+
+  if (tags.empty())
+    return noutput_items;
+
+  const std::chrono::duration<double> now = std::chrono::system_clock::now().time_since_epoch();
+
+  for (const auto& tag : tags) {
+    const auto full_seconds = pmt::to_uint64(pmt::tuple_ref(tag.value, 0));
+    const auto frac_seconds = pmt::to_double(pmt::tuple_ref(tag.value, 1));
+
+    histogram_.Observe(now.count() - (static_cast<double>(full_seconds) + frac_seconds));
+  }
+
+  // We only look at the tags and discard the samples.
+  return noutput_items;
+}
+
+} // namespace gr::prometheus
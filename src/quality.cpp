@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "quality.h"
+
+namespace quality {
+
+auto ConstellationError::add(const std::complex<float> symbol) noexcept -> void {
+  // the ideal symbol is in the middle of the quadrant of the symbol, on the diagonal (±1 ±j) / √2. The sums are
+  // computed in double, because the error is their small difference.
+  const std::complex<double> value(symbol);
+  const auto projection = (std::abs(value.real()) + std::abs(value.imag())) * M_SQRT1_2;
+
+  count_++;
+  symbol_power_ += std::norm(value);
+  projection_ += projection;
+}
+
+auto ConstellationError::reset() noexcept -> void {
+  count_ = 0;
+  symbol_power_ = 0;
+  projection_ = 0;
+}
+
+auto ConstellationError::ideal_power() const noexcept -> double {
+  // the amplitude that minimizes the error is the mean of the projections
+  return count_ == 0 ? 0 : projection_ * projection_ / static_cast<double>(count_);
+}
+
+auto ConstellationError::error_power() const noexcept -> double {
+  return std::max(0.0, symbol_power_ - ideal_power());
+}
+
+auto ConstellationError::error_vector_magnitude() const noexcept -> double {
+  const auto ideal = ideal_power();
+  if (ideal == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return 100 * std::sqrt(error_power() / ideal);
+}
+
+auto ConstellationError::modulation_error_ratio() const noexcept -> double {
+  const auto ideal = ideal_power();
+  if (ideal == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return 10 * std::log10(ideal / error_power());
+}
+
+auto ConstellationError::signal_to_noise_ratio() const noexcept -> double {
+  return modulation_error_ratio() + 10 * std::log10(2.0);
+}
+
+} // namespace quality
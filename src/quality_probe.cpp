@@ -0,0 +1,40 @@
+#include <gnuradio/io_signature.h>
+
+#include "quality_probe.h"
+
+namespace gr::tetra {
+
+QualityProbe::sptr QualityProbe::make(QualityMetrics metrics, const uint64_t interval) {
+  return gnuradio::get_initial_sptr(new QualityProbe(metrics, interval));
+}
+
+QualityProbe::QualityProbe(QualityMetrics metrics, const uint64_t interval)
+    : sync_block(
+          /*name=*/"QualityProbe",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*output_signature=*/io_signature::make(/*min_streams=*/0, /*max_streams=*/0, /*sizeof_stream_items=*/0))
+    , metrics_(metrics)
+    , interval_(interval > 0 ? interval : 1) {}
+
+auto QualityProbe::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                        gr_vector_void_star& /*output_items*/) -> int {
+  const auto* in = static_cast<const gr_complex*>(input_items[0]);
+
+  for (int i = 0; i < noutput_items; i++) {
+    error_.add(in[i]);
+    if (error_.count() < interval_) {
+      continue;
+    }
+
+    metrics_.error_vector_magnitude_.Set(error_.error_vector_magnitude());
+    metrics_.modulation_error_ratio_.Set(error_.modulation_error_ratio());
+    metrics_.signal_to_noise_ratio_.Set(error_.signal_to_noise_ratio());
+    error_.reset();
+  }
+
+  // We only look at the symbols and do not produce any items.
+  return noutput_items;
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,50 @@
+#include "resampler.h"
+#include "multistage.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace resampler {
+
+auto taps(const unsigned int filters, const double rate, const double passband) -> std::vector<float> {
+  if (filters == 0 || !(rate > 0 && rate < 1) || !(passband > 0 && passband < 1)) {
+    throw std::invalid_argument("The resampler needs filters, a rate below one and a passband below one.");
+  }
+
+  // the frequencies in units of the input sample rate, the prototype runs at filters times the input sample rate
+  const double sample_rate = filters;
+  const auto passband_edge = passband / 2 * rate;
+  const auto protected_edge = (1 - passband / 2) * rate;
+  const auto cutoff = (passband_edge + protected_edge) / 2;
+  const auto transition_width = (protected_edge - passband_edge) / multistage::kTransitionMargin;
+
+  // the same estimate as firdes::compute_ntaps_windes, which rounds up to an odd number of taps
+  auto ntaps = static_cast<std::size_t>(kAttenuation * sample_rate / (22.0 * transition_width));
+  if ((ntaps & 1) == 0) {
+    ntaps++;
+  }
+
+  // the windowed sinc of firdes::low_pass_2 with the Blackman-Harris window
+  const auto middle = static_cast<double>(ntaps - 1) / 2;
+  const auto omega = 2 * M_PI * cutoff / sample_rate;
+  std::vector<double> prototype(ntaps);
+  double dc_gain = 0;
+  for (std::size_t n = 0; n < ntaps; n++) {
+    const auto x = static_cast<double>(n) - middle;
+    const auto sinc = x == 0 ? omega / M_PI : std::sin(x * omega) / (x * M_PI);
+    const auto phase = 2 * M_PI * static_cast<double>(n) / static_cast<double>(ntaps - 1);
+    const auto window =
+        0.35875 - 0.48829 * std::cos(phase) + 0.14128 * std::cos(2 * phase) - 0.01168 * std::cos(3 * phase);
+    prototype[n] = sinc * window;
+    dc_gain += prototype[n];
+  }
+
+  // each of the filters has unit gain
+  std::vector<float> result(ntaps);
+  for (std::size_t n = 0; n < ntaps; n++) {
+    result[n] = static_cast<float>(prototype[n] * filters / dc_gain);
+  }
+  return result;
+}
+
+} // namespace resampler
@@ -0,0 +1,44 @@
+#include <gnuradio/io_signature.h>
+
+#include "ring_buffer_sink.h"
+
+namespace gr::tetra {
+
+RingBufferSink::sptr RingBufferSink::make(std::shared_ptr<SampleRing> ring, std::shared_ptr<TagQueue> tags) {
+  return gnuradio::get_initial_sptr(new RingBufferSink(std::move(ring), std::move(tags)));
+}
+
+RingBufferSink::RingBufferSink(std::shared_ptr<SampleRing> ring, std::shared_ptr<TagQueue> tags)
+    : sync_block(
+          /*name=*/"RingBufferSink",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/ring->item_size()),
+          /*output_signature=*/io_signature::make(/*min_streams=*/0, /*max_streams=*/0, /*sizeof_stream_items=*/0))
+    , ring_(std::move(ring))
+    , tags_(std::move(tags)) {}
+
+auto RingBufferSink::stop() -> bool {
+  // The block is stopped when its input is done or the flowgraph is stopped
+  ring_->finish();
+  return true;
+}
+
+auto RingBufferSink::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                          gr_vector_void_star& /*output_items*/) -> int {
+  // the samples that do not fit are dropped, the ring records the gap
+  const auto start = nitems_read(0);
+  const auto written = ring_->write(input_items[0], noutput_items);
+
+  // the tags are renumbered to the samples in the ring, the reader may already have read the samples they belong to
+  std::vector<tag_t> tags;
+  get_tags_in_range(tags, /*which_input=*/0, /*abs_start=*/start, /*abs_end=*/start + written);
+  for (auto& tag : tags) {
+    tag.offset = written_ + (tag.offset - start);
+  }
+  tags_->push(tags);
+  written_ += written;
+
+  return noutput_items;
+}
+
+} // namespace gr::tetra
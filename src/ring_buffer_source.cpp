@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>
+
+#include <gnuradio/io_signature.h>
+
+#include "ring_buffer_source.h"
+
+namespace gr::tetra {
+
+RingBufferSource::sptr RingBufferSource::make(std::shared_ptr<SampleRing> ring, std::shared_ptr<TagQueue> tags,
+                                              const double sample_rate, std::optional<RingBufferMetrics> metrics,
+                                              const std::chrono::milliseconds read_timeout) {
+  return gnuradio::get_initial_sptr(
+      new RingBufferSource(std::move(ring), std::move(tags), sample_rate, metrics, read_timeout));
+}
+
+RingBufferSource::RingBufferSource(std::shared_ptr<SampleRing> ring, std::shared_ptr<TagQueue> tags,
+                                   const double sample_rate, std::optional<RingBufferMetrics> metrics,
+                                   const std::chrono::milliseconds read_timeout)
+    : sync_block(
+          /*name=*/"RingBufferSource",
+          /*input_signature=*/io_signature::make(/*min_streams=*/0, /*max_streams=*/0, /*sizeof_stream_items=*/0),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/ring->item_size()))
+    , ring_(std::move(ring))
+    , tags_(std::move(tags))
+    , sample_rate_(sample_rate)
+    , read_timeout_(read_timeout)
+    , metrics_(metrics) {}
+
+auto RingBufferSource::tag_gaps(const uint64_t start, const uint64_t end) -> void {
+  while (true) {
+    if (!gap_) {
+      gap_ = ring_->pop_gap();
+    }
+    if (!gap_ || gap_->position_ >= end) {
+      return;
+    }
+
+    // the samples before the gap were already read if the gap was recorded late
+    add_item_tag(/*which_output=*/0, /*abs_offset=*/std::max(gap_->position_, start), /*key=*/kRxDropKey,
+                 /*value=*/pmt::from_uint64(gap_->dropped_));
+    gap_.reset();
+  }
+}
+
+auto RingBufferSource::forward_tags(const uint64_t start, const uint64_t end) -> void {
+  for (auto& tag : tags_->pop(end)) {
+    tag.offset = std::max(tag.offset, start);
+    add_item_tag(/*which_output=*/0, tag);
+  }
+}
+
+auto RingBufferSource::update_metrics() -> void {
+  if (!metrics_) {
+    return;
+  }
+
+  metrics_->fill_.Set(static_cast<double>(ring_->size()) / sample_rate_);
+  metrics_->high_water_.Set(static_cast<double>(ring_->high_water()) / sample_rate_);
+
+  const auto dropped = ring_->dropped();
+  metrics_->dropped_.Increment(static_cast<double>(dropped - reported_dropped_));
+  reported_dropped_ = dropped;
+}
+
+auto RingBufferSource::work(const int noutput_items, gr_vector_const_void_star& /*input_items*/,
+                            gr_vector_void_star& output_items) -> int {
+  if (!ring_->wait(read_timeout_)) {
+    update_metrics();
+    return ring_->drained() ? WORK_DONE : 0;
+  }
+
+  // the samples of the ring are numbered the same way as the output of this block
+  const auto start = nitems_written(0);
+  const auto read = ring_->read(output_items[0], noutput_items);
+
+  tag_gaps(start, start + read);
+  forward_tags(start, start + read);
+  update_metrics();
+
+  return static_cast<int>(read);
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "ring_recording.h"
+
+RingRecording::RingRecording(const uint64_t capacity, const uint64_t chunk_size, const uint64_t start,
+                             const uint64_t end)
+    : capacity_(capacity)
+    , chunk_size_(chunk_size)
+    , start_(start)
+    , end_(std::max(start, end))
+    , position_(start) {
+  if (chunk_size_ == 0 || capacity_ < chunk_size_ || capacity_ % chunk_size_ != 0) {
+    throw std::invalid_argument("The capacity of the ring has to be a multiple of the chunk size.");
+  }
+  if (start_ % chunk_size_ != 0) {
+    throw std::invalid_argument("The recording has to start at a multiple of the chunk size.");
+  }
+}
+
+auto RingRecording::overwritten(const uint64_t position, const uint64_t written) const noexcept -> bool {
+  return written > position && written - position + chunk_size_ > capacity_;
+}
+
+auto RingRecording::next(const uint64_t written) -> std::optional<Chunk> {
+  if (finished()) {
+    return std::nullopt;
+  }
+  if (overwritten(position_, written)) {
+    lapped_ = true;
+    return std::nullopt;
+  }
+
+  // wait until a full chunk or the end of the recording is available
+  const auto available = written > position_ ? std::min(written, end_) - position_ : 0;
+  if (available < chunk_size_ && position_ + available < end_) {
+    return std::nullopt;
+  }
+
+  return Chunk{/*position_=*/position_, /*count_=*/std::min(available, chunk_size_)};
+}
+
+auto RingRecording::commit(const Chunk& chunk, const uint64_t written) -> bool {
+  // the first sample of the chunk is the oldest one, the writer reaches it first
+  if (overwritten(chunk.position_, written)) {
+    lapped_ = true;
+    return false;
+  }
+
+  position_ = chunk.position_ + chunk.count_;
+  return true;
+}
@@ -0,0 +1,71 @@
+#include <stdexcept>
+
+#include "sample_ring.h"
+
+SampleRing::SampleRing(const std::size_t item_size, const std::size_t capacity, const bool huge_pages)
+    : item_size_(item_size)
+    , samples_(capacity * item_size, huge_pages)
+    , gaps_(kGapCapacity, /*huge_pages=*/false) {
+  if (item_size == 0 || capacity == 0) {
+    throw std::invalid_argument("The sample ring has to hold at least one sample.");
+  }
+}
+
+auto SampleRing::push_pending_gap() noexcept -> void {
+  if (pending_dropped_ == 0) {
+    return;
+  }
+
+  const Gap gap{/*position=*/written_, /*dropped=*/pending_dropped_};
+  if (gaps_.write(&gap, 1) == 1) {
+    pending_dropped_ = 0;
+  }
+}
+
+auto SampleRing::write(const void* samples, const std::size_t count) -> std::size_t {
+  // a gap that did not fit before is recorded before the samples following it
+  push_pending_gap();
+
+  const auto fitting = std::min(count, samples_.space() / item_size_);
+  samples_.write(static_cast<const uint8_t*>(samples), fitting * item_size_);
+  written_ += fitting;
+
+  if (fitting < count) {
+    pending_dropped_ += count - fitting;
+    dropped_.fetch_add(count - fitting, std::memory_order_relaxed);
+    push_pending_gap();
+  }
+
+  const auto fill = size();
+  if (fill > high_water_.load(std::memory_order_relaxed)) {
+    high_water_.store(fill, std::memory_order_relaxed);
+  }
+
+  // the reader waits with a timeout, so a wake up that is lost without holding the mutex only delays it
+  condition_.notify_one();
+  return fitting;
+}
+
+auto SampleRing::read(void* samples, const std::size_t count) noexcept -> std::size_t {
+  return samples_.read(static_cast<uint8_t*>(samples), count * item_size_) / item_size_;
+}
+
+auto SampleRing::pop_gap() noexcept -> std::optional<Gap> {
+  Gap gap;
+  if (gaps_.read(&gap, 1) == 1) {
+    return gap;
+  }
+  return std::nullopt;
+}
+
+auto SampleRing::wait(const std::chrono::milliseconds timeout) -> bool {
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait_for(lock, timeout,
+                      [this] { return samples_.size() != 0 || finished_.load(std::memory_order_acquire); });
+  return samples_.size() != 0;
+}
+
+auto SampleRing::finish() -> void {
+  finished_.store(true, std::memory_order_release);
+  condition_.notify_all();
+}
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cmath>
+
+#include <gnuradio/io_signature.h>
+
+#include "scan_filter.h"
+
+namespace gr::tetra {
+
+ScanFilter::sptr ScanFilter::make(const std::vector<FilterStage>& stages, std::shared_ptr<ScanScheduler> scheduler,
+                                  const std::size_t slot, const unsigned int input_center_frequency,
+                                  const double sample_rate) {
+  return gnuradio::get_initial_sptr(
+      new ScanFilter(stages, std::move(scheduler), slot, input_center_frequency, sample_rate));
+}
+
+ScanFilter::ScanFilter(const std::vector<FilterStage>& stages, std::shared_ptr<ScanScheduler> scheduler,
+                       const std::size_t slot, const unsigned int input_center_frequency, const double sample_rate)
+    : sync_decimator(
+          /*name=*/"ScanFilter",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*decimation=*/total_decimation(stages))
+    , MultistageDecimator(stages, /*center_frequency=*/0, sample_rate)
+    , scheduler_(std::move(scheduler))
+    , slot_(slot)
+    , input_center_frequency_(input_center_frequency)
+    , output_sample_rate_(sample_rate / total_decimation(stages)) {
+  start(scheduler_->first(slot));
+}
+
+auto ScanFilter::start(const ScanScheduler::Dwell& dwell) -> void {
+  if (carrier_ != dwell.carrier_) {
+    carrier_ = dwell.carrier_;
+    set_center_frequency(static_cast<double>(scheduler_->frequency(dwell.carrier_)) - input_center_frequency_);
+    retuned_ = true;
+  }
+
+  // every dwell lasts at least one sample
+  remaining_ = std::max<uint64_t>(1, std::llround(dwell.seconds_ * output_sample_rate_));
+}
+
+auto ScanFilter::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                      gr_vector_void_star& output_items) -> int {
+  const auto* in = (const gr_complex*)input_items[0];
+  auto* out = (gr_complex*)output_items[0];
+
+  // filter up to the end of each dwell and ask for the next one in between
+  int produced = 0;
+  while (produced < noutput_items) {
+    if (retuned_) {
+      add_item_tag(/*which_output=*/0, /*abs_offset=*/nitems_written(0) + produced, /*key=*/kScanFrequencyKey,
+                   /*value=*/pmt::from_double(scheduler_->frequency(*carrier_)));
+      retuned_ = false;
+    }
+
+    const auto count = static_cast<int>(std::min<uint64_t>(remaining_, noutput_items - produced));
+    gr_vector_const_void_star dwell_input = {in + static_cast<std::size_t>(produced) * decimation()};
+    gr_vector_void_star dwell_output = {out + produced};
+    MultistageDecimator::work(count, dwell_input, dwell_output);
+
+    produced += count;
+    remaining_ -= count;
+    if (remaining_ == 0) {
+      start(scheduler_->next(slot_));
+    }
+  }
+
+  return noutput_items;
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cmath>
+
+#include <gnuradio/io_signature.h>
+
+#include "scan_filter.h"
+#include "scan_probe.h"
+
+namespace gr::tetra {
+
+ScanProbe::sptr ScanProbe::make(std::shared_ptr<ScanScheduler> scheduler, const uint64_t interval,
+                                const double threshold) {
+  return gnuradio::get_initial_sptr(new ScanProbe(std::move(scheduler), interval, threshold));
+}
+
+ScanProbe::ScanProbe(std::shared_ptr<ScanScheduler> scheduler, const uint64_t interval, const double threshold)
+    : sync_block(
+          /*name=*/"ScanProbe",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*output_signature=*/io_signature::make(/*min_streams=*/0, /*max_streams=*/0, /*sizeof_stream_items=*/0))
+    , scheduler_(std::move(scheduler))
+    , interval_(interval > 0 ? interval : 1)
+    , threshold_(threshold) {}
+
+auto ScanProbe::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& /*output_items*/) -> int {
+  const auto* in = static_cast<const gr_complex*>(input_items[0]);
+
+  get_tags_in_window(tags_, /*which_input=*/0, /*rel_start=*/0, /*rel_end=*/noutput_items, /*key=*/kScanFrequencyKey);
+  std::sort(tags_.begin(), tags_.end(), [](const tag_t& lhs, const tag_t& rhs) { return lhs.offset < rhs.offset; });
+
+  auto tag = tags_.begin();
+  for (int i = 0; i < noutput_items; i++) {
+    // the symbols from a tag on belong to the carrier of the tag
+    while (tag != tags_.end() && tag->offset <= nitems_read(0) + i) {
+      carrier_ = scheduler_->carrier(static_cast<unsigned int>(std::llround(pmt::to_double(tag->value))));
+      error_.reset();
+      tag++;
+    }
+    if (!carrier_) {
+      continue;
+    }
+
+    error_.add(in[i]);
+    if (error_.count() < interval_) {
+      continue;
+    }
+
+    if (error_.modulation_error_ratio() >= threshold_) {
+      scheduler_->report(*carrier_);
+    }
+    error_.reset();
+  }
+
+  // We only look at the symbols and do not produce any items.
+  return noutput_items;
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "scan_scheduler.h"
+
+ScanScheduler::ScanScheduler(std::vector<unsigned int> frequencies, const std::size_t slots,
+                             const double dwell_seconds, const double max_dwell_seconds)
+    : frequencies_(std::move(frequencies))
+    , dwell_seconds_(dwell_seconds)
+    , max_dwell_seconds_(max_dwell_seconds)
+    , active_(frequencies_.size(), false) {
+  if (slots == 0 || slots > frequencies_.size()) {
+    throw std::invalid_argument("A scan needs at least one slot and at most one slot per frequency.");
+  }
+  if (!(dwell_seconds > 0) || max_dwell_seconds < dwell_seconds) {
+    throw std::invalid_argument("The dwell of a scan has to be positive and at most its maximum dwell.");
+  }
+
+  for (std::size_t carrier = 0; carrier < frequencies_.size(); carrier++) {
+    if (carrier < slots) {
+      carriers_.push_back(carrier);
+      held_seconds_.push_back(dwell_seconds_);
+    } else {
+      queue_.push_back(carrier);
+    }
+  }
+}
+
+auto ScanScheduler::carrier(const unsigned int frequency) const -> std::size_t {
+  const auto it = std::find(frequencies_.begin(), frequencies_.end(), frequency);
+  if (it == frequencies_.end()) {
+    throw std::invalid_argument("The frequency " + std::to_string(frequency) + " is not scanned.");
+  }
+  return it - frequencies_.begin();
+}
+
+auto ScanScheduler::max_revisit_seconds() const noexcept -> double {
+  const auto waiting = static_cast<double>(frequencies_.size() - carriers_.size());
+  return std::ceil(waiting / static_cast<double>(carriers_.size())) * max_dwell_seconds_;
+}
+
+auto ScanScheduler::first(const std::size_t slot) const -> Dwell {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Dwell{/*carrier=*/carriers_.at(slot), /*seconds=*/dwell_seconds_};
+}
+
+auto ScanScheduler::next(const std::size_t slot) -> Dwell {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& carrier = carriers_.at(slot);
+  auto& held_seconds = held_seconds_.at(slot);
+
+  // every carrier has a slot of its own
+  if (queue_.empty()) {
+    return Dwell{carrier, dwell_seconds_};
+  }
+
+  // an active carrier keeps the slot until it held it for the maximum dwell, it has to be reported again during each
+  // further dwell
+  const auto seconds = std::min(dwell_seconds_, max_dwell_seconds_ - held_seconds);
+  const bool active = active_[carrier];
+  active_[carrier] = false;
+  if (active && seconds > 0) {
+    held_seconds += seconds;
+    return Dwell{carrier, seconds};
+  }
+
+  queue_.push_back(carrier);
+  carrier = queue_.front();
+  queue_.pop_front();
+  held_seconds = dwell_seconds_;
+
+  return Dwell{carrier, dwell_seconds_};
+}
+
+auto ScanScheduler::report(const std::size_t carrier) -> void {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // the symbols of a carrier reach the probe after the slot retuned, so reports of carriers that already left their
+  // slot are ignored
+  if (std::find(carriers_.begin(), carriers_.end(), carrier) != carriers_.end()) {
+    active_.at(carrier) = true;
+  }
+}
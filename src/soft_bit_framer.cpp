@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/io_signature.h>
+
+#include "scan_filter.h"
+#include "soft_bit_framer.h"
+
+namespace gr::tetra {
+
+/// The int8 value of a certain one, the soft decisions of the constellation lie between -1 and 1
+static constexpr float kSoftBitScale = 127.0f;
+/// The size of the frames in bytes
+static constexpr std::size_t kFrameSize = udp_frame::kHeaderSize + udp_frame::kSoftBitsPerFrame;
+
+SoftBitFramer::sptr SoftBitFramer::make(gr::digital::constellation_sptr constellation, const unsigned int symbol_rate,
+                                        const unsigned int center_frequency) {
+  return gnuradio::get_initial_sptr(new SoftBitFramer(std::move(constellation), symbol_rate, center_frequency));
+}
+
+SoftBitFramer::SoftBitFramer(gr::digital::constellation_sptr constellation, const unsigned int symbol_rate,
+                             const unsigned int center_frequency)
+    : block(
+          /*name=*/"SoftBitFramer",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/sizeof(gr_complex)),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/kFrameSize))
+    , constellation_(std::move(constellation))
+    , symbols_per_frame_(udp_frame::kSoftBitsPerFrame / constellation_->bits_per_symbol())
+    , splitter_(symbols_per_frame_, center_frequency) {
+  static_assert(kFrameSize <= udp_frame::kMaxFrameSize, "A frame has to fit into one UDP datagram.");
+  if (udp_frame::kSoftBitsPerFrame % constellation_->bits_per_symbol() != 0) {
+    throw std::invalid_argument("The soft bits of a frame are not a whole number of symbols.");
+  }
+
+  header_.payload_type_ = udp_frame::PayloadType::kSoftBits;
+  header_.sample_rate_ = symbol_rate * constellation_->bits_per_symbol();
+  header_.center_frequency_ = center_frequency;
+  set_relative_rate(/*interpolation=*/1, /*decimation=*/symbols_per_frame_);
+}
+
+auto SoftBitFramer::forecast(const int noutput_items, gr_vector_int& ninput_items_required) -> void {
+  // full frames, the frames that end at a retune need fewer symbols
+  ninput_items_required[0] = noutput_items * static_cast<int>(symbols_per_frame_);
+}
+
+auto SoftBitFramer::general_work(const int noutput_items, gr_vector_int& ninput_items,
+                                 gr_vector_const_void_star& input_items, gr_vector_void_star& output_items) -> int {
+  const auto* in = (const gr_complex*)input_items[0];
+  auto* out = (uint8_t*)output_items[0];
+
+  // the carrier a slot of a scan was tuned to changes at the tagged symbols, each tag is read once
+  const auto available = static_cast<std::size_t>(ninput_items[0]);
+  const auto input_end = nitems_read(0) + available;
+  get_tags_in_range(tags_, /*which_input=*/0, /*abs_start=*/std::max(tags_read_, nitems_read(0)), /*abs_end=*/input_end,
+                    /*key=*/kScanFrequencyKey);
+  std::sort(tags_.begin(), tags_.end(), [](const tag_t& lhs, const tag_t& rhs) { return lhs.offset < rhs.offset; });
+  for (const auto& tag : tags_) {
+    splitter_.retune(tag.offset, static_cast<uint32_t>(std::llround(pmt::to_double(tag.value))));
+  }
+  tags_read_ = input_end;
+
+  std::size_t consumed = 0;
+  int produced = 0;
+  for (; produced < noutput_items; produced++) {
+    const auto symbols = splitter_.next(available - consumed);
+    if (!symbols) {
+      break;
+    }
+
+    header_.center_frequency_ = splitter_.center_frequency();
+    header_.item_count_ = static_cast<uint32_t>(*symbols * constellation_->bits_per_symbol());
+    udp_frame::write_header(header_, out);
+    header_.sequence_++;
+
+    auto* payload = (int8_t*)(out + udp_frame::kHeaderSize);
+    for (std::size_t symbol = 0; symbol < *symbols; symbol++) {
+      // the soft decisions are ordered like the bits of unpack_k_bits_bb, positive values are ones
+      for (const auto soft_bit : constellation_->soft_decision_maker(*in++)) {
+        const auto llr = std::clamp(std::round(soft_bit * kSoftBitScale), -kSoftBitScale, kSoftBitScale);
+        *payload++ = static_cast<int8_t>(llr);
+      }
+    }
+    // a frame that ends at a retune is padded with erasures
+    std::fill(payload, (int8_t*)(out + kFrameSize), 0);
+
+    consumed += *symbols;
+    out += kFrameSize;
+  }
+
+  consume_each(static_cast<int>(consumed));
+  return produced;
+}
+
+} // namespace gr::tetra
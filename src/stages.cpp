@@ -0,0 +1,178 @@
+#include <cmath>
+
+#include <gnuradio/analog/feedforward_agc_cc.h>
+#include <gnuradio/blocks/complex_to_mag_squared.h>
+#include <gnuradio/blocks/unpack_k_bits_bb.h>
+#include <gnuradio/digital/cma_equalizer_cc.h>
+#include <gnuradio/digital/constellation.h>
+#include <gnuradio/digital/constellation_decoder_cb.h>
+#include <gnuradio/digital/diff_phasor_cc.h>
+#include <gnuradio/digital/fll_band_edge_cc.h>
+#include <gnuradio/digital/map_bb.h>
+#include <gnuradio/digital/pfb_clock_sync_ccf.h>
+#include <gnuradio/filter/fir_filter_blk.h>
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/filter/freq_xlating_fir_filter.h>
+#include <gnuradio/filter/mmse_resampler_cc.h>
+#include <gnuradio/filter/pfb_arb_resampler_ccf.h>
+
+#include "batch_demodulator.h"
+#include "burst.h"
+#include "burst_demodulator.h"
+#include "config.h"
+#include "integer_xlating_decimator.h"
+#include "multistage.h"
+#include "multistage_decimator.h"
+#include "resampler.h"
+#include "scan_filter.h"
+#include "soft_bit_framer.h"
+#include "stages.h"
+
+namespace stages {
+
+auto channel_filter_taps(const double input_sample_rate, const double cutoff, const double transition_width)
+    -> std::vector<float> {
+  return gr::filter::firdes::low_pass(1, input_sample_rate, cutoff, transition_width);
+}
+
+/// The low pass filters of the cheapest cascade of a multistage decimator
+static auto multistage_filter_stages(const double input_sample_rate, const unsigned int decimation,
+                                     const double cutoff, const double transition_width)
+    -> std::vector<gr::tetra::MultistageDecimator::FilterStage> {
+  std::vector<gr::tetra::MultistageDecimator::FilterStage> filter_stages;
+  for (const auto& stage : multistage::plan(input_sample_rate, decimation, cutoff, transition_width)) {
+    filter_stages.push_back(gr::tetra::MultistageDecimator::FilterStage{
+        /*decimation=*/stage.decimation_,
+        /*taps=*/channel_filter_taps(stage.input_sample_rate_, stage.cutoff_, stage.transition_width_)});
+  }
+  return filter_stages;
+}
+
+auto make_channel_filter(const graph::FilterImplementation implementation, const config::SampleFormat input_format,
+                         const unsigned int decimation, const double cutoff, const double transition_width,
+                         const int offset, const double input_sample_rate) -> gr::block_sptr {
+  switch (implementation) {
+  case graph::FilterImplementation::kIntegerXlatingFir: {
+    // integer samples are filtered with the int16 kernels and only converted to floats at the decimated rate
+    const auto taps = channel_filter_taps(input_sample_rate, cutoff, transition_width);
+    return gr::tetra::IntegerXlatingDecimator::make(input_format, decimation, taps, offset, input_sample_rate);
+  }
+  case graph::FilterImplementation::kFreqXlatingFir: {
+    const auto taps = channel_filter_taps(input_sample_rate, cutoff, transition_width);
+    return gr::filter::freq_xlating_fir_filter_ccf::make(decimation, taps, offset, input_sample_rate);
+  }
+  case graph::FilterImplementation::kMultistage: {
+    // a cascade of short low pass filters, of which only the first one runs at the input rate
+    const auto filter_stages = multistage_filter_stages(input_sample_rate, decimation, cutoff, transition_width);
+    return gr::tetra::MultistageDecimator::make(filter_stages, offset, input_sample_rate);
+  }
+  case graph::FilterImplementation::kUnselected:
+    break;
+  }
+
+  throw std::invalid_argument("The implementation of the channel filter was not selected.");
+}
+
+auto make_scan_filter(std::shared_ptr<ScanScheduler> scheduler, const std::size_t slot, const unsigned int decimation,
+                      const double cutoff, const double transition_width, const unsigned int input_center_frequency,
+                      const double input_sample_rate) -> gr::block_sptr {
+  // the cascade is planned for any decimation, it falls back to a single stage if no cascade is cheaper
+  const auto filter_stages = multistage_filter_stages(input_sample_rate, decimation, cutoff, transition_width);
+  return gr::tetra::ScanFilter::make(filter_stages, std::move(scheduler), slot, input_center_frequency,
+                                     input_sample_rate);
+}
+
+auto make_resampler(const double rate) -> gr::block_sptr {
+  // pass kResamplerPassband of the output bandwidth up to its edge, which Decimate::passband accepts for the streams
+  const auto taps = resampler::taps(kPolyphaseFilters, rate, config::kResamplerPassband);
+  return gr::filter::pfb_arb_resampler_ccf::make(rate, taps, kPolyphaseFilters);
+}
+
+/// The constellation of the differentially decoded TETRA symbols with the soft decision table
+static auto make_constellation() -> gr::digital::constellation_sptr {
+  auto constellation = gr::digital::constellation_dqpsk::make();
+  constellation->gen_soft_dec_lut(8);
+  return constellation;
+}
+
+auto demodulator_stages(const unsigned int samples_per_symbol, const double input_sample_rate) -> DemodulatorStages {
+  const auto sps = samples_per_symbol;
+  const double channel_rate = static_cast<double>(graph::kSymbolRate) * sps;
+  const auto nfilts = kPolyphaseFilters;
+
+  auto rrc_taps =
+      gr::filter::firdes::root_raised_cosine(nfilts, nfilts, 1.0 / static_cast<float>(sps), 0.35, 11 * sps * nfilts);
+
+  DemodulatorStages demodulator;
+  demodulator.frequency_loop_ = gr::digital::fll_band_edge_cc::make(sps, 0.35, 45, M_PI / 100.0f);
+  demodulator.timing_loop_ =
+      gr::digital::pfb_clock_sync_ccf::make(sps, 2 * M_PI / 100.0f, rrc_taps, nfilts, nfilts / 2.0, 1.5, sps);
+  demodulator.loop_sample_rate_ = channel_rate;
+
+  auto& stages = demodulator.stages_;
+  stages = {
+      {"mmse_resampler_cc", gr::filter::mmse_resampler_cc::make(0, input_sample_rate / channel_rate), channel_rate},
+      {"feedforward_agc_cc", gr::analog::feedforward_agc_cc::make(8, 1), channel_rate},
+      {"fll_band_edge_cc", demodulator.frequency_loop_, channel_rate},
+      {"pfb_clock_sync_ccf", demodulator.timing_loop_, channel_rate},
+  };
+
+  // with more than one sample per symbol the equalizer decimates to the symbol rate
+  if (sps > 1) {
+    stages.push_back(
+        {"cma_equalizer_cc", gr::digital::cma_equalizer_cc::make(15, 1, 10e-3, sps), graph::kSymbolRate});
+  }
+  stages.push_back({"diff_phasor_cc", gr::digital::diff_phasor_cc::make(), graph::kSymbolRate});
+
+  return demodulator;
+}
+
+auto make_batch_demodulator(const unsigned int lanes, const double input_sample_rate) -> gr::block_sptr {
+  return gr::tetra::BatchDemodulator::make(lanes, static_cast<unsigned int>(input_sample_rate), graph::kSymbolRate);
+}
+
+auto burst_demodulator_stages(const double input_sample_rate, const unsigned int center_frequency)
+    -> std::vector<Stage> {
+  const auto sps = burst::kSamplesPerSymbol;
+  const double channel_rate = static_cast<double>(graph::kSymbolRate) * sps;
+  auto rrc_taps = gr::filter::firdes::root_raised_cosine(1.0, channel_rate, graph::kSymbolRate, 0.35, 11 * sps + 1);
+
+  return {
+      {"mmse_resampler_cc", gr::filter::mmse_resampler_cc::make(0, input_sample_rate / channel_rate), channel_rate},
+      {"fir_filter_ccf", gr::filter::fir_filter_ccf::make(/*decimation=*/1, rrc_taps), channel_rate},
+      // at most one burst per half timeslot
+      {"burst_demodulator", gr::tetra::BurstDemodulator::make(graph::kSymbolRate, center_frequency),
+       2.0 * graph::kSymbolRate / burst::kSlotSymbols},
+  };
+}
+
+auto bit_decoder_stages() -> std::vector<Stage> {
+  auto constellation = make_constellation();
+
+  return {
+      {"constellation_decoder_cb", gr::digital::constellation_decoder_cb::make(constellation), graph::kSymbolRate},
+      {"map_bb", gr::digital::map_bb::make(constellation->pre_diff_code()), graph::kSymbolRate},
+      {"unpack_k_bits_bb", gr::blocks::unpack_k_bits_bb::make(constellation->bits_per_symbol()),
+       static_cast<double>(graph::kSymbolRate * constellation->bits_per_symbol())},
+  };
+}
+
+auto make_soft_bit_framer(const unsigned int center_frequency) -> gr::block_sptr {
+  return gr::tetra::SoftBitFramer::make(make_constellation(), graph::kSymbolRate, center_frequency);
+}
+
+auto power_meter_stages(const double input_sample_rate) -> std::vector<Stage> {
+  // averaging filter over one second
+  const auto tap_size = static_cast<unsigned int>(input_sample_rate);
+  std::vector<float> averaging_filter(/*count=*/tap_size, /*alloc=*/1.0 / tap_size);
+  // do not decimate directly to the final frequency, since there will be some jitter
+  const unsigned int decimation = tap_size / 10;
+
+  return {
+      {"complex_to_mag_squared", gr::blocks::complex_to_mag_squared::make(), input_sample_rate},
+      {"fir_filter_fff", gr::filter::fir_filter_fff::make(/*decimation=*/decimation, averaging_filter),
+       input_sample_rate / decimation},
+  };
+}
+
+} // namespace stages
@@ -0,0 +1,26 @@
+#include "tag_queue.h"
+
+namespace gr::tetra {
+
+auto TagQueue::push(const std::vector<tag_t>& tags) -> void {
+  if (tags.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  tags_.insert(tags_.end(), tags.begin(), tags.end());
+}
+
+auto TagQueue::pop(const uint64_t end) -> std::vector<tag_t> {
+  std::vector<tag_t> tags;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!tags_.empty() && tags_.front().offset < end) {
+    tags.push_back(std::move(tags_.front()));
+    tags_.pop_front();
+  }
+
+  return tags;
+}
+
+} // namespace gr::tetra
@@ -1,27 +1,20 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
 
 #include <cxxopts.hpp>
-#include <gnuradio/analog/feedforward_agc_cc.h>
-#include <gnuradio/blocks/complex_to_mag_squared.h>
+#include <gnuradio/blocks/file_source.h>
 #include <gnuradio/blocks/null_sink.h>
 #include <gnuradio/blocks/udp_sink.h>
-#include <gnuradio/blocks/unpack_k_bits_bb.h>
 #include <gnuradio/constants.h>
-#include <gnuradio/digital/cma_equalizer_cc.h>
-#include <gnuradio/digital/constellation.h>
-#include <gnuradio/digital/constellation_decoder_cb.h>
-#include <gnuradio/digital/diff_phasor_cc.h>
-#include <gnuradio/digital/fll_band_edge_cc.h>
-#include <gnuradio/digital/map_bb.h>
-#include <gnuradio/digital/pfb_clock_sync_ccf.h>
-#include <gnuradio/filter/fir_filter_blk.h>
-#include <gnuradio/filter/firdes.h>
-#include <gnuradio/filter/freq_xlating_fir_filter.h>
-#include <gnuradio/filter/mmse_resampler_cc.h>
 #include <gnuradio/logger.h>
 #include <gnuradio/prefs.h>
 #include <gnuradio/sys_paths.h>
@@ -29,8 +22,25 @@
 #include <osmosdr/source.h>
 
 #include "config.h"
+#include "graph.h"
+#include "iq_deframer.h"
+#include "iq_framer.h"
+#include "iq_ring_recorder.h"
+#include "native_to_complex.h"
 #include "prometheus.h"
 #include "prometheus_gauge_populator.h"
+#include "prometheus_gauge_reducer.h"
+#include "prometheus_histogram_populator.h"
+#include "quality_probe.h"
+#include "ring_buffer_sink.h"
+#include "ring_buffer_source.h"
+#include "sample_ring.h"
+#include "scan_probe.h"
+#include "scan_scheduler.h"
+#include "stages.h"
+#include "tag_queue.h"
+#include "timestamp_tagger.h"
+#include "udp_frame.h"
 
 static auto print_gnuradio_diagnostics() -> void {
   const auto ver = gr::version();
@@ -44,145 +54,470 @@ static auto print_gnuradio_diagnostics() -> void {
             << "\n\n Compiler Flags: " << compiler_flags << "\n\n";
 }
 
+/// The duration of samples each block may buffer on its output in the low latency profile
+static constexpr double kLowLatencyBufferSeconds = 0.005;
+/// The minimum number of items each block may buffer on its output in the low latency profile
+static constexpr int kLowLatencyMinimumItems = 64;
+/// The maximum number of items a block produces per call in the low latency profile
+static constexpr int kLowLatencyMaxNoutputItems = 4096;
+/// The maximum number of items a block produces per call by default in gnuradio
+static constexpr int kDefaultMaxNoutputItems = 100000000;
+/// The duration of samples a bridge between two partitions holds before it drops samples
+static constexpr double kBridgeSeconds = 0.5;
+/// The time the source of a bridge waits for samples before the thread of its partition runs the other blocks
+static constexpr std::chrono::milliseconds kBridgeReadTimeout(1);
+/// The number of values per second of the gauges of the quality of the demodulation
+static constexpr double kQualityUpdatesPerSecond = 4;
+/// The smallest modulation error ratio in dB of the symbols of a carrier of a scan that extends its dwell. Noise
+/// without a carrier is at about 2.4 dB.
+static constexpr double kScanActivityThreshold = 10;
+
 class ApplicationData {
 public:
-  /// The gnuradio top block
+  /// The gnuradio top block the blocks of the node that is built are connected in
   gr::top_block_sptr tb = nullptr;
+  /// The top block of each partition of the graph, which all run at the same time. There is only one without the
+  /// thread pool.
+  std::vector<gr::top_block_sptr> top_blocks;
   /// the optional prometheus exporter
   std::shared_ptr<PrometheusExporter> exporter = nullptr;
+  /// true if the buffers of each block should be bounded to the low latency profile
+  bool low_latency = false;
+  /// the maximum number of items a block may produce per call
+  int max_noutput_items = kDefaultMaxNoutputItems;
+  /// the scheduler of each scan, shared by the filters and the probes of its slots
+  std::map<std::size_t, std::shared_ptr<ScanScheduler>> scan_schedulers;
 };
 
+/// Build the optimized graph of the config, which is partitioned into one partition per core for the thread pool
+static auto build_graph(const config::TopLevel& top) -> graph::Graph {
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  if (top.thread_pool_) {
+    // the number of cores is zero if it is not known
+    graph::partition(graph, std::max(1U, std::thread::hardware_concurrency()));
+  }
+
+  return graph;
+}
+
 class GnuradioBuilder {
 private:
-  static auto from_config(const config::Stream& stream, ApplicationData& app_data, gr::basic_block_sptr input) -> void {
-    auto& tb = app_data.tb;
-
-    auto decimation = stream.decimation_;
-    auto offset = static_cast<int>(stream.spectrum_.center_frequency_) -
-                  static_cast<int>(stream.input_spectrum_.center_frequency_);
-    auto sample_rate = stream.input_spectrum_.sample_rate_;
-
-    float half_sample_rate = stream.spectrum_.sample_rate_ / 2;
-    auto xlat_taps =
-        gr::filter::firdes::low_pass(1, stream.input_spectrum_.sample_rate_, half_sample_rate, half_sample_rate * 0.2);
-    auto xlat = gr::filter::freq_xlating_fir_filter_ccf::make(decimation, xlat_taps, offset,
-                                                              stream.input_spectrum_.sample_rate_);
-
-    if (stream.send_iq_) {
-      auto channel_rate = 18000;
-      auto sps = 1;
-      auto nfilts = 32;
-
-      auto rrc_taps =
-          gr::filter::firdes::root_raised_cosine(nfilts, nfilts, 1.0 / static_cast<float>(sps), 0.35, 11 * sps * nfilts);
-
-      auto mmse_resampler_cc = gr::filter::mmse_resampler_cc::make(
-          0, static_cast<float>(sample_rate) / (static_cast<float>(decimation) * static_cast<float>(channel_rate)));
-      auto agc = gr::analog::feedforward_agc_cc::make(8, 1);
-      auto digital_fll_band_edge_cc = gr::digital::fll_band_edge_cc::make(sps, 0.35, 45, M_PI / 100.0f);
-      auto digital_pfb_clock_sync_xxx =
-          gr::digital::pfb_clock_sync_ccf::make(sps, 2 * M_PI / 100.0f, rrc_taps, nfilts, nfilts / 2.0, 1.5, sps);
-      auto diff_phasor_cc = gr::digital::diff_phasor_cc::make();
-
-      tb->connect(input, 0, xlat, 0);
-      tb->connect(xlat, 0, mmse_resampler_cc, 0);
-      tb->connect(mmse_resampler_cc, 0, agc, 0);
-      tb->connect(agc, 0, digital_fll_band_edge_cc, 0);
-      tb->connect(digital_fll_band_edge_cc, 0, digital_pfb_clock_sync_xxx, 0);
-      tb->connect(digital_pfb_clock_sync_xxx, 0, diff_phasor_cc, 0);
-
-      auto blocks_udp_sink = gr::blocks::udp_sink::make(sizeof(gr_complex), stream.host_, stream.port_, 1472, false);
-
-      tb->connect(diff_phasor_cc, 0, blocks_udp_sink, 0);
-    } else {
-      auto channel_rate = 36000;
-      auto sps = 2;
-      auto nfilts = 32;
-
-      auto rrc_taps =
-          gr::filter::firdes::root_raised_cosine(nfilts, nfilts, 1.0 / static_cast<float>(sps), 0.35, 11 * sps * nfilts);
-
-      auto mmse_resampler_cc = gr::filter::mmse_resampler_cc::make(
-          0, static_cast<float>(sample_rate) / (static_cast<float>(decimation) * static_cast<float>(channel_rate)));
-      auto agc = gr::analog::feedforward_agc_cc::make(8, 1);
-      auto digital_fll_band_edge_cc = gr::digital::fll_band_edge_cc::make(sps, 0.35, 45, M_PI / 100.0f);
-      auto digital_pfb_clock_sync_xxx =
-          gr::digital::pfb_clock_sync_ccf::make(sps, 2 * M_PI / 100.0f, rrc_taps, nfilts, nfilts / 2.0, 1.5, sps);
-      auto digital_cma_equalizer_cc = gr::digital::cma_equalizer_cc::make(15, 1, 10e-3, sps);
-      auto diff_phasor_cc = gr::digital::diff_phasor_cc::make();
-
-      tb->connect(input, 0, xlat, 0);
-      tb->connect(xlat, 0, mmse_resampler_cc, 0);
-      tb->connect(mmse_resampler_cc, 0, agc, 0);
-      tb->connect(agc, 0, digital_fll_band_edge_cc, 0);
-      tb->connect(digital_fll_band_edge_cc, 0, digital_pfb_clock_sync_xxx, 0);
-      tb->connect(digital_pfb_clock_sync_xxx, 0, digital_cma_equalizer_cc, 0);
-      tb->connect(digital_cma_equalizer_cc, 0, diff_phasor_cc, 0);
-
-      auto constellation = gr::digital::constellation_dqpsk::make();
-      constellation->gen_soft_dec_lut(8);
-
-      auto digital_constellation_decoder_cb = gr::digital::constellation_decoder_cb::make(constellation);
-      auto digital_map_bb = gr::digital::map_bb::make(constellation->pre_diff_code());
-      auto blocks_unpack_k_bits_bb = gr::blocks::unpack_k_bits_bb::make(constellation->bits_per_symbol());
-      auto blocks_udp_sink = gr::blocks::udp_sink::make(sizeof(char), stream.host_, stream.port_, 1472, false);
-
-      tb->connect(diff_phasor_cc, 0, digital_constellation_decoder_cb, 0);
-      tb->connect(digital_constellation_decoder_cb, 0, digital_map_bb, 0);
-      tb->connect(digital_map_bb, 0, blocks_unpack_k_bits_bb, 0);
-      tb->connect(blocks_unpack_k_bits_bb, 0, blocks_udp_sink, 0);
+  /// The first block of a node, to which the inputs of the node are connected, and the last block of a node, which
+  /// provides the outputs of the node
+  using Blocks = std::pair<gr::basic_block_sptr, gr::basic_block_sptr>;
+
+  /// Shrink the output buffer and the number of items per call of a block to hold only a few milliseconds of samples
+  /// if the low latency profile is selected.
+  /// \param app_data the application data holding the latency profile
+  /// \param block the block which buffers should be bounded
+  /// \param sample_rate the sample rate at the output of the block
+  static auto bound_latency(const ApplicationData& app_data, const gr::block_sptr& block, const double sample_rate)
+      -> void {
+    if (!app_data.low_latency)
+      return;
+
+    const int items = std::max(kLowLatencyMinimumItems, static_cast<int>(sample_rate * kLowLatencyBufferSeconds));
+    block->set_max_noutput_items(items);
+    block->set_max_output_buffer(2 * items);
+  };
+
+  static auto make_blocks(const graph::Source& source, const graph::Node& node, const graph::Graph& /*graph*/,
+                          ApplicationData& /*app_data*/) -> Blocks {
+    if (source.input_port_) {
+      // receive the samples exported by another tetra-receiver
+      auto src = gr::tetra::IqDeframer::make(*source.input_port_, static_cast<unsigned int>(node.sample_rate_),
+                                             node.center_frequency_);
+      src->set_block_alias("src");
+
+      return {src, src};
+    }
+
+    if (source.input_file_.empty()) {
+      // setup osmosdr source
+      auto src = osmosdr::source::make(source.device_string_);
+      src->set_block_alias("src");
+
+      src->set_sample_rate(node.sample_rate_);
+      src->set_center_freq(node.center_frequency_);
+      src->set_gain_mode(false, 0);
+      src->set_gain(source.rf_gain_, "RF", 0);
+      src->set_gain(source.if_gain_, "IF", 0);
+      src->set_gain(source.bb_gain_, "BB", 0);
+      src->set_bandwidth(node.sample_rate_ / 2, 0);
+
+      return {src, src};
     }
 
-    // create blocks to save the power of the current channel if prometheus exporter is available
+    // setup the file source with samples in the native format of the SDR
+    auto src = gr::blocks::file_source::make(node.item_size_, source.input_file_.c_str(), /*repeat=*/false);
+    src->set_block_alias("src");
+
+    return {src, src};
+  };
+
+  static auto make_blocks(const graph::RingBuffer& ring_buffer, const graph::Node& node, const graph::Graph& /*graph*/,
+                          ApplicationData& app_data) -> Blocks {
+    const auto capacity = static_cast<std::size_t>(ring_buffer.seconds_ * node.sample_rate_);
+    auto ring = std::make_shared<SampleRing>(node.item_size_, capacity, ring_buffer.huge_pages_);
+
+    std::optional<gr::tetra::RingBufferMetrics> metrics;
     if (app_data.exporter) {
-      auto& signal_strength = app_data.exporter->signal_strength();
-      auto& stream_signal_strength = signal_strength.Add(
-          {{"frequency", std::to_string(stream.spectrum_.center_frequency_)}, {"name", stream.name_}});
-
-      auto mag_squared = gr::blocks::complex_to_mag_squared::make();
-      // averaging filter over one second
-      unsigned tap_size = stream.spectrum_.sample_rate_;
-      std::vector<float> averaging_filter(/*count=*/tap_size, /*alloc=*/1.0 / tap_size);
-      // do not decimate directly to the final frequency, since there will be some jitter
-      unsigned decimation = tap_size / 10;
-      auto fir = gr::filter::fir_filter_fff::make(/*decimation=*/decimation, averaging_filter);
-      auto populator = gr::prometheus::PrometheusGaugePopulator::make(/*gauge=*/stream_signal_strength);
-
-      tb->connect(xlat, 0, mag_squared, 0);
-      tb->connect(mag_squared, 0, fir, 0);
-      tb->connect(fir, 0, populator, 0);
+      const prometheus::Labels labels = {{"name", node.name_}};
+      metrics.emplace(gr::tetra::RingBufferMetrics{
+          /*fill=*/app_data.exporter->ring_buffer_fill().Add(labels),
+          /*high_water=*/app_data.exporter->ring_buffer_high_water().Add(labels),
+          /*dropped=*/app_data.exporter->ring_buffer_dropped().Add(labels)});
     }
+
+    // the sink and the source run in separate threads, so a stall after the source only fills the ring
+    auto tags = std::make_shared<gr::tetra::TagQueue>();
+    auto sink = gr::tetra::RingBufferSink::make(ring, tags);
+    auto source = gr::tetra::RingBufferSource::make(ring, tags, node.sample_rate_, metrics);
+    bound_latency(app_data, source, node.sample_rate_);
+
+    return {sink, source};
   };
 
-  static auto from_config(const config::Decimate& decimate, ApplicationData& app_data, gr::basic_block_sptr input)
-      -> void {
-    auto& tb = app_data.tb;
+  static auto make_blocks(const graph::TimestampTagger& tagger, const graph::Node& node,
+                          const graph::Graph& /*graph*/, ApplicationData& app_data) -> Blocks {
+    auto block = gr::tetra::TimestampTagger::make(/*item_size=*/node.item_size_, /*interval=*/tagger.interval_);
+    bound_latency(app_data, block, node.sample_rate_);
+
+    return {block, block};
+  };
+
+  static auto make_blocks(const graph::NativeToComplex& /*converter*/, const graph::Node& node,
+                          const graph::Graph& graph, ApplicationData& app_data) -> Blocks {
+    const auto& input = graph.nodes_.at(node.inputs_.at(0).node_);
+    auto block = gr::tetra::NativeToComplex::make(*input.sample_format_);
+    bound_latency(app_data, block, node.sample_rate_);
+
+    return {block, block};
+  };
+
+  /// Bound the latency of the stages and connect them in a chain
+  static auto connect_stages(ApplicationData& app_data, const std::vector<stages::Stage>& stages) -> Blocks {
+    for (const auto& stage : stages) {
+      bound_latency(app_data, stage.block_, stage.output_sample_rate_);
+    }
+    for (std::size_t i = 1; i < stages.size(); i++) {
+      app_data.tb->connect(stages[i - 1].block_, 0, stages[i].block_, 0);
+    }
+
+    return {stages.front().block_, stages.back().block_};
+  };
+
+  static auto make_blocks(const graph::ChannelFilter& filter, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& app_data) -> Blocks {
+    const auto& input = graph.nodes_.at(node.inputs_.at(0).node_);
+    if (filter.implementation_ == graph::FilterImplementation::kUnselected) {
+      throw std::invalid_argument("The implementation of the filter " + node.name_ + " was not selected.");
+    }
+    auto xlat = stages::make_channel_filter(filter.implementation_, *input.sample_format_, filter.decimation_,
+                                            filter.cutoff_, filter.transition_width_, filter.offset_,
+                                            input.sample_rate_);
+    bound_latency(app_data, xlat, node.sample_rate_);
+
+    return {xlat, xlat};
+  };
+
+  static auto make_blocks(const graph::ScanFilter& filter, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& app_data) -> Blocks {
+    const auto& input = graph.nodes_.at(node.inputs_.at(0).node_);
+    const auto& scan = filter.scan_;
+
+    // the first slot of a scan creates the scheduler the other slots share
+    auto& scheduler = app_data.scan_schedulers[filter.scan_id_];
+    if (!scheduler) {
+      scheduler = std::make_shared<ScanScheduler>(scan.frequencies_, scan.slots_, scan.dwell_seconds_,
+                                                  scan.max_dwell_seconds_);
+    }
+
+    auto block = stages::make_scan_filter(scheduler, filter.slot_, scan.decimation_, filter.cutoff_,
+                                          filter.transition_width_, input.center_frequency_, input.sample_rate_);
+    bound_latency(app_data, block, node.sample_rate_);
+
+    return {block, block};
+  };
+
+  static auto make_blocks(const graph::Resampler& resampler, const graph::Node& node, const graph::Graph& /*graph*/,
+                          ApplicationData& app_data) -> Blocks {
+    auto block = stages::make_resampler(resampler.rate_);
+    bound_latency(app_data, block, node.sample_rate_);
+
+    return {block, block};
+  };
+
+  /// Connect one output with the state of a loop of the demodulator to its probe and the other outputs with its state
+  /// to null sinks. The loop only writes its state if all stages::kLoopOutputs outputs are connected.
+  /// \param loop the loop of the demodulator
+  /// \param port the output of the loop that is exported
+  /// \param probe the block that exports the state
+  /// \param app_data the application data holding the top block
+  static auto connect_loop_probe(const gr::block_sptr& loop, const int port, const gr::block_sptr& probe,
+                                 ApplicationData& app_data) -> void {
+    if (loop->output_signature()->max_streams() != stages::kLoopOutputs) {
+      throw std::invalid_argument("The loop " + loop->name() + " does not have " +
+                                  std::to_string(stages::kLoopOutputs) + " outputs.");
+    }
+
+    for (int output = 1; output < stages::kLoopOutputs; output++) {
+      if (output == port) {
+        app_data.tb->connect(loop, output, probe, 0);
+      } else {
+        app_data.tb->connect(loop, output, gr::blocks::null_sink::make(/*sizeof_stream_item=*/sizeof(float)), 0);
+      }
+    }
+  };
+
+  /// Export the state of the loops of the demodulator
+  /// \param demodulator the stages and the loops of the demodulator
+  /// \param node the demodulator node
+  /// \param app_data the application data holding the prometheus exporter
+  static auto connect_loop_probes(const stages::DemodulatorStages& demodulator, const graph::Node& node,
+                                  ApplicationData& app_data) -> void {
+    const prometheus::Labels labels = {{"frequency", std::to_string(node.center_frequency_)}, {"name", node.name_}};
+    const auto interval = static_cast<uint64_t>(demodulator.loop_sample_rate_ / kQualityUpdatesPerSecond);
+
+    // the loop turns the carrier by its frequency in radians per sample, which is the negative offset
+    auto frequency_offset = gr::prometheus::PrometheusGaugeReducer::make(
+        /*gauge=*/app_data.exporter->frequency_offset().Add(labels),
+        /*reduction=*/gr::prometheus::PrometheusGaugeReducer::Reduction::kMean,
+        /*scale=*/-demodulator.loop_sample_rate_ / (2 * M_PI), interval);
+    connect_loop_probe(demodulator.frequency_loop_, stages::kFrequencyLoopFrequencyPort, frequency_offset, app_data);
+
+    auto timing_error = gr::prometheus::PrometheusGaugeReducer::make(
+        /*gauge=*/app_data.exporter->timing_error().Add(labels),
+        /*reduction=*/gr::prometheus::PrometheusGaugeReducer::Reduction::kRootMeanSquare, /*scale=*/1, interval);
+    connect_loop_probe(demodulator.timing_loop_, stages::kTimingLoopErrorPort, timing_error, app_data);
+  };
+
+  static auto make_blocks(const graph::Demodulator& demodulator, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& app_data) -> Blocks {
+    const auto input_sample_rate = graph.nodes_.at(node.inputs_.at(0).node_).sample_rate_;
+    const auto stages = stages::demodulator_stages(demodulator.samples_per_symbol_, input_sample_rate);
+
+    if (app_data.exporter) {
+      connect_loop_probes(stages, node, app_data);
+    }
+
+    return connect_stages(app_data, stages.stages_);
+  };
+
+  static auto make_blocks(const graph::BatchDemodulator& demodulator, const graph::Node& node,
+                          const graph::Graph& graph, ApplicationData& app_data) -> Blocks {
+    const auto input_sample_rate = graph.nodes_.at(node.inputs_.at(0).node_).sample_rate_;
+    auto block = stages::make_batch_demodulator(demodulator.lanes_, input_sample_rate);
+    bound_latency(app_data, block, node.sample_rate_);
 
-    float half_sample_rate = decimate.spectrum_.sample_rate_ / 2;
-    auto offset = static_cast<int>(decimate.spectrum_.center_frequency_) -
-                  static_cast<int>(decimate.input_spectrum_.center_frequency_);
-    auto xlat_taps = gr::filter::firdes::low_pass(1, decimate.input_spectrum_.sample_rate_, half_sample_rate,
-                                                  half_sample_rate * 0.2);
-    auto xlat = gr::filter::freq_xlating_fir_filter_ccf::make(decimate.decimation_, xlat_taps, offset,
-                                                              decimate.input_spectrum_.sample_rate_);
+    return {block, block};
+  };
+
+  static auto make_blocks(const graph::BurstDemodulator& /*demodulator*/, const graph::Node& node,
+                          const graph::Graph& graph, ApplicationData& app_data) -> Blocks {
+    const auto input_sample_rate = graph.nodes_.at(node.inputs_.at(0).node_).sample_rate_;
+
+    return connect_stages(app_data, stages::burst_demodulator_stages(input_sample_rate, node.center_frequency_));
+  };
+
+  static auto make_blocks(const graph::BitDecoder& /*decoder*/, const graph::Node& /*node*/,
+                          const graph::Graph& /*graph*/, ApplicationData& app_data) -> Blocks {
+    return connect_stages(app_data, stages::bit_decoder_stages());
+  };
+
+  static auto make_blocks(const graph::SoftBitFramer& /*framer*/, const graph::Node& node,
+                          const graph::Graph& /*graph*/, ApplicationData& app_data) -> Blocks {
+    auto block = stages::make_soft_bit_framer(node.center_frequency_);
+    bound_latency(app_data, block, node.sample_rate_);
+
+    return {block, block};
+  };
+
+  static auto make_blocks(const graph::IqFramer& /*framer*/, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& app_data) -> Blocks {
+    const auto input_sample_rate = graph.nodes_.at(node.inputs_.at(0).node_).sample_rate_;
+    auto block = gr::tetra::IqFramer::make(static_cast<unsigned int>(input_sample_rate), node.center_frequency_);
+    bound_latency(app_data, block, node.sample_rate_);
+
+    return {block, block};
+  };
+
+  static auto make_blocks(const graph::UdpSink& sink, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& /*app_data*/) -> Blocks {
+    const auto item_size = graph.nodes_.at(node.inputs_.at(0).node_).item_size_;
+    const auto payload_size = static_cast<int>(graph::datagram_size(graph, node));
+    auto block = gr::blocks::udp_sink::make(item_size, sink.host_, sink.port_, payload_size, false);
+
+    return {block, block};
+  };
+
+  static auto make_blocks(const graph::PowerProbe& /*probe*/, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& app_data) -> Blocks {
+    // save the power of the current channel in prometheus
+    auto& signal_strength = app_data.exporter->signal_strength();
+    auto& stream_signal_strength =
+        signal_strength.Add({{"frequency", std::to_string(node.center_frequency_)}, {"name", node.name_}});
+
+    const auto input_sample_rate = graph.nodes_.at(node.inputs_.at(0).node_).sample_rate_;
+    auto power_meter = connect_stages(app_data, stages::power_meter_stages(input_sample_rate));
+    auto populator = gr::prometheus::PrometheusGaugePopulator::make(/*gauge=*/stream_signal_strength);
+
+    app_data.tb->connect(power_meter.second, 0, populator, 0);
+
+    return {power_meter.first, populator};
+  };
+
+  static auto make_blocks(const graph::LatencyProbe& /*probe*/, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& app_data) -> Blocks {
+    // observe the latency between the source and the end of the chain
+    auto& latency = app_data.exporter->latency();
+    auto& stream_latency = latency.Add(
+        {{"frequency", std::to_string(node.center_frequency_)}, {"name", node.name_}}, kLatencyBucketBoundaries);
+    auto populator = gr::prometheus::PrometheusHistogramPopulator::make(
+        /*histogram=*/stream_latency, /*item_size=*/graph.nodes_.at(node.inputs_.at(0).node_).item_size_);
+
+    return {populator, populator};
+  };
+
+  static auto make_blocks(const graph::QualityProbe& /*probe*/, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& app_data) -> Blocks {
+    // measure the constellation of the differentially decoded symbols a few times per second
+    const prometheus::Labels labels = {{"frequency", std::to_string(node.center_frequency_)}, {"name", node.name_}};
+    const auto input_sample_rate = graph.nodes_.at(node.inputs_.at(0).node_).sample_rate_;
+    auto probe = gr::tetra::QualityProbe::make(
+        gr::tetra::QualityMetrics{
+            /*error_vector_magnitude=*/app_data.exporter->error_vector_magnitude().Add(labels),
+            /*modulation_error_ratio=*/app_data.exporter->modulation_error_ratio().Add(labels),
+            /*signal_to_noise_ratio=*/app_data.exporter->signal_to_noise_ratio().Add(labels)},
+        /*interval=*/static_cast<uint64_t>(input_sample_rate / kQualityUpdatesPerSecond));
+
+    return {probe, probe};
+  };
+
+  static auto make_blocks(const graph::ScanProbe& probe, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& app_data) -> Blocks {
+    // the filters of the slots come before their probes
+    const auto& scheduler = app_data.scan_schedulers.at(probe.scan_id_);
+    const auto input_sample_rate = graph.nodes_.at(node.inputs_.at(0).node_).sample_rate_;
+    auto block = gr::tetra::ScanProbe::make(
+        scheduler, /*interval=*/static_cast<uint64_t>(input_sample_rate / kQualityUpdatesPerSecond),
+        /*threshold=*/kScanActivityThreshold);
+
+    return {block, block};
+  };
+
+  static auto make_blocks(const graph::Recorder& recorder, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& app_data) -> Blocks {
+    const auto& config = recorder.recorder_;
+    const auto& input = graph.nodes_.at(node.inputs_.at(0).node_);
+
+    std::optional<std::reference_wrapper<prometheus::Counter>> dropped;
+    if (app_data.exporter) {
+      dropped = app_data.exporter->recorder_dropped().Add({{"name", node.name_}});
+    }
+
+    auto iq_ring_recorder = gr::tetra::IqRingRecorder::make(
+        node.name_, input.sample_rate_, node.center_frequency_, config.pre_trigger_seconds_,
+        config.post_trigger_seconds_, config.directory_, config.power_threshold_, config.huge_pages_, dropped);
+
+    return {iq_ring_recorder, iq_ring_recorder};
+  };
 
-    tb->connect(input, 0, xlat, 0);
+  static auto make_blocks(const graph::NullSink& /*sink*/, const graph::Node& node, const graph::Graph& graph,
+                          ApplicationData& /*app_data*/) -> Blocks {
+    const auto item_size = graph.nodes_.at(node.inputs_.at(0).node_).item_size_;
+    auto null_sink = gr::blocks::null_sink::make(/*sizeof_stream_item=*/item_size);
 
-    for (auto const& stream : decimate.streams_) {
-      from_config(stream, app_data, xlat);
+    return {null_sink, null_sink};
+  };
+
+  /// Make a bridge that carries the samples and the tags of an output of a node to another partition. The sink of the
+  /// bridge runs in the thread of the producer and never blocks it, the source runs in the thread of the consumer.
+  /// \param producer the node of the output
+  /// \param output the block that provides the output
+  /// \param index the index of the output
+  /// \param partition the partition of the consumer
+  /// \param app_data the application data holding the top blocks
+  /// \return the source of the bridge in the partition of the consumer
+  static auto make_bridge(const graph::Node& producer, const gr::basic_block_sptr& output, const unsigned int index,
+                          const std::size_t partition, ApplicationData& app_data) -> gr::basic_block_sptr {
+    const auto capacity = static_cast<std::size_t>(kBridgeSeconds * producer.sample_rate_);
+    auto ring = std::make_shared<SampleRing>(producer.item_size_, capacity, /*huge_pages=*/false);
+    auto tags = std::make_shared<gr::tetra::TagQueue>();
+
+    // the backlog of the bridge is the time the samples wait for the thread of the consumer
+    std::optional<gr::tetra::RingBufferMetrics> metrics;
+    if (app_data.exporter) {
+      const prometheus::Labels labels = {{"name", producer.name_}, {"partition", std::to_string(partition)}};
+      metrics.emplace(gr::tetra::RingBufferMetrics{
+          /*fill=*/app_data.exporter->bridge_backlog().Add(labels),
+          /*high_water=*/app_data.exporter->bridge_backlog_high_water().Add(labels),
+          /*dropped=*/app_data.exporter->bridge_dropped().Add(labels)});
     }
 
-    // add a null sink to have at least one connected
-    auto null_sink = gr::blocks::null_sink::make(/*sizeof_stream_item=*/sizeof(gr_complex));
-    tb->connect(xlat, 0, null_sink, 0);
+    auto sink = gr::tetra::RingBufferSink::make(ring, tags);
+    auto source =
+        gr::tetra::RingBufferSource::make(ring, tags, producer.sample_rate_, metrics, kBridgeReadTimeout);
+    bound_latency(app_data, source, producer.sample_rate_);
+
+    app_data.top_blocks.at(producer.partition_.value_or(0))->connect(output, index, sink, 0);
+    return source;
   };
 
 public:
+  /// Instantiate the gnuradio blocks of each node of the graph and connect them. The blocks of each node are connected
+  /// in the top block of its partition and the outputs that are consumed in other partitions are bridged.
+  static auto from_graph(const graph::Graph& graph, ApplicationData& app_data) -> void {
+    // the blocks of each node, the inputs of a node always come before it
+    std::vector<Blocks> blocks;
+    blocks.reserve(graph.nodes_.size());
+    // the source of the bridge of each output port to each other partition
+    std::map<std::tuple<graph::NodeId, unsigned int, std::size_t>, gr::basic_block_sptr> bridges;
+
+    for (const auto& node : graph.nodes_) {
+      const auto partition = node.partition_.value_or(0);
+      app_data.tb = app_data.top_blocks.at(partition);
+
+      const auto node_blocks = std::visit(
+          [&node, &graph, &app_data](const auto& data) { return make_blocks(data, node, graph, app_data); },
+          node.data_);
+
+      for (unsigned int i = 0; i < node.inputs_.size(); i++) {
+        const auto& input = node.inputs_[i];
+        const auto& producer = graph.nodes_.at(input.node_);
+        if (producer.partition_.value_or(0) == partition) {
+          app_data.tb->connect(blocks.at(input.node_).second, input.index_, node_blocks.first, i);
+          continue;
+        }
+
+        // the sink of a ring buffer never blocks, so it is written in the thread of its input like a bridge
+        if (std::holds_alternative<graph::RingBuffer>(node.data_)) {
+          app_data.top_blocks.at(producer.partition_.value_or(0))
+              ->connect(blocks.at(input.node_).second, input.index_, node_blocks.first, i);
+          continue;
+        }
+
+        const auto key = std::make_tuple(input.node_, input.index_, partition);
+        if (bridges.count(key) == 0) {
+          bridges[key] = make_bridge(producer, blocks.at(input.node_).second, input.index_, partition, app_data);
+        }
+        app_data.tb->connect(bridges[key], 0, node_blocks.first, i);
+      }
+
+      blocks.push_back(node_blocks);
+    }
+  };
+
   static auto from_config(const config::TopLevel& top) -> ApplicationData {
     ApplicationData app_data;
-    auto& tb = app_data.tb;
 
-    tb = gr::make_top_block("fg");
+    // setup the latency profile
+    app_data.low_latency = top.low_latency_;
+    if (top.low_latency_) {
+      app_data.max_noutput_items = kLowLatencyMaxNoutputItems;
+    }
 
     // setup prometheus exporter
     if (top.prometheus_) {
@@ -190,28 +525,25 @@ public:
       app_data.exporter = std::make_shared<PrometheusExporter>(prometheus_addr);
     }
 
-    // setup osmosdr source
-    auto src = osmosdr::source::make(top.device_string_);
-    src->set_block_alias("src");
-
-    src->set_sample_rate(top.spectrum_.sample_rate_);
-    src->set_center_freq(top.spectrum_.center_frequency_);
-    src->set_gain_mode(false, 0);
-    src->set_gain(top.rf_gain_, "RF", 0);
-    src->set_gain(top.if_gain_, "IF", 0);
-    src->set_gain(top.bb_gain_, "BB", 0);
-    src->set_bandwidth(top.spectrum_.sample_rate_ / 2, 0);
+    const auto graph = build_graph(top);
 
-    for (auto const& decimate : top.decimators_) {
-      from_config(decimate, app_data, src);
+    // the thread pool runs each partition with the single threaded scheduler of gnuradio, i.e. in one thread, instead
+    // of one thread per block
+    std::size_t partitions = 1;
+    if (top.thread_pool_) {
+      setenv("GR_SCHEDULER", "STS", /*overwrite=*/1);
+      for (const auto& node : graph.nodes_) {
+        partitions = std::max(partitions, *node.partition_ + 1);
+      }
+      if (app_data.exporter) {
+        app_data.exporter->scheduler_threads().Add({}).Set(static_cast<double>(partitions));
+      }
     }
-    for (auto const& stream : top.streams_) {
-      from_config(stream, app_data, src);
+    for (std::size_t partition = 0; partition < partitions; partition++) {
+      app_data.top_blocks.push_back(gr::make_top_block("fg" + std::to_string(partition)));
     }
 
-    // add a null sink to have at least one connected
-    auto null_sink = gr::blocks::null_sink::make(/*sizeof_stream_item=*/sizeof(gr_complex));
-    tb->connect(src, 0, null_sink, 0);
+    from_graph(graph, app_data);
 
     return app_data;
   }
@@ -234,6 +566,13 @@ auto main(int argc, char** argv) -> int {
       ("samp-rate", "Sample rate of the sdr", cxxopts::value<unsigned int>()->default_value("1000000"))
       ("udp-start", "Start UDP port. Each stream gets its own UDP port, starting at udp-start", cxxopts::value<uint16_t>()->default_value("42000"))
       ("iq", "Send out iq data instead of decoded bits.")
+      ("soft-bits", "Send out framed soft decisions of the bits instead of decoded bits.")
+      ("uplink", "Demodulate the bursts of uplink carriers and send out framed soft decisions of the bits of each burst.")
+      ("low-latency", "Trade throughput for a bounded latency by shrinking the buffers along each chain.")
+      ("batch-demodulators", "Demodulate all streams together in the SIMD lanes of one block instead of one chain of blocks per stream.")
+      ("thread-pool", "Run the blocks in one thread per core instead of one thread per block.")
+      ("source-buffer", "Seconds of samples buffered after the SDR source, which are dropped instead of overflowing the SDR. 0 disables the buffer.", cxxopts::value<double>()->default_value("0"))
+      ("dry-run", "Print the optimized graph of the receiver instead of running it.")
       ;
     // clang-format on
 
@@ -244,14 +583,25 @@ auto main(int argc, char** argv) -> int {
       return EXIT_SUCCESS;
     }
 
+    const bool dry_run = result.count("dry-run");
     ApplicationData app_data;
 
+    // Print the graph that would be instantiated or instantiate it with gnuradio
+    const auto build = [dry_run, &app_data](const config::TopLevel& top) {
+      if (dry_run) {
+        std::cout << graph::to_string(build_graph(top));
+        return;
+      }
+
+      app_data = GnuradioBuilder::from_config(top);
+    };
+
     // Read from config file instead
     if (result.count("config-file")) {
       auto data = toml::parse(result["config-file"].as<std::string>());
       auto top = toml::get<config::TopLevel>(data);
 
-      app_data = GnuradioBuilder::from_config(top);
+      build(top);
     } else {
       const auto sample_rate = result["samp-rate"].as<unsigned int>();
       const auto& device_string = result["device-string"].as<std::string>();
@@ -262,6 +612,12 @@ auto main(int argc, char** argv) -> int {
       const auto& offsets = result["offsets"].as<std::vector<int>>();
       const auto udp_start = result["udp-start"].as<uint16_t>();
       const bool iq_data = result.count("iq");
+      const bool soft_bits = result.count("soft-bits");
+      const auto mode = result.count("uplink") ? config::StreamMode::kUplink : config::StreamMode::kDownlink;
+      const bool low_latency = result.count("low-latency");
+      const bool batch_demodulators = result.count("batch-demodulators");
+      const bool thread_pool = result.count("thread-pool");
+      const auto source_buffer_seconds = result["source-buffer"].as<double>();
 
       std::vector<config::Stream> streams;
       const auto input_spectrum = config::SpectrumSlice(center_frequency, sample_rate);
@@ -274,23 +630,38 @@ auto main(int argc, char** argv) -> int {
         const auto tetra_spectrum = config::SpectrumSlice(stream_frequency, config::kTetraSampleRate);
         std::string name = "Stream " + std::to_string(stream_frequency);
 
-        streams.emplace_back(
-            config::Stream(name, input_spectrum, tetra_spectrum, config::kDefaultHost, udp_port, iq_data));
+        streams.emplace_back(config::Stream(name, input_spectrum, tetra_spectrum, config::kDefaultHost, udp_port,
+                                            iq_data, soft_bits, mode));
       }
 
-      config::TopLevel top(input_spectrum, device_string, rf_gain, if_gain, bb_gain,
-                           /*streams=*/streams,
-                           /*decimators=*/{}, /*prometheus=*/nullptr);
+      std::optional<config::SourceBuffer> source_buffer;
+      if (source_buffer_seconds > 0) {
+        source_buffer.emplace(source_buffer_seconds, /*huge_pages=*/false);
+      }
 
-      app_data = GnuradioBuilder::from_config(top);
+      config::TopLevel top(input_spectrum, device_string, /*input_file=*/"", /*input_port=*/std::nullopt,
+                           config::SampleFormat::kComplexFloat32, rf_gain, if_gain, bb_gain, low_latency,
+                           batch_demodulators, thread_pool, /*streams=*/streams,
+                           /*decimators=*/{}, /*scans=*/{}, /*prometheus=*/nullptr, /*recorder=*/std::nullopt,
+                           /*source_buffer=*/source_buffer);
+
+      build(top);
+    }
+
+    if (dry_run) {
+      return EXIT_SUCCESS;
     }
 
     // print the gnuradio debugging information
     print_gnuradio_diagnostics();
 
-    app_data.tb->start();
+    for (const auto& tb : app_data.top_blocks) {
+      tb->start(app_data.max_noutput_items);
+    }
 
-    app_data.tb->wait();
+    for (const auto& tb : app_data.top_blocks) {
+      tb->wait();
+    }
   } catch (std::exception& e) {
     std::cerr << e.what() << std::endl;
     return EXIT_FAILURE;
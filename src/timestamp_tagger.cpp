@@ -0,0 +1,53 @@
+#include <chrono>
+#include <cstring>
+
+#include <gnuradio/io_signature.h>
+
+#include "timestamp_tagger.h"
+
+namespace gr::tetra {
+
+TimestampTagger::sptr TimestampTagger::make(const std::size_t item_size, const uint64_t interval) {
+  return gnuradio::get_initial_sptr(new TimestampTagger(item_size, interval));
+}
+
+TimestampTagger::TimestampTagger(const std::size_t item_size, const uint64_t interval)
+    : sync_block(
+          /*name=*/"TimestampTagger",
+          /*input_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/item_size),
+          /*output_signature=*/
+          io_signature::make(/*min_streams=*/1, /*max_streams=*/1, /*sizeof_stream_items=*/item_size))
+    , item_size_(item_size)
+    , interval_(interval > 0 ? interval : 1) {
+  // Only our own host time tags should leave this block. Otherwise rx_time tags of the device clock would mix with
+  // the ones of the host clock.
+  set_tag_propagation_policy(TPP_DONT);
+}
+
+auto TimestampTagger::work(const int noutput_items, gr_vector_const_void_star& input_items,
+                           gr_vector_void_star& output_items) -> int {
+  std::memcpy(output_items[0], input_items[0], noutput_items * item_size_);
+
+  const auto start = nitems_written(0);
+  const auto end = start + noutput_items;
+
+  // The first sample at or after start that is a multiple of the interval
+  auto offset = ((start + interval_ - 1) / interval_) * interval_;
+  if (offset >= end)
+    return noutput_items;
+
+  // Tag with the GNU Radio rx_time format of full seconds and fractional seconds
+  const auto now = std::chrono::system_clock::now().time_since_epoch();
+  const auto full_seconds = std::chrono::duration_cast<std::chrono::seconds>(now);
+  const std::chrono::duration<double> frac_seconds = now - full_seconds;
+  const auto time = pmt::make_tuple(pmt::from_uint64(full_seconds.count()), pmt::from_double(frac_seconds.count()));
+
+  for (; offset < end; offset += interval_) {
+    add_item_tag(/*which_output=*/0, /*abs_offset=*/offset, /*key=*/kRxTimeKey, /*value=*/time);
+  }
+
+  return noutput_items;
+}
+
+} // namespace gr::tetra
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "udp_frame.h"
+
+namespace udp_frame {
+
+static auto write_u32(const uint32_t value, uint8_t* out) noexcept -> void {
+  out[0] = static_cast<uint8_t>(value >> 24);
+  out[1] = static_cast<uint8_t>(value >> 16);
+  out[2] = static_cast<uint8_t>(value >> 8);
+  out[3] = static_cast<uint8_t>(value);
+}
+
+static auto read_u32(const uint8_t* in) noexcept -> uint32_t {
+  return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16) |
+         (static_cast<uint32_t>(in[2]) << 8) | static_cast<uint32_t>(in[3]);
+}
+
+static auto write_u16(const uint16_t value, uint8_t* out) noexcept -> void {
+  out[0] = static_cast<uint8_t>(value >> 8);
+  out[1] = static_cast<uint8_t>(value);
+}
+
+static auto read_u16(const uint8_t* in) noexcept -> uint16_t {
+  return static_cast<uint16_t>((static_cast<uint16_t>(in[0]) << 8) | static_cast<uint16_t>(in[1]));
+}
+
+static auto write_u64(const uint64_t value, uint8_t* out) noexcept -> void {
+  write_u32(static_cast<uint32_t>(value >> 32), out);
+  write_u32(static_cast<uint32_t>(value), out + 4);
+}
+
+static auto read_u64(const uint8_t* in) noexcept -> uint64_t {
+  return (static_cast<uint64_t>(read_u32(in)) << 32) | static_cast<uint64_t>(read_u32(in + 4));
+}
+
+auto write_header(const Header& header, uint8_t* frame) noexcept -> void {
+  write_u32(kMagic, frame);
+  frame[4] = kVersion;
+  frame[5] = static_cast<uint8_t>(header.payload_type_);
+  frame[6] = 0;
+  frame[7] = 0;
+  write_u32(header.sequence_, frame + 8);
+  write_u32(header.sample_rate_, frame + 12);
+  write_u32(header.center_frequency_, frame + 16);
+  write_u32(header.item_count_, frame + 20);
+}
+
+auto read_header(const uint8_t* frame, const std::size_t size) -> Header {
+  if (size < kHeaderSize) {
+    throw std::invalid_argument("The frame is shorter than its header.");
+  }
+  if (read_u32(frame) != kMagic) {
+    throw std::invalid_argument("The frame does not start with the magic.");
+  }
+  if (frame[4] != kVersion) {
+    throw std::invalid_argument("The version of the frame is not supported.");
+  }
+
+  Header header;
+  header.payload_type_ = static_cast<PayloadType>(frame[5]);
+  header.sequence_ = read_u32(frame + 8);
+  header.sample_rate_ = read_u32(frame + 12);
+  header.center_frequency_ = read_u32(frame + 16);
+  header.item_count_ = read_u32(frame + 20);
+
+  return header;
+}
+
+auto write_burst_header(const BurstHeader& header, uint8_t* payload) noexcept -> void {
+  payload[0] = header.burst_type_;
+  payload[1] = 0;
+  write_u16(static_cast<uint16_t>(header.frequency_offset_), payload + 2);
+  write_u64(header.symbol_, payload + 4);
+}
+
+auto read_burst_header(const uint8_t* payload, const std::size_t size) -> BurstHeader {
+  if (size < kBurstHeaderSize) {
+    throw std::invalid_argument("The payload is shorter than the header of a burst.");
+  }
+
+  BurstHeader header;
+  header.burst_type_ = payload[0];
+  header.frequency_offset_ = static_cast<int16_t>(read_u16(payload + 2));
+  header.symbol_ = read_u64(payload + 4);
+
+  return header;
+}
+
+Deframer::Deframer(const PayloadType payload_type, const std::size_t item_size, const uint32_t sample_rate,
+                   const uint32_t center_frequency)
+    : payload_type_(payload_type)
+    , item_size_(item_size)
+    , sample_rate_(sample_rate)
+    , center_frequency_(center_frequency) {
+  if (item_size == 0) {
+    throw std::invalid_argument("The items of a frame have to be at least one byte.");
+  }
+}
+
+FrameSplitter::FrameSplitter(const std::size_t capacity, const uint32_t center_frequency)
+    : capacity_(capacity)
+    , center_frequency_(center_frequency) {
+  if (capacity_ == 0) {
+    throw std::invalid_argument("A frame has to hold at least one item.");
+  }
+}
+
+auto FrameSplitter::retune(const uint64_t position, const uint32_t center_frequency) -> void {
+  if (position < position_ || (!retunes_.empty() && position < retunes_.back().first)) {
+    throw std::invalid_argument("The retunes have to be added in order and before the frames that reach them.");
+  }
+  retunes_.emplace_back(position, center_frequency);
+}
+
+auto FrameSplitter::next(const std::size_t available) -> std::optional<std::size_t> {
+  // the retunes at the start of the frame set its center frequency, the next one ends it
+  while (!retunes_.empty() && retunes_.front().first == position_) {
+    center_frequency_ = retunes_.front().second;
+    retunes_.pop_front();
+  }
+  auto items = capacity_;
+  if (!retunes_.empty()) {
+    items = std::min<uint64_t>(items, retunes_.front().first - position_);
+  }
+
+  if (available < items) {
+    return std::nullopt;
+  }
+  position_ += items;
+  return items;
+}
+
+auto Deframer::push(const uint8_t* frame, const std::size_t size) -> std::optional<Frame> {
+  const auto header = read_header(frame, size);
+
+  if (header.payload_type_ != payload_type_) {
+    throw std::invalid_argument("The frame carries another kind of items than expected.");
+  }
+  if (header.sample_rate_ != sample_rate_) {
+    throw std::invalid_argument("The frame has a sample rate of " + std::to_string(header.sample_rate_) +
+                                " instead of " + std::to_string(sample_rate_) + ".");
+  }
+  if (header.center_frequency_ != center_frequency_) {
+    throw std::invalid_argument("The frame has a center frequency of " + std::to_string(header.center_frequency_) +
+                                " instead of " + std::to_string(center_frequency_) + ".");
+  }
+  if (size - kHeaderSize < header.item_count_ * item_size_) {
+    throw std::invalid_argument("The payload is smaller than the number of items of the frame.");
+  }
+
+  Frame payload;
+  payload.payload_ = frame + kHeaderSize;
+  payload.items_ = header.item_count_;
+
+  if (next_sequence_) {
+    // the distance to the expected sequence number, which wraps around
+    const auto distance = static_cast<int32_t>(header.sequence_ - *next_sequence_);
+
+    if (distance < 0 && static_cast<uint32_t>(-static_cast<int64_t>(distance)) <= kMaxLateFrames) {
+      late_frames_++;
+      return std::nullopt;
+    }
+    // the frames in between were lost, assume that they had as many items as this one
+    if (distance > 0 && static_cast<uint32_t>(distance) <= kMaxLostFrames) {
+      payload.lost_items_ = static_cast<std::size_t>(distance) * header.item_count_;
+    }
+  }
+
+  next_sequence_ = header.sequence_ + 1;
+  return payload;
+}
+
+} // namespace udp_frame
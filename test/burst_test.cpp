@@ -0,0 +1,160 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "burst.h"
+
+static constexpr unsigned int kSamplesPerSymbol = burst::kSamplesPerSymbol;
+static constexpr double kSymbolRate = 18000;
+static constexpr double kSampleRate = kSymbolRate * kSamplesPerSymbol;
+
+/// The bits of a burst with random data around its training sequence
+static auto burst_bits(const burst::TrainingSequence& sequence, std::mt19937& generator) -> std::vector<uint8_t> {
+  std::uniform_int_distribution<int> bit(0, 1);
+  std::vector<uint8_t> bits(sequence.burst_bits_);
+  for (auto& b : bits) {
+    b = static_cast<uint8_t>(bit(generator));
+  }
+  std::copy(sequence.bits_.begin(), sequence.bits_.end(), bits.begin() + sequence.position_);
+  return bits;
+}
+
+/// Noise with the bits modulated as π/4-DQPSK with rectangular pulses. The reference symbol of the burst starts at
+/// delay, the first symbol of the burst one symbol later.
+static auto modulate(const std::vector<uint8_t>& bits, const std::size_t delay, const double frequency_offset,
+                     const std::size_t count, std::mt19937& generator) -> std::vector<std::complex<float>> {
+  std::normal_distribution<float> noise(0, 0.02);
+  std::vector<std::complex<float>> samples(count);
+  for (auto& sample : samples) {
+    sample = {noise(generator), noise(generator)};
+  }
+
+  float phase = 0.3f;
+  for (std::size_t symbol = 0; symbol <= bits.size() / 2; symbol++) {
+    // the first symbol is the reference for the phase change of the first two bits
+    if (symbol > 0) {
+      phase += burst::phase_change(bits[2 * symbol - 2], bits[2 * symbol - 1]);
+    }
+    for (std::size_t i = 0; i < kSamplesPerSymbol; i++) {
+      const auto n = delay + symbol * kSamplesPerSymbol + i;
+      const auto rotation = static_cast<float>(2 * M_PI * frequency_offset * n / kSampleRate);
+      samples[n] += std::polar(1.0f, phase + rotation);
+    }
+  }
+
+  return samples;
+}
+
+/// Estimate and demodulate a burst of the kind and check the estimate and the signs of the soft bits
+static auto check_burst(const burst::TrainingSequence& sequence, const std::size_t delay,
+                        const double frequency_offset) -> void {
+  std::mt19937 generator(/*seed=*/42);
+  const auto bits = burst_bits(sequence, generator);
+  const auto count = delay + (sequence.burst_bits_ / 2 + 1 + burst::kGuardSymbols) * kSamplesPerSymbol;
+  const auto samples = modulate(bits, delay, frequency_offset, count, generator);
+
+  burst::BurstEstimator estimator(kSamplesPerSymbol, kSymbolRate);
+  const auto estimate = estimator.estimate(samples.data(), samples.size(), /*max_start=*/count);
+  ASSERT_TRUE(estimate.has_value());
+
+  EXPECT_EQ(estimate->burst_type_, sequence.burst_type_);
+  EXPECT_EQ(estimate->burst_bits_, sequence.burst_bits_);
+  EXPECT_GT(estimate->quality_, 0.95);
+  EXPECT_NEAR(estimate->frequency_offset_, frequency_offset, 20);
+  // every sample of the rectangular pulse of the first symbol is a valid start
+  const auto first_symbol = static_cast<double>(delay + kSamplesPerSymbol);
+  EXPECT_GE(estimate->start_, first_symbol - 0.5);
+  EXPECT_LT(estimate->start_, first_symbol + kSamplesPerSymbol);
+
+  std::vector<int8_t> soft_bits(estimate->burst_bits_);
+  estimator.demodulate(samples.data(), samples.size(), *estimate, soft_bits.data());
+  for (std::size_t i = 0; i < bits.size(); i++) {
+    EXPECT_EQ(soft_bits[i] > 0, bits[i] == 1) << "bit " << i;
+    EXPECT_GT(std::abs(soft_bits[i]), 64) << "bit " << i;
+  }
+}
+
+TEST(burst, phase_change) {
+  EXPECT_FLOAT_EQ(burst::phase_change(0, 0), M_PI / 4);
+  EXPECT_FLOAT_EQ(burst::phase_change(0, 1), 3 * M_PI / 4);
+  EXPECT_FLOAT_EQ(burst::phase_change(1, 0), -M_PI / 4);
+  EXPECT_FLOAT_EQ(burst::phase_change(1, 1), -3 * M_PI / 4);
+}
+
+TEST(burst, training_sequences) {
+  for (const auto& sequence : burst::training_sequences()) {
+    EXPECT_EQ(sequence.position_ % 2, 0);
+    EXPECT_EQ(sequence.bits_.size() % 2, 0);
+    EXPECT_LE(sequence.position_ + sequence.bits_.size(), sequence.burst_bits_);
+  }
+}
+
+TEST(burst, estimate_normal_uplink_burst) {
+  check_burst(burst::training_sequences().at(0), /*delay=*/37, /*frequency_offset=*/400);
+}
+
+TEST(burst, estimate_stolen_and_control_uplink_bursts) {
+  check_burst(burst::training_sequences().at(1), /*delay=*/12, /*frequency_offset=*/-1200);
+  check_burst(burst::training_sequences().at(2), /*delay=*/50, /*frequency_offset=*/2500);
+}
+
+TEST(burst, reject_noise) {
+  std::mt19937 generator(/*seed=*/42);
+  std::normal_distribution<float> noise(0, 1);
+  std::vector<std::complex<float>> samples(1000);
+  for (auto& sample : samples) {
+    sample = {noise(generator), noise(generator)};
+  }
+
+  burst::BurstEstimator estimator(kSamplesPerSymbol, kSymbolRate);
+  EXPECT_FALSE(estimator.estimate(samples.data(), samples.size(), /*max_start=*/samples.size()).has_value());
+  // a window that is too short for any burst
+  EXPECT_FALSE(estimator.estimate(samples.data(), 100, /*max_start=*/100).has_value());
+}
+
+TEST(burst, energy_detector) {
+  std::mt19937 generator(/*seed=*/42);
+  std::normal_distribution<float> noise(0, 0.01);
+  const std::size_t burst_samples = burst::kNormalBurstBits / 2 * kSamplesPerSymbol;
+
+  // two bursts between noise
+  std::vector<std::size_t> starts = {2000, 2000 + burst_samples + 1000};
+  std::vector<std::size_t> detections;
+  burst::EnergyDetector detector(kSamplesPerSymbol);
+  for (std::size_t i = 0; i < starts.back() + burst_samples + 1000; i++) {
+    std::complex<float> sample(noise(generator), noise(generator));
+    for (const auto start : starts) {
+      if (i >= start && i < start + burst_samples) {
+        sample += std::polar(1.0f, static_cast<float>(i));
+      }
+    }
+    if (detector.push(sample)) {
+      detections.push_back(i);
+    }
+  }
+
+  ASSERT_EQ(detections.size(), starts.size());
+  for (std::size_t i = 0; i < starts.size(); i++) {
+    EXPECT_GE(detections[i], starts[i]);
+    EXPECT_LT(detections[i], starts[i] + kSamplesPerSymbol);
+  }
+  EXPECT_NEAR(detector.noise_floor(), 2 * 0.01 * 0.01, 1e-4);
+}
+
+TEST(burst, energy_detector_continuous_carrier) {
+  burst::EnergyDetector detector(kSamplesPerSymbol);
+  std::size_t detections = 0;
+
+  // a carrier that starts and never stops is detected once and then becomes the noise floor
+  for (std::size_t i = 0; i < 1000; i++) {
+    detections += detector.push({0.01f, 0});
+  }
+  for (std::size_t i = 0; i < 10 * burst::kSlotSymbols * kSamplesPerSymbol; i++) {
+    detections += detector.push({1, 0});
+  }
+
+  EXPECT_EQ(detections, 1);
+  EXPECT_NEAR(detector.noise_floor(), 1, 1e-3);
+}
@@ -53,10 +53,78 @@ TEST(config, TopLevel_decimate_not_divisible) {
 		
 		[DecimateA]
 		Frequency = 4250000
-		SampleRate = 500001
+		SampleRate = 300000
+
+		[DecimateA.Stream0]
+		Frequency = 4300000
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  // Input sample rate is not divisible by Decimate block sample rate, we decimate by 3 and resample the rest.
+  EXPECT_EQ(t.decimators_.size(), 1);
+  const auto& decimate_a = t.decimators_[0];
+
+  EXPECT_EQ(decimate_a.decimation_, 3);
+  EXPECT_DOUBLE_EQ(decimate_a.resampling_rate_, 0.9);
+  EXPECT_EQ(decimate_a.passband().lower_bound(), 4130000);
+  EXPECT_EQ(decimate_a.passband().upper_bound(), 4370000);
+
+  EXPECT_EQ(decimate_a.streams_.size(), 1);
+  EXPECT_EQ(decimate_a.streams_[0].decimation_, 12);
+}
+
+TEST(config, TopLevel_decimate_not_divisible_outside_passband) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+		
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 300000
+
+		[DecimateA.Stream0]
+		Frequency = 4360000
 	)"_toml;
 
-  // Input sample rate is not divisible by Decimate block sample rate.
+  // Frequency Range of the Stream is not inside the passband of the resampling Decimate block.
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_decimate_not_divisible_stream_at_passband_edge) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+		
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 300000
+
+		[DecimateA.Stream0]
+		Frequency = 4357500
+	)"_toml;
+
+  // The Stream ends at the edge of the passband of the resampler, which passes it without attenuation.
+  const auto top_level = toml::get<config::TopLevel>(config_object);
+  const auto& decimator = top_level.decimators_.at(0);
+  EXPECT_EQ(decimator.passband().upper_bound(), 4370000);
+  EXPECT_EQ(decimator.streams_.at(0).spectrum_.frequency_range_.upper_bound(), decimator.passband().upper_bound());
+}
+
+TEST(config, TopLevel_decimate_too_small) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+		
+		[DecimateA]
+		Frequency = 4000000
+		SampleRate = 1000001
+	)"_toml;
+
+  // Decimate block sample rate is bigger than the input sample rate.
   EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
 }
 
@@ -70,8 +138,102 @@ TEST(config, TopLevel_stream_not_divisible) {
 		Frequency = 4000000
 	)"_toml;
 
-  // Input sample rate is not divisible by Stream block sample rate.
-  // 60000 is not divisible by default 25000 TETRA stream sample rate
+  // 60000 is not divisible by the TETRA sample rate, the Stream is decimated to 30000 and resampled
+  const auto top_level = toml::get<config::TopLevel>(config_object);
+  EXPECT_EQ(top_level.streams_.at(0).decimation_, 2);
+}
+
+TEST(config, TopLevel_decimate_not_multiple_of_stream_sample_rate) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 230000
+
+		[DecimateA.Stream0]
+		Frequency = 4300000
+
+		[DecimateA.ScanA]
+		Frequencies = [4200000, 4250000]
+		Slots = 1
+	)"_toml;
+
+  // 230000 is no multiple of the TETRA sample rate, the Stream and the Scan decimate by 9 and resample the rest
+  const auto top_level = toml::get<config::TopLevel>(config_object);
+  const auto& decimator = top_level.decimators_.at(0);
+  EXPECT_EQ(decimator.streams_.at(0).decimation_, 9);
+  EXPECT_EQ(decimator.scans_.at(0).decimation_, 9);
+  EXPECT_TRUE(decimator.passband().contains(decimator.streams_.at(0).spectrum_.frequency_range_));
+}
+
+TEST(config, TopLevel_stream_iq_and_soft_bits) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Stream0]
+		Frequency = 4000000
+		SendIQ = true
+		SendSoftBits = true
+	)"_toml;
+
+  // A Stream cannot send iq data and soft bits at the same time.
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_stream_uplink) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Stream0]
+		Frequency = 4000000
+		Mode = "uplink"
+
+		[Stream1]
+		Frequency = 4100000
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  EXPECT_EQ(t.streams_.size(), 2);
+  for (const auto& stream : t.streams_) {
+    EXPECT_EQ(stream.mode_, stream.name_ == "Stream0" ? config::StreamMode::kUplink : config::StreamMode::kDownlink);
+  }
+}
+
+TEST(config, TopLevel_stream_uplink_iq) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Stream0]
+		Frequency = 4000000
+		Mode = "uplink"
+		SendIQ = true
+	)"_toml;
+
+  // An uplink Stream always sends the soft bits of its bursts.
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_stream_mode_unknown) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Stream0]
+		Frequency = 4000000
+		Mode = "sideways"
+	)"_toml;
+
   EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
 }
 
@@ -132,6 +294,362 @@ TEST(config, TopLevel_prometheus_set) {
   EXPECT_EQ(t.prometheus_->port_, 4200);
 }
 
+TEST(config, TopLevel_recorder_default) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 60000
+
+		[Recorder]
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  // recorder is set
+  EXPECT_TRUE(t.recorder_);
+
+  EXPECT_EQ(t.recorder_->pre_trigger_seconds_, config::kDefaultPreTriggerSeconds);
+  EXPECT_EQ(t.recorder_->post_trigger_seconds_, config::kDefaultPostTriggerSeconds);
+  EXPECT_EQ(t.recorder_->directory_, config::kDefaultRecordingDirectory);
+  EXPECT_FALSE(t.recorder_->power_threshold_);
+  EXPECT_FALSE(t.recorder_->huge_pages_);
+}
+
+TEST(config, TopLevel_recorder_under_decimate) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+
+		[DecimateA.Recorder]
+		PreTrigger = 30
+		PostTrigger = 2
+		Directory = "/tmp"
+		PowerThreshold = 0.5
+		HugePages = true
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  // the recorder is not on the SDR samples
+  EXPECT_FALSE(t.recorder_);
+
+  EXPECT_EQ(t.decimators_.size(), 1);
+  const auto& decimate_a = t.decimators_[0];
+
+  // the recorder is not a Stream
+  EXPECT_EQ(decimate_a.streams_.size(), 0);
+  EXPECT_TRUE(decimate_a.recorder_);
+
+  EXPECT_EQ(decimate_a.recorder_->pre_trigger_seconds_, 30);
+  EXPECT_EQ(decimate_a.recorder_->post_trigger_seconds_, 2);
+  EXPECT_EQ(decimate_a.recorder_->directory_, "/tmp");
+  EXPECT_EQ(decimate_a.recorder_->power_threshold_, 0.5);
+  EXPECT_TRUE(decimate_a.recorder_->huge_pages_);
+}
+
+TEST(config, TopLevel_recorder_empty) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 60000
+
+		[Recorder]
+		PreTrigger = 0
+		PostTrigger = 0
+	)"_toml;
+
+  // Recorder would not record any samples.
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_source_buffer) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 60000
+
+		[SourceBuffer]
+		Seconds = 2.5
+		HugePages = true
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  // the source buffer is not a Stream
+  EXPECT_EQ(t.streams_.size(), 0);
+  EXPECT_TRUE(t.source_buffer_);
+
+  EXPECT_EQ(t.source_buffer_->seconds_, 2.5);
+  EXPECT_TRUE(t.source_buffer_->huge_pages_);
+}
+
+TEST(config, TopLevel_source_buffer_empty) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 60000
+
+		[SourceBuffer]
+		Seconds = 0.0
+	)"_toml;
+
+  // SourceBuffer would not hold any samples.
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_input_file) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		SampleRate = 60000
+		InputFile = "/dev/stdin"
+		SampleFormat = "cu8"
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  // the device string is optional with an input file
+  EXPECT_EQ(t.device_string_, "");
+  EXPECT_EQ(t.input_file_, "/dev/stdin");
+  EXPECT_FALSE(t.input_port_);
+  EXPECT_EQ(t.sample_format_, config::SampleFormat::kComplexUint8);
+}
+
+TEST(config, TopLevel_input_port) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4250000
+		SampleRate = 500000
+		InputPort = 43000
+
+		[Stream0]
+		Frequency = 4250000
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  // the device string is optional with an input port
+  EXPECT_EQ(t.device_string_, "");
+  EXPECT_EQ(t.input_port_, 43000);
+  EXPECT_EQ(t.streams_.size(), 1);
+}
+
+TEST(config, TopLevel_input_port_and_input_file) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4250000
+		SampleRate = 500000
+		InputPort = 43000
+		InputFile = "/dev/stdin"
+	)"_toml;
+
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_input_port_sample_format) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4250000
+		SampleRate = 500000
+		InputPort = 43000
+		SampleFormat = "cs16"
+	)"_toml;
+
+  // the exported samples are always cf32
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_export_under_decimate) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+
+		[DecimateA.Export]
+		Host = "10.0.0.2"
+		Port = 43000
+
+		[DecimateB]
+		Frequency = 3750000
+		SampleRate = 500000
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  ASSERT_EQ(t.decimators_.size(), 2);
+  for (const auto& decimate : t.decimators_) {
+    // the export is not a stream
+    EXPECT_EQ(decimate.streams_.size(), 0);
+    if (decimate.name_ == "DecimateA") {
+      ASSERT_TRUE(decimate.export_);
+      EXPECT_EQ(decimate.export_->host_, "10.0.0.2");
+      EXPECT_EQ(decimate.export_->port_, 43000);
+    } else {
+      EXPECT_FALSE(decimate.export_);
+    }
+  }
+}
+
+TEST(config, TopLevel_sample_format_unknown) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		SampleRate = 60000
+		InputFile = "/dev/stdin"
+		SampleFormat = "cs12"
+	)"_toml;
+
+  // Unknown sample format
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_sample_format_without_input_file) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 60000
+		SampleFormat = "cs8"
+	)"_toml;
+
+  // The osmosdr source only produces cf32 samples
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_low_latency) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 60000
+		LowLatency = true
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  EXPECT_EQ(t.low_latency_, true);
+}
+
+TEST(config, TopLevel_batch_demodulators) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 60000
+		BatchDemodulators = true
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  EXPECT_EQ(t.batch_demodulators_, true);
+}
+
+TEST(config, TopLevel_thread_pool) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 60000
+		ThreadPool = true
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  EXPECT_EQ(t.thread_pool_, true);
+}
+
+TEST(config, TopLevel_scan) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[ScanA]
+		Frequencies = [ 3900000, 3925000, 4100000 ]
+		Slots = 2
+		Dwell = 0.5
+		Host = "10.0.0.2"
+		Port = 43000
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+
+		[DecimateA.ScanB]
+		Frequencies = [ 4200000, 4300000 ]
+		Slots = 1
+	)"_toml;
+
+  const config::TopLevel t = toml::get<config::TopLevel>(config_object);
+
+  ASSERT_EQ(t.scans_.size(), 1);
+  const auto& scan_a = t.scans_[0];
+  EXPECT_EQ(scan_a.name_, "ScanA");
+  EXPECT_EQ(scan_a.frequencies_, std::vector<unsigned int>({3900000, 3925000, 4100000}));
+  EXPECT_EQ(scan_a.slots_, 2);
+  EXPECT_EQ(scan_a.dwell_seconds_, 0.5);
+  EXPECT_EQ(scan_a.max_dwell_seconds_, config::kDefaultMaxDwellSeconds);
+  EXPECT_EQ(scan_a.host_, "10.0.0.2");
+  EXPECT_EQ(scan_a.port_, 43000);
+  EXPECT_EQ(scan_a.decimation_, 40);
+
+  // the scan is not a Stream
+  ASSERT_EQ(t.decimators_.size(), 1);
+  const auto& decimate_a = t.decimators_[0];
+  EXPECT_EQ(decimate_a.streams_.size(), 0);
+  ASSERT_EQ(decimate_a.scans_.size(), 1);
+  const auto& scan_b = decimate_a.scans_[0];
+  EXPECT_EQ(scan_b.input_spectrum_, decimate_a.spectrum_);
+  EXPECT_EQ(scan_b.dwell_seconds_, config::kDefaultDwellSeconds);
+  EXPECT_EQ(scan_b.host_, config::kDefaultHost);
+  EXPECT_EQ(scan_b.port_, config::kDefaultPort);
+  EXPECT_EQ(scan_b.decimation_, 20);
+}
+
+TEST(config, TopLevel_scan_outside) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[ScanA]
+		Frequencies = [ 3900000, 4500000 ]
+		Slots = 1
+	)"_toml;
+
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_scan_too_many_slots) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[ScanA]
+		Frequencies = [ 3900000, 4100000 ]
+		Slots = 3
+	)"_toml;
+
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
+TEST(config, TopLevel_scan_dwell_above_max_dwell) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[ScanA]
+		Frequencies = [ 3900000, 4100000 ]
+		Slots = 1
+		Dwell = 2.0
+		MaxDwell = 1.0
+	)"_toml;
+
+  EXPECT_THROW(toml::get<config::TopLevel>(config_object), std::invalid_argument);
+}
+
 TEST(config, TopLevel_valid_parser) {
   const toml::value config_object = u8R"(
 		CenterFrequency = 4000000
@@ -147,6 +665,7 @@ TEST(config, TopLevel_valid_parser) {
 		Frequency = 4250010
 		Host = "127.0.0.1"
 		Port = 4100
+		SendSoftBits = true
 		
 		[DecimateA.Stream1]
 		Frequency = 4250100
@@ -164,9 +683,14 @@ TEST(config, TopLevel_valid_parser) {
   EXPECT_EQ(t.spectrum_.center_frequency_, 4000000);
   EXPECT_EQ(t.spectrum_.sample_rate_, 1000000);
   EXPECT_EQ(t.device_string_, "device_string_abc");
+  EXPECT_EQ(t.input_file_, "");
+  EXPECT_EQ(t.sample_format_, config::SampleFormat::kComplexFloat32);
   EXPECT_EQ(t.rf_gain_, 0);
   EXPECT_EQ(t.if_gain_, 14);
   EXPECT_EQ(t.bb_gain_, 0);
+  EXPECT_EQ(t.low_latency_, false);
+  EXPECT_EQ(t.batch_demodulators_, false);
+  EXPECT_EQ(t.thread_pool_, false);
 
   // prometheus is not set
   EXPECT_FALSE(t.prometheus_);
@@ -178,6 +702,7 @@ TEST(config, TopLevel_valid_parser) {
   EXPECT_EQ(decimate_a.spectrum_.center_frequency_, 4250000);
   EXPECT_EQ(decimate_a.spectrum_.sample_rate_, 500000);
   EXPECT_EQ(decimate_a.decimation_, 2);
+  EXPECT_EQ(decimate_a.resampling_rate_, 1.0);
 
   EXPECT_EQ(decimate_a.streams_.size(), 2);
   const auto& stream_0 = decimate_a.streams_[1];
@@ -190,6 +715,7 @@ TEST(config, TopLevel_valid_parser) {
   EXPECT_EQ(stream_0.port_, 4100);
   EXPECT_EQ(stream_0.decimation_, 20);
   EXPECT_EQ(stream_0.send_iq_, false);
+  EXPECT_EQ(stream_0.send_soft_bits_, true);
 
   EXPECT_EQ(stream_1.name_, "Stream1");
   EXPECT_EQ(stream_1.spectrum_.center_frequency_, 4250100);
@@ -198,6 +724,7 @@ TEST(config, TopLevel_valid_parser) {
   EXPECT_EQ(stream_1.port_, config::kDefaultPort);
   EXPECT_EQ(stream_1.decimation_, 20);
   EXPECT_EQ(stream_1.send_iq_, false);
+  EXPECT_EQ(stream_1.send_soft_bits_, false);
 
   EXPECT_EQ(t.streams_.size(), 1);
   const auto& stream_2 = t.streams_[0];
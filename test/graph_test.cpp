@@ -0,0 +1,781 @@
+#include <map>
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "graph.h"
+
+using namespace toml::literals::toml_literals;
+
+/// Count the nodes of a kind in the graph
+template <typename T> static auto count(const graph::Graph& graph) -> std::size_t {
+  return std::count_if(graph.nodes_.begin(), graph.nodes_.end(),
+                       [](const graph::Node& node) { return std::holds_alternative<T>(node.data_); });
+}
+
+/// Find the first node of a kind in the graph
+template <typename T> static auto find(const graph::Graph& graph) -> const graph::Node& {
+  for (const auto& node : graph.nodes_) {
+    if (std::holds_alternative<T>(node.data_)) {
+      return node;
+    }
+  }
+  throw std::invalid_argument("Node not found");
+}
+
+TEST(graph, from_config) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Prometheus]
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+
+		[DecimateA.Stream0]
+		Frequency = 4250000
+
+		[Stream1]
+		Frequency = 4100000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  const auto graph = graph::from_config(top);
+
+  EXPECT_EQ(count<graph::Source>(graph), 1);
+  EXPECT_EQ(count<graph::TimestampTagger>(graph), 1);
+  EXPECT_EQ(count<graph::ChannelFilter>(graph), 3);
+  EXPECT_EQ(count<graph::Demodulator>(graph), 2);
+  EXPECT_EQ(count<graph::BitDecoder>(graph), 2);
+  EXPECT_EQ(count<graph::UdpSink>(graph), 2);
+  EXPECT_EQ(count<graph::PowerProbe>(graph), 2);
+  EXPECT_EQ(count<graph::LatencyProbe>(graph), 2);
+  EXPECT_EQ(count<graph::QualityProbe>(graph), 2);
+  EXPECT_EQ(count<graph::NullSink>(graph), 2);
+
+  // the inputs of each node come before it
+  for (graph::NodeId id = 0; id < graph.nodes_.size(); id++) {
+    for (const auto& input : graph.nodes_[id].inputs_) {
+      EXPECT_LT(input.node_, id);
+    }
+  }
+
+  const auto& filter = find<graph::ChannelFilter>(graph);
+  EXPECT_EQ(filter.name_, "DecimateA");
+  EXPECT_EQ(std::get<graph::ChannelFilter>(filter.data_).decimation_, 2);
+  EXPECT_EQ(std::get<graph::ChannelFilter>(filter.data_).offset_, 250000);
+  EXPECT_DOUBLE_EQ(filter.sample_rate_, 500000);
+}
+
+TEST(graph, merge_identical_subchains) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Stream0]
+		Frequency = 4100000
+		Port = 42000
+
+		[Stream1]
+		Frequency = 4100000
+		Port = 42001
+
+		[Stream2]
+		Frequency = 4200000
+		Port = 42002
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the streams on the same frequency share the filter, the demodulator and the bit decoder
+  EXPECT_EQ(count<graph::ChannelFilter>(graph), 2);
+  EXPECT_EQ(count<graph::Demodulator>(graph), 2);
+  EXPECT_EQ(count<graph::BitDecoder>(graph), 2);
+  EXPECT_EQ(count<graph::UdpSink>(graph), 3);
+
+  const auto& decoder = find<graph::BitDecoder>(graph);
+  // the order of the tables in the config is not preserved
+  EXPECT_TRUE(decoder.name_ == "Stream0+Stream1" || decoder.name_ == "Stream1+Stream0");
+
+  const graph::NodeId decoder_id = &decoder - graph.nodes_.data();
+  std::size_t sinks_of_first_decoder = 0;
+  for (const auto consumer : graph.consumers(decoder_id)) {
+    if (std::holds_alternative<graph::UdpSink>(graph.nodes_[consumer].data_)) {
+      sinks_of_first_decoder++;
+    }
+  }
+  EXPECT_EQ(sinks_of_first_decoder, 2);
+
+  // the source is consumed by the filters, its null sink is dropped
+  EXPECT_EQ(count<graph::NullSink>(graph), 0);
+}
+
+TEST(graph, merge_keeps_different_modes) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Stream0]
+		Frequency = 4100000
+
+		[Stream1]
+		Frequency = 4100000
+		SendIQ = true
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  EXPECT_EQ(count<graph::ChannelFilter>(graph), 1);
+  EXPECT_EQ(count<graph::Demodulator>(graph), 2);
+}
+
+TEST(graph, merge_soft_and_hard_bits) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Stream0]
+		Frequency = 4100000
+
+		[Stream1]
+		Frequency = 4100000
+		SendSoftBits = true
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the hard and the soft bits are decided from the same symbols
+  EXPECT_EQ(count<graph::ChannelFilter>(graph), 1);
+  EXPECT_EQ(count<graph::Demodulator>(graph), 1);
+  EXPECT_EQ(count<graph::BitDecoder>(graph), 1);
+  EXPECT_EQ(count<graph::SoftBitFramer>(graph), 1);
+
+  // each frame of soft bits is one item
+  const auto& framer = find<graph::SoftBitFramer>(graph);
+  EXPECT_EQ(framer.item_size_, udp_frame::kHeaderSize + udp_frame::kSoftBitsPerFrame);
+  EXPECT_LE(framer.item_size_, udp_frame::kMaxFrameSize);
+  EXPECT_DOUBLE_EQ(framer.sample_rate_ * udp_frame::kSoftBitsPerFrame, graph::kBitRate);
+  EXPECT_EQ(std::get<graph::Demodulator>(graph.nodes_[framer.inputs_[0].node_].data_).samples_per_symbol_, 2);
+}
+
+TEST(graph, uplink_bursts) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Stream0]
+		Frequency = 4100000
+		Port = 42000
+		Mode = "uplink"
+
+		[Stream1]
+		Frequency = 4100000
+		Port = 42001
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the uplink and the downlink on the same frequency share the channel filter, the bursts skip the continuous chain
+  EXPECT_EQ(count<graph::ChannelFilter>(graph), 1);
+  EXPECT_EQ(count<graph::Demodulator>(graph), 1);
+  EXPECT_EQ(count<graph::BurstDemodulator>(graph), 1);
+
+  const auto& bursts = find<graph::BurstDemodulator>(graph);
+  EXPECT_TRUE(std::holds_alternative<graph::ChannelFilter>(graph.nodes_[bursts.inputs_[0].node_].data_));
+  EXPECT_EQ(bursts.item_size_, udp_frame::kHeaderSize + udp_frame::kBurstHeaderSize + udp_frame::kMaxBurstBits);
+  EXPECT_EQ(graph.consumers(bursts.inputs_[0]).size(), 2);
+}
+
+TEST(graph, datagram_size) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+
+		[DecimateA.Export]
+		Host = "10.0.0.2"
+		Port = 43000
+
+		[Stream0]
+		Frequency = 4100000
+		Port = 42000
+		Mode = "uplink"
+
+		[Stream1]
+		Frequency = 4100000
+		Port = 42001
+		SendSoftBits = true
+
+		[Stream2]
+		Frequency = 4150000
+		Port = 42002
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // every frame is sent in a datagram of its own, the bits are packed
+  std::map<uint16_t, std::size_t> sizes;
+  for (const auto& node : graph.nodes_) {
+    if (std::holds_alternative<graph::UdpSink>(node.data_)) {
+      sizes[std::get<graph::UdpSink>(node.data_).port_] = graph::datagram_size(graph, node);
+    }
+  }
+  EXPECT_EQ(sizes.size(), 4);
+  EXPECT_EQ(sizes.at(42000), udp_frame::kHeaderSize + udp_frame::kBurstHeaderSize + udp_frame::kMaxBurstBits);
+  EXPECT_EQ(sizes.at(42001), udp_frame::kHeaderSize + udp_frame::kSoftBitsPerFrame);
+  EXPECT_EQ(sizes.at(42002), udp_frame::kMaxFrameSize);
+  EXPECT_EQ(sizes.at(43000), udp_frame::kHeaderSize + udp_frame::kComplexFloat32PerFrame * sizeof(float) * 2);
+}
+
+TEST(graph, stream_not_divisible) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+		BatchDemodulators = true
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 230000
+
+		[DecimateA.Stream0]
+		Frequency = 4300000
+
+		[DecimateA.Stream1]
+		Frequency = 4200000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+  EXPECT_EQ(graph::partition(graph, /*threads=*/4), 4);
+
+  // the filters of the streams decimate by 9 and the demodulators resample the rest, so they are not batched
+  EXPECT_EQ(count<graph::BatchDemodulator>(graph), 0);
+  EXPECT_EQ(count<graph::Demodulator>(graph), 2);
+  for (const auto& node : graph.nodes_) {
+    const auto* filter = std::get_if<graph::ChannelFilter>(&node.data_);
+    if (filter != nullptr && node.name_ != "DecimateA") {
+      EXPECT_EQ(filter->decimation_, 9);
+      EXPECT_DOUBLE_EQ(node.sample_rate_, 230000.0 / 9);
+      EXPECT_NE(node.partition_, graph.nodes_.at(node.inputs_.at(0).node_).partition_);
+    }
+  }
+}
+
+TEST(graph, batch_demodulators) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+		BatchDemodulators = true
+
+		[Prometheus]
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+
+		[DecimateA.Stream0]
+		Frequency = 4200000
+
+		[DecimateA.Stream1]
+		Frequency = 4250000
+		SendIQ = true
+
+		[DecimateA.Stream2]
+		Frequency = 4300000
+		SendSoftBits = true
+
+		[DecimateA.Stream3]
+		Frequency = 4350000
+		Mode = "uplink"
+
+		[Stream4]
+		Frequency = 4100000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the downlink streams of the decimator share one batch, the single stream of the source and the uplink do not
+  EXPECT_EQ(count<graph::BatchDemodulator>(graph), 1);
+  EXPECT_EQ(count<graph::Demodulator>(graph), 1);
+  EXPECT_EQ(count<graph::BurstDemodulator>(graph), 1);
+
+  const auto& batch = find<graph::BatchDemodulator>(graph);
+  EXPECT_EQ(std::get<graph::BatchDemodulator>(batch.data_).lanes_, 3);
+  ASSERT_EQ(batch.inputs_.size(), 3);
+  for (const auto& input : batch.inputs_) {
+    const auto& filter = graph.nodes_[input.node_];
+    EXPECT_TRUE(std::holds_alternative<graph::ChannelFilter>(filter.data_));
+    EXPECT_EQ(filter.inputs_, graph.nodes_[batch.inputs_[0].node_].inputs_);
+  }
+
+  // the consumers of each demodulator moved to its output of the batch
+  const auto batch_id = static_cast<graph::NodeId>(&batch - graph.nodes_.data());
+  for (unsigned int lane = 0; lane < 3; lane++) {
+    EXPECT_FALSE(graph.consumers(graph::Port{batch_id, lane}).empty()) << "lane " << lane;
+  }
+
+  // the compaction restored the topological order
+  for (graph::NodeId id = 0; id < graph.nodes_.size(); id++) {
+    for (const auto& input : graph.nodes_[id].inputs_) {
+      EXPECT_LT(input.node_, id);
+    }
+  }
+}
+
+TEST(graph, drop_unused_null_sinks) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the decimator without streams keeps its null sink, the source is consumed by the decimator
+  EXPECT_EQ(count<graph::NullSink>(graph), 1);
+  const auto& null_sink = find<graph::NullSink>(graph);
+  EXPECT_TRUE(std::holds_alternative<graph::ChannelFilter>(graph.nodes_[null_sink.inputs_[0].node_].data_));
+}
+
+TEST(graph, select_filter_implementations) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		InputFile = "samples.cu8"
+		SampleFormat = "cu8"
+		SampleRate = 1000000
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+
+		[DecimateA.Stream0]
+		Frequency = 4250000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the filter on the native samples uses the integer kernels, the one after it decimates by 20 in a cascade
+  std::vector<graph::FilterImplementation> implementations;
+  for (const auto& node : graph.nodes_) {
+    if (const auto* filter = std::get_if<graph::ChannelFilter>(&node.data_)) {
+      implementations.push_back(filter->implementation_);
+    }
+  }
+  ASSERT_EQ(implementations.size(), 2);
+  EXPECT_EQ(implementations[0], graph::FilterImplementation::kIntegerXlatingFir);
+  EXPECT_EQ(implementations[1], graph::FilterImplementation::kMultistage);
+}
+
+TEST(graph, select_multistage_for_large_composite_decimations) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 420000000
+		DeviceString = "device_string_abc"
+		SampleRate = 10400000
+
+		[DecimateA]
+		Frequency = 420000000
+		SampleRate = 2600000
+
+		[DecimateB]
+		Frequency = 420000000
+		SampleRate = 800000
+
+		[DecimateC]
+		Frequency = 420000000
+		SampleRate = 208000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // a decimation by 4 is too small, 13 is prime and 50 is split into a cascade
+  for (const auto& node : graph.nodes_) {
+    if (const auto* filter = std::get_if<graph::ChannelFilter>(&node.data_)) {
+      if (filter->decimation_ == 50) {
+        EXPECT_EQ(filter->implementation_, graph::FilterImplementation::kMultistage);
+      } else {
+        EXPECT_EQ(filter->implementation_, graph::FilterImplementation::kFreqXlatingFir);
+      }
+    }
+  }
+  EXPECT_EQ(count<graph::ChannelFilter>(graph), 3);
+}
+
+TEST(graph, ring_buffer_after_source) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Prometheus]
+
+		[SourceBuffer]
+		Seconds = 2.0
+
+		[Stream0]
+		Frequency = 4100000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the ring buffer decouples the source from everything else, the samples are tagged after it
+  ASSERT_GE(graph.nodes_.size(), 3);
+  EXPECT_TRUE(std::holds_alternative<graph::Source>(graph.nodes_[0].data_));
+  EXPECT_TRUE(std::holds_alternative<graph::RingBuffer>(graph.nodes_[1].data_));
+  EXPECT_TRUE(std::holds_alternative<graph::TimestampTagger>(graph.nodes_[2].data_));
+  EXPECT_EQ(graph.consumers(0), std::vector<graph::NodeId>({1}));
+  EXPECT_EQ(std::get<graph::RingBuffer>(graph.nodes_[1].data_).seconds_, 2.0);
+  EXPECT_EQ(graph.nodes_[1].item_size_, graph.nodes_[0].item_size_);
+}
+
+TEST(graph, export_decimated_samples) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 420000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[DecimateA]
+		Frequency = 420250000
+		SampleRate = 500000
+
+		[DecimateA.Export]
+		Host = "10.0.0.2"
+		Port = 43000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the exported samples are framed and sent to the port, which replaces the null sink of the decimator
+  EXPECT_EQ(count<graph::NullSink>(graph), 0);
+  const auto& framer = find<graph::IqFramer>(graph);
+  EXPECT_TRUE(std::holds_alternative<graph::ChannelFilter>(graph.nodes_[framer.inputs_[0].node_].data_));
+  EXPECT_EQ(framer.item_size_, udp_frame::kHeaderSize + udp_frame::kComplexFloat32PerFrame * sizeof(float) * 2);
+  EXPECT_DOUBLE_EQ(framer.sample_rate_ * udp_frame::kComplexFloat32PerFrame, 500000);
+
+  const auto& sink = find<graph::UdpSink>(graph);
+  EXPECT_EQ(std::get<graph::UdpSink>(sink.data_).host_, "10.0.0.2");
+  EXPECT_EQ(std::get<graph::UdpSink>(sink.data_).port_, 43000);
+}
+
+TEST(graph, import_samples_from_input_port) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 420250000
+		SampleRate = 500000
+		InputPort = 43000
+
+		[Stream0]
+		Frequency = 420250000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  const auto& source = find<graph::Source>(graph);
+  EXPECT_EQ(std::get<graph::Source>(source.data_).input_port_, 43000);
+  EXPECT_EQ(source.sample_format_, config::SampleFormat::kComplexFloat32);
+  EXPECT_NE(graph::to_string(graph).find("input_port=43000"), std::string::npos);
+}
+
+TEST(graph, scan) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 420000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+		ThreadPool = true
+
+		[ScanA]
+		Frequencies = [ 419900000, 419925000, 420100000, 420125000, 420300000 ]
+		Slots = 2
+		Host = "10.0.0.2"
+		Port = 43000
+
+		[DecimateA]
+		Frequency = 420250000
+		SampleRate = 500000
+
+		[DecimateA.ScanB]
+		Frequencies = [ 420200000, 420300000 ]
+		Slots = 1
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // each slot has a chain of its own, which sends frames of soft bits
+  EXPECT_EQ(count<graph::ScanFilter>(graph), 3);
+  EXPECT_EQ(count<graph::Demodulator>(graph), 3);
+  EXPECT_EQ(count<graph::ScanProbe>(graph), 3);
+  EXPECT_EQ(count<graph::SoftBitFramer>(graph), 3);
+  EXPECT_EQ(count<graph::UdpSink>(graph), 3);
+
+  // the slots of a scan share its scheduler
+  std::map<std::string, std::set<std::size_t>> scan_ids;
+  for (const auto& node : graph.nodes_) {
+    const auto* filter = std::get_if<graph::ScanFilter>(&node.data_);
+    if (filter == nullptr) {
+      continue;
+    }
+
+    scan_ids[node.name_].insert(filter->scan_id_);
+    const auto& input = graph.nodes_[node.inputs_[0].node_];
+    EXPECT_EQ(node.sample_rate_, config::kTetraSampleRate);
+    if (node.name_ == "ScanA") {
+      // the slots start on the first carriers
+      EXPECT_EQ(node.center_frequency_, filter->slot_ == 0 ? 419900000 : 419925000);
+      EXPECT_TRUE(std::holds_alternative<graph::Source>(input.data_));
+    } else {
+      EXPECT_EQ(filter->scan_.decimation_, 20);
+      EXPECT_TRUE(std::holds_alternative<graph::ChannelFilter>(input.data_));
+    }
+  }
+  ASSERT_EQ(scan_ids["ScanA"].size(), 1);
+  ASSERT_EQ(scan_ids["ScanB"].size(), 1);
+  EXPECT_NE(*scan_ids["ScanA"].begin(), *scan_ids["ScanB"].begin());
+
+  // the scan filters are filters, so they do not join the partition of the source or the decimator
+  graph::partition(graph, /*threads=*/8);
+  for (const auto& node : graph.nodes_) {
+    if (std::holds_alternative<graph::ScanFilter>(node.data_)) {
+      EXPECT_GE(*node.partition_, 2);
+    }
+  }
+  EXPECT_NE(graph::to_string(graph).find("slot=1/2"), std::string::npos);
+}
+
+TEST(graph, scan_native_samples) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 420000000
+		SampleRate = 1000000
+		InputFile = "samples.cs16"
+		SampleFormat = "cs16"
+
+		[ScanA]
+		Frequencies = [ 419900000, 420100000 ]
+		Slots = 1
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the scan filter retunes a rotator on complex floats
+  const auto& filter = find<graph::ScanFilter>(graph);
+  EXPECT_TRUE(std::holds_alternative<graph::NativeToComplex>(graph.nodes_[filter.inputs_[0].node_].data_));
+}
+
+TEST(graph, partition) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Prometheus]
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+
+		[DecimateA.Stream0]
+		Frequency = 4200000
+
+		[DecimateA.Stream1]
+		Frequency = 4250000
+
+		[DecimateA.Stream2]
+		Frequency = 4300000
+
+		[Stream3]
+		Frequency = 4100000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the source and the decimator are dedicated, the four chains share the two remaining threads
+  ASSERT_EQ(graph::partition(graph, /*threads=*/4), 4);
+
+  const auto& source = find<graph::Source>(graph);
+  EXPECT_EQ(source.partition_, 0);
+  EXPECT_EQ(find<graph::TimestampTagger>(graph).partition_, 0);
+
+  std::vector<std::size_t> chains(4, 0);
+  for (const auto& node : graph.nodes_) {
+    ASSERT_TRUE(node.partition_) << node.name_;
+    if (node.name_ == "DecimateA") {
+      EXPECT_EQ(node.partition_, 1);
+      continue;
+    }
+    if (node.name_ == "src") {
+      EXPECT_EQ(node.partition_, 0);
+      continue;
+    }
+
+    // all nodes of a stream are in the worker partition of its filter
+    const auto& filter = *std::find_if(graph.nodes_.begin(), graph.nodes_.end(), [&node](const graph::Node& other) {
+      return other.name_ == node.name_ && std::holds_alternative<graph::ChannelFilter>(other.data_);
+    });
+    EXPECT_EQ(node.partition_, filter.partition_) << node.name_;
+    EXPECT_GE(*node.partition_, 2) << node.name_;
+    if (&node == &filter) {
+      chains[*node.partition_]++;
+    }
+  }
+
+  // the expensive stream on the source gets the first worker with one of the cheaper streams of the decimator
+  const auto& stream = *std::find_if(graph.nodes_.begin(), graph.nodes_.end(),
+                                     [](const graph::Node& node) { return node.name_ == "Stream3"; });
+  EXPECT_EQ(stream.partition_, 2);
+  EXPECT_EQ(chains[2], 2);
+  EXPECT_EQ(chains[3], 2);
+  EXPECT_NE(graph::to_string(graph).find(" partition=3"), std::string::npos);
+
+  // there is always one worker
+  EXPECT_EQ(graph::partition(graph, /*threads=*/1), 3);
+  for (const auto& node : graph.nodes_) {
+    EXPECT_LT(*node.partition_, 3);
+  }
+}
+
+TEST(graph, partition_source_buffer) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Prometheus]
+
+		[SourceBuffer]
+		Seconds = 1.0
+
+		[Stream0]
+		Frequency = 4100000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the reading side of the ring blocks while it is empty, so it never runs in the thread of the source
+  EXPECT_EQ(graph::partition(graph, /*threads=*/4), 3);
+  const auto& source = find<graph::Source>(graph);
+  const auto& ring_buffer = find<graph::RingBuffer>(graph);
+  ASSERT_TRUE(source.partition_);
+  ASSERT_TRUE(ring_buffer.partition_);
+  EXPECT_NE(source.partition_, ring_buffer.partition_);
+
+  // the timestamp tagger only consumes the ring, so it runs in its thread
+  EXPECT_EQ(find<graph::TimestampTagger>(graph).partition_, ring_buffer.partition_);
+  EXPECT_NE(find<graph::ChannelFilter>(graph).partition_, source.partition_);
+}
+
+TEST(graph, partition_batch_demodulators) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+		BatchDemodulators = true
+
+		[DecimateA]
+		Frequency = 4250000
+		SampleRate = 500000
+
+		[DecimateA.Stream0]
+		Frequency = 4200000
+
+		[DecimateA.Stream1]
+		Frequency = 4300000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  // the streams share the batch, so they run in the same worker
+  EXPECT_EQ(graph::partition(graph, /*threads=*/8), 3);
+  const auto& batch = find<graph::BatchDemodulator>(graph);
+  EXPECT_EQ(batch.partition_, 2);
+  for (const auto& input : batch.inputs_) {
+    EXPECT_EQ(graph.nodes_[input.node_].partition_, 2);
+  }
+}
+
+TEST(graph, compact) {
+  graph::Graph graph;
+  const auto source =
+      graph.add(graph::Node("src", graph::Source{}, {}, 1000, 100, config::SampleFormat::kComplexFloat32));
+  const auto sink = graph.add(graph::Node("src", graph::NullSink{}, {graph::Port{source}}, 1000, 0, /*item_size=*/0));
+  graph.add(graph::Node("src", graph::NullSink{}, {graph::Port{source}}, 1000, 0, /*item_size=*/0));
+
+  graph.nodes_[sink].removed_ = true;
+  graph.compact();
+
+  ASSERT_EQ(graph.nodes_.size(), 2);
+  EXPECT_EQ(graph.nodes_[1].inputs_[0].node_, 0);
+
+  // inputs have to be added before their consumers
+  EXPECT_THROW(graph.add(graph::Node("src", graph::NullSink{}, {graph::Port{5}}, 1000, 0, /*item_size=*/0)),
+               std::invalid_argument);
+}
+
+TEST(graph, to_string) {
+  const toml::value config_object = u8R"(
+		CenterFrequency = 4000000
+		DeviceString = "device_string_abc"
+		SampleRate = 1000000
+
+		[Stream0]
+		Frequency = 4100000
+	)"_toml;
+
+  const config::TopLevel top = toml::get<config::TopLevel>(config_object);
+  auto graph = graph::from_config(top);
+  graph::optimize(graph);
+
+  const auto description = graph::to_string(graph);
+  EXPECT_NE(description.find("#0 Source \"src\""), std::string::npos);
+  EXPECT_NE(description.find("ChannelFilter \"Stream0\" <- #0:0"), std::string::npos);
+  EXPECT_NE(description.find("implementation=multistage"), std::string::npos);
+}
@@ -0,0 +1,32 @@
+#include <cstdint>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "huge_page_buffer.h"
+
+TEST(huge_page_buffer, normal_pages) {
+  HugePageBuffer buffer(/*size=*/1000, /*huge_pages=*/false);
+
+  EXPECT_FALSE(buffer.huge_pages());
+  // the size is rounded up to full pages
+  EXPECT_GE(buffer.size(), 1000);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.data()) % 4096, 0);
+
+  // the whole region is writable
+  std::memset(buffer.data(), 0xab, buffer.size());
+  EXPECT_EQ(static_cast<unsigned char*>(buffer.data())[buffer.size() - 1], 0xab);
+}
+
+TEST(huge_page_buffer, huge_pages_or_fallback) {
+  HugePageBuffer buffer(/*size=*/3 * 1024 * 1024, /*huge_pages=*/true);
+
+  // huge pages may not be available, in that case we fall back to normal pages
+  if (buffer.huge_pages()) {
+    EXPECT_EQ(buffer.size() % HugePageBuffer::kHugePageSize, 0);
+  }
+  EXPECT_GE(buffer.size(), 3 * 1024 * 1024);
+
+  std::memset(buffer.data(), 0xcd, buffer.size());
+  EXPECT_EQ(static_cast<unsigned char*>(buffer.data())[0], 0xcd);
+}
@@ -0,0 +1,113 @@
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "int16_kernels.h"
+
+/// Random interleaved IQ samples of the given length with a magnitude of up to max_sample
+static auto random_samples(const std::size_t length, const int16_t max_sample) -> std::vector<int16_t> {
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int16_t> distribution(-max_sample, max_sample);
+
+  std::vector<int16_t> samples(length);
+  for (auto& sample : samples) {
+    sample = distribution(generator);
+  }
+  return samples;
+}
+
+/// A low pass shifted to a quarter of the sample rate
+static auto shifted_low_pass(const std::size_t count) -> std::vector<std::complex<float>> {
+  std::vector<std::complex<float>> taps;
+  for (std::size_t i = 0; i < count; i++) {
+    const float n = static_cast<float>(i) - static_cast<float>(count - 1) / 2;
+    const float sinc = n == 0 ? 0.25f : std::sin(M_PI * 0.25f * n) / (M_PI * n);
+    taps.push_back(sinc * std::polar(1.0f, static_cast<float>(M_PI / 2 * i)));
+  }
+  return taps;
+}
+
+TEST(int16_kernels, QuantizedTaps_layout) {
+  const int16_kernels::QuantizedTaps taps({{0.5, 0.25}, {-1.0, 0.0}}, /*max_sample=*/1);
+
+  // the taps are padded to the block length
+  EXPECT_EQ(taps.length(), int16_kernels::kBlockLength);
+  // the largest tap is scaled to the int16 range
+  EXPECT_FLOAT_EQ(taps.scale_, 32767);
+
+  EXPECT_EQ(taps.re_[0], 16384);
+  EXPECT_EQ(taps.re_[1], -8192);
+  EXPECT_EQ(taps.im_[0], 8192);
+  EXPECT_EQ(taps.im_[1], 16384);
+  EXPECT_EQ(taps.re_[2], -32767);
+  EXPECT_EQ(taps.re_[4], 0);
+}
+
+TEST(int16_kernels, QuantizedTaps_no_overflow) {
+  const auto float_taps = shifted_low_pass(/*count=*/255);
+  const int16_kernels::QuantizedTaps taps(float_taps, /*max_sample=*/32768);
+
+  // the worst case sum of products still fits into int32
+  int64_t worst_case_re = 0;
+  int64_t worst_case_im = 0;
+  for (std::size_t i = 0; i < taps.length(); i++) {
+    worst_case_re += 32768 * std::abs(taps.re_[i]);
+    worst_case_im += 32768 * std::abs(taps.im_[i]);
+  }
+  EXPECT_LE(worst_case_re, std::numeric_limits<int32_t>::max());
+  EXPECT_LE(worst_case_im, std::numeric_limits<int32_t>::max());
+}
+
+TEST(int16_kernels, complex_dot_product_matches_float) {
+  const auto float_taps = shifted_low_pass(/*count=*/63);
+  const int16_kernels::QuantizedTaps taps(float_taps, /*max_sample=*/128);
+  const auto samples = random_samples(taps.length(), /*max_sample=*/127);
+
+  std::complex<float> expected = 0;
+  for (std::size_t i = 0; i < float_taps.size(); i++) {
+    expected += std::complex<float>(samples[2 * i], samples[2 * i + 1]) * float_taps[i];
+  }
+
+  int32_t re = 0;
+  int32_t im = 0;
+  int16_kernels::complex_dot_product_generic(samples.data(), taps.re_.data(), taps.im_.data(), taps.length(), &re,
+                                             &im);
+
+  EXPECT_NEAR(re / taps.scale_, expected.real(), 0.01 * std::abs(expected) + 0.1);
+  EXPECT_NEAR(im / taps.scale_, expected.imag(), 0.01 * std::abs(expected) + 0.1);
+}
+
+TEST(int16_kernels, complex_dot_product_simd_matches_generic) {
+  const auto float_taps = shifted_low_pass(/*count=*/127);
+  const int16_kernels::QuantizedTaps taps(float_taps, /*max_sample=*/2048);
+  const auto samples = random_samples(taps.length(), /*max_sample=*/2047);
+
+  int32_t expected_re = 0;
+  int32_t expected_im = 0;
+  int16_kernels::complex_dot_product_generic(samples.data(), taps.re_.data(), taps.im_.data(), taps.length(),
+                                             &expected_re, &expected_im);
+
+  int32_t re = 0;
+  int32_t im = 0;
+  int16_kernels::best_complex_dot_product()(samples.data(), taps.re_.data(), taps.im_.data(), taps.length(), &re, &im);
+
+  EXPECT_EQ(re, expected_re);
+  EXPECT_EQ(im, expected_im);
+}
+
+TEST(int16_kernels, widen) {
+  const std::vector<int8_t> cs8 = {-128, -1, 0, 127};
+  const std::vector<uint8_t> cu8 = {0, 127, 128, 255};
+  std::vector<int16_t> out(4);
+
+  int16_kernels::widen_cs8(cs8.data(), out.data(), out.size());
+  EXPECT_EQ(out, (std::vector<int16_t>{-128, -1, 0, 127}));
+
+  int16_kernels::widen_cu8(cu8.data(), out.data(), out.size());
+  EXPECT_EQ(out, (std::vector<int16_t>{-128, -1, 0, 127}));
+}
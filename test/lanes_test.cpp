@@ -0,0 +1,184 @@
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "lanes.h"
+
+static constexpr unsigned int kSampleRate = 25000;
+static constexpr unsigned int kSymbolRate = 18000;
+/// The rate at which the pulses are shaped, a multiple of the sample rate and the symbol rate
+static constexpr unsigned int kShapingRate = 900000;
+
+/// A continuous carrier with random π/4-DQPSK symbols shaped with the root raised cosine
+class Carrier {
+public:
+  /// the index of the phase change of each symbol: +π/4, +3π/4, -π/4 and -3π/4
+  std::vector<int> changes_;
+  /// the samples of the carrier
+  std::vector<std::complex<float>> samples_;
+};
+
+/// Modulate a carrier with a frequency offset, a delay of a fraction of a sample and an amplitude
+static auto modulate(const std::size_t count, const double frequency_offset, const double delay, const float amplitude,
+                     std::mt19937& generator) -> Carrier {
+  const auto shaping = kShapingRate / kSymbolRate;
+  const auto decimation = kShapingRate / kSampleRate;
+  const auto pulse = lanes::root_raised_cosine(kShapingRate, kSymbolRate, lanes::kRolloff, shaping * 16 + 1);
+  const std::vector<double> phase_changes = {M_PI / 4, 3 * M_PI / 4, -M_PI / 4, -3 * M_PI / 4};
+
+  Carrier carrier;
+  std::uniform_int_distribution<int> change(0, 3);
+  const auto symbols = count * kSymbolRate / kSampleRate + 32;
+  std::vector<std::complex<double>> shaped(symbols * shaping + pulse.size());
+  double phase = 0;
+  for (std::size_t symbol = 0; symbol < symbols; symbol++) {
+    carrier.changes_.push_back(change(generator));
+    phase += phase_changes[carrier.changes_.back()];
+    for (std::size_t i = 0; i < pulse.size(); i++) {
+      shaped[symbol * shaping + i] += std::polar(1.0, phase) * static_cast<double>(pulse[i]);
+    }
+  }
+
+  std::normal_distribution<float> noise(0, 0.02f * amplitude);
+  for (std::size_t i = 0; i < count; i++) {
+    const auto sample = shaped[static_cast<std::size_t>((i + delay) * decimation)] *
+                        std::polar(1.0, 2 * M_PI * frequency_offset * i / kSampleRate);
+    carrier.samples_.emplace_back(static_cast<float>(sample.real()) * amplitude + noise(generator),
+                                  static_cast<float>(sample.imag()) * amplitude + noise(generator));
+  }
+
+  return carrier;
+}
+
+/// The index of the phase change of a differentially decoded symbol
+static auto decide(const std::complex<float> symbol) -> int {
+  const auto angle = std::arg(symbol);
+  if (angle > 0) {
+    return angle < M_PI / 2 ? 0 : 1;
+  }
+  return angle > -M_PI / 2 ? 2 : 3;
+}
+
+/// Demodulate the carriers in blocks
+static auto demodulate(lanes::Demodulator& demodulator, const std::vector<Carrier>& carriers, const std::size_t block)
+    -> std::vector<std::vector<std::complex<float>>> {
+  const auto count = carriers.front().samples_.size();
+  std::vector<std::vector<std::complex<float>>> symbols(carriers.size());
+  std::vector<const std::complex<float>*> inputs(carriers.size());
+  std::vector<std::complex<float>*> outputs(carriers.size());
+  std::vector<std::size_t> produced(carriers.size());
+  std::vector<std::vector<std::complex<float>>> buffers(
+      carriers.size(), std::vector<std::complex<float>>(demodulator.max_symbols(block)));
+
+  for (std::size_t offset = 0; offset < count; offset += block) {
+    const auto length = std::min(block, count - offset);
+    for (std::size_t lane = 0; lane < carriers.size(); lane++) {
+      inputs[lane] = carriers[lane].samples_.data() + offset;
+      outputs[lane] = buffers[lane].data();
+    }
+    demodulator.process(inputs.data(), length, outputs.data(), produced.data());
+    for (std::size_t lane = 0; lane < carriers.size(); lane++) {
+      EXPECT_LE(produced[lane], demodulator.max_symbols(length));
+      symbols[lane].insert(symbols[lane].end(), buffers[lane].begin(), buffers[lane].begin() + produced[lane]);
+    }
+  }
+
+  return symbols;
+}
+
+/// The number of wrong decisions in the second half of the symbols at the alignment with the fewest of them
+static auto symbol_errors(const std::vector<std::complex<float>>& symbols, const Carrier& carrier) -> std::size_t {
+  std::size_t min_errors = symbols.size();
+  for (int lag = -64; lag < 64; lag++) {
+    std::size_t errors = 0;
+    for (std::size_t i = symbols.size() / 2; i < symbols.size(); i++) {
+      const auto change = static_cast<long>(i) + lag;
+      if (change < 0 || change >= static_cast<long>(carrier.changes_.size())) {
+        errors++;
+        continue;
+      }
+      errors += decide(symbols[i]) != carrier.changes_[change];
+    }
+    min_errors = std::min(min_errors, errors);
+  }
+  return min_errors;
+}
+
+TEST(lanes, root_raised_cosine) {
+  const auto taps = lanes::root_raised_cosine(/*sample_rate=*/72000, kSymbolRate, lanes::kRolloff, /*taps=*/45);
+
+  const auto energy = std::inner_product(taps.begin(), taps.end(), taps.begin(), 0.0);
+  EXPECT_NEAR(energy, 1, 1e-6);
+  for (std::size_t i = 0; i < taps.size(); i++) {
+    EXPECT_FLOAT_EQ(taps[i], taps[taps.size() - 1 - i]);
+  }
+  EXPECT_EQ(std::max_element(taps.begin(), taps.end()) - taps.begin(), 22);
+}
+
+TEST(lanes, demodulate_carriers) {
+  std::mt19937 generator(/*seed=*/42);
+  const std::size_t count = 40000;
+  const std::vector<double> frequency_offsets = {300, -1500, 0};
+  const std::vector<Carrier> carriers = {
+      modulate(count, frequency_offsets[0], /*delay=*/0.3, /*amplitude=*/1, generator),
+      modulate(count, frequency_offsets[1], /*delay=*/0.7, /*amplitude=*/0.01f, generator),
+      modulate(count, frequency_offsets[2], /*delay=*/0, /*amplitude=*/100, generator),
+  };
+
+  lanes::Demodulator demodulator(carriers.size(), kSampleRate, kSymbolRate);
+  const auto symbols = demodulate(demodulator, carriers, /*block=*/1000);
+
+  for (std::size_t lane = 0; lane < carriers.size(); lane++) {
+    EXPECT_NEAR(symbols[lane].size(), count * kSymbolRate / kSampleRate, 2) << "lane " << lane;
+    EXPECT_EQ(symbol_errors(symbols[lane], carriers[lane]), 0) << "lane " << lane;
+    EXPECT_NEAR(demodulator.frequency_offset(lane), frequency_offsets[lane], 20) << "lane " << lane;
+  }
+}
+
+TEST(lanes, simd_matches_generic) {
+  std::mt19937 generator(/*seed=*/42);
+  std::vector<Carrier> carriers;
+  // more carriers than one block of lanes
+  for (std::size_t lane = 0; lane < lanes::kLaneBlock + 3; lane++) {
+    carriers.push_back(modulate(/*count=*/5000, /*frequency_offset=*/100.0 * lane, /*delay=*/0.05 * lane,
+                                /*amplitude=*/1, generator));
+  }
+
+  lanes::Demodulator generic(carriers.size(), kSampleRate, kSymbolRate, lanes::process_generic);
+  lanes::Demodulator best(carriers.size(), kSampleRate, kSymbolRate, lanes::best_kernel());
+  const auto expected = demodulate(generic, carriers, /*block=*/777);
+  const auto symbols = demodulate(best, carriers, /*block=*/777);
+
+  for (std::size_t lane = 0; lane < carriers.size(); lane++) {
+    ASSERT_EQ(symbols[lane].size(), expected[lane].size()) << "lane " << lane;
+    for (std::size_t i = 0; i < symbols[lane].size(); i++) {
+      EXPECT_NEAR(symbols[lane][i].real(), expected[lane][i].real(), 1e-4);
+      EXPECT_NEAR(symbols[lane][i].imag(), expected[lane][i].imag(), 1e-4);
+    }
+  }
+}
+
+TEST(lanes, max_samples) {
+  lanes::Demodulator demodulator(/*lanes=*/1, kSampleRate, kSymbolRate);
+
+  EXPECT_EQ(demodulator.max_samples(0), 0);
+  for (std::size_t symbols = 1; symbols < 1000; symbols += 7) {
+    const auto samples = demodulator.max_samples(symbols);
+    EXPECT_LE(demodulator.max_symbols(samples), symbols);
+    if (symbols > 20) {
+      EXPECT_GT(samples, symbols);
+    }
+  }
+}
+
+TEST(lanes, invalid_arguments) {
+  EXPECT_THROW(lanes::Demodulator(/*lanes=*/0, kSampleRate, kSymbolRate), std::invalid_argument);
+  EXPECT_THROW(lanes::Demodulator(/*lanes=*/1, /*input_sample_rate=*/0, kSymbolRate), std::invalid_argument);
+  // 36001 and 36000 have no common divisor that keeps the number of phases small
+  EXPECT_THROW(lanes::Demodulator(/*lanes=*/1, /*input_sample_rate=*/36001, kSymbolRate), std::invalid_argument);
+  lanes::Demodulator demodulator(/*lanes=*/2, kSampleRate, kSymbolRate);
+  EXPECT_THROW(static_cast<void>(demodulator.frequency_offset(2)), std::invalid_argument);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include "multistage.h"
+
+TEST(multistage, estimated_taps) {
+  // the same as firdes::compute_ntaps for the Hamming window
+  EXPECT_EQ(multistage::estimated_taps(1000000, 20000), 121);
+  EXPECT_EQ(multistage::estimated_taps(1000000, 1000000), 3);
+}
+
+TEST(multistage, plan_large_decimation) {
+  // a Decimate block from 10 MS/s to 200 kS/s
+  const double cutoff = 100000;
+  const double transition_width = 20000;
+  const auto stages = multistage::plan(10000000, 50, cutoff, transition_width);
+
+  ASSERT_GT(stages.size(), 1);
+  ASSERT_LE(stages.size(), multistage::kMaximumStages);
+
+  unsigned int decimation = 1;
+  double sample_rate = 10000000;
+  for (std::size_t i = 0; i < stages.size(); i++) {
+    const auto& stage = stages[i];
+    EXPECT_DOUBLE_EQ(stage.input_sample_rate_, sample_rate);
+    decimation *= stage.decimation_;
+    sample_rate /= stage.decimation_;
+
+    // the stages before the last pass the final passband and reject everything that aliases into the final band
+    if (i + 1 < stages.size()) {
+      EXPECT_GE(stage.cutoff_ - stage.transition_width_ / 2, cutoff - transition_width / 2 - 1e-6);
+      EXPECT_LE(stage.cutoff_ + stage.transition_width_ / 2, sample_rate - (cutoff + transition_width / 2) + 1e-6);
+    }
+  }
+  EXPECT_EQ(decimation, 50);
+
+  // the last stage is the low pass of the single stage filter at the reduced rate
+  EXPECT_DOUBLE_EQ(stages.back().cutoff_, cutoff);
+  EXPECT_DOUBLE_EQ(stages.back().transition_width_, transition_width);
+
+  // much cheaper than the single stage
+  const std::vector<multistage::Stage> single = {multistage::Stage{50, 10000000, cutoff, transition_width}};
+  EXPECT_LT(multistage::cost(stages) * 3, multistage::cost(single));
+}
+
+TEST(multistage, plan_prime_decimation) {
+  const auto stages = multistage::plan(1300000, 13, 50000, 10000);
+
+  ASSERT_EQ(stages.size(), 1);
+  EXPECT_EQ(stages[0].decimation_, 13);
+  EXPECT_DOUBLE_EQ(stages[0].cutoff_, 50000);
+}
+
+TEST(multistage, plan_invalid) {
+  EXPECT_THROW(multistage::plan(1000000, 0, 50000, 10000), std::invalid_argument);
+  EXPECT_THROW(multistage::plan(1000000, 8, 50000, 0), std::invalid_argument);
+}
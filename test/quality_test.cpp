@@ -0,0 +1,44 @@
+#include <cmath>
+#include <complex>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "quality.h"
+
+/// The differentially decoded symbols of the four phase changes
+static const std::complex<float> kSymbols[] = {std::polar(1.0f, static_cast<float>(M_PI / 4)),
+                                               std::polar(1.0f, static_cast<float>(3 * M_PI / 4)),
+                                               std::polar(1.0f, static_cast<float>(-M_PI / 4)),
+                                               std::polar(1.0f, static_cast<float>(-3 * M_PI / 4))};
+
+TEST(quality, ideal_symbols) {
+  quality::ConstellationError error;
+  for (std::size_t i = 0; i < 1000; i++) {
+    // the amplitude of the symbols does not matter
+    error.add(kSymbols[i % 4] * 42.0f);
+  }
+
+  EXPECT_EQ(error.count(), 1000);
+  EXPECT_NEAR(error.error_vector_magnitude(), 0, 0.01);
+  EXPECT_GT(error.modulation_error_ratio(), 60);
+}
+
+TEST(quality, noisy_symbols) {
+  std::mt19937 generator(/*seed=*/42);
+  // the error vectors have a power of 2 * 0.1² = 0.02, i.e. 17 dB below the symbols
+  std::normal_distribution<float> noise(0, 0.1f);
+
+  quality::ConstellationError error;
+  for (std::size_t i = 0; i < 100000; i++) {
+    error.add((kSymbols[i % 4] + std::complex<float>(noise(generator), noise(generator))) * 0.01f);
+  }
+
+  EXPECT_NEAR(error.modulation_error_ratio(), 10 * std::log10(1 / 0.02), 0.2);
+  EXPECT_NEAR(error.error_vector_magnitude(), 100 * std::sqrt(0.02), 0.5);
+  EXPECT_NEAR(error.signal_to_noise_ratio(), error.modulation_error_ratio() + 3.01, 0.01);
+
+  error.reset();
+  EXPECT_EQ(error.count(), 0);
+  EXPECT_TRUE(std::isnan(error.modulation_error_ratio()));
+}
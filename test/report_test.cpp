@@ -0,0 +1,110 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "report.h"
+
+TEST(report, json_round_trip) {
+  const std::vector<BenchmarkResult> results = {
+      BenchmarkResult{/*name=*/"channel_filter_25k", /*items=*/2000000, /*ns_per_item=*/3.25},
+      BenchmarkResult{/*name=*/"demodulator", /*items=*/25000, /*ns_per_item=*/112.5},
+  };
+
+  const auto json = to_json(results, /*gnuradio_version=*/"3.8.2.0", /*volk_machine=*/"avx2_64_mmx_orc");
+  EXPECT_NE(json.find("\"gnuradio_version\": \"3.8.2.0\""), std::string::npos);
+  EXPECT_NE(json.find("\"volk_machine\": \"avx2_64_mmx_orc\""), std::string::npos);
+
+  const auto parsed = from_json(json);
+  ASSERT_EQ(parsed.size(), 2);
+  for (std::size_t i = 0; i < parsed.size(); i++) {
+    EXPECT_EQ(parsed[i].name_, results[i].name_);
+    EXPECT_EQ(parsed[i].items_, results[i].items_);
+    EXPECT_DOUBLE_EQ(parsed[i].ns_per_item_, results[i].ns_per_item_);
+  }
+}
+
+TEST(report, parse_baseline) {
+  // a baseline as written by --update-baseline
+  const std::string json = R"({
+  "gnuradio_version": "3.8.2.0",
+  "volk_machine": "avx2_64_mmx_orc",
+  "benchmarks": [
+    {"name": "resampler_0.9", "items": 300000, "ns_per_item": 41.7, "items_per_second": 2.39808e+07},
+    {"name": "power_meter", "items": 25000, "ns_per_item": 1.5e-01, "items_per_second": 6.66667e+09}
+  ]
+}
+)";
+
+  const auto baseline = from_json(json);
+  ASSERT_EQ(baseline.size(), 2);
+  EXPECT_EQ(baseline[0].name_, "resampler_0.9");
+  EXPECT_EQ(baseline[0].items_, 300000);
+  EXPECT_DOUBLE_EQ(baseline[0].ns_per_item_, 41.7);
+  EXPECT_EQ(baseline[1].name_, "power_meter");
+  EXPECT_DOUBLE_EQ(baseline[1].ns_per_item_, 0.15);
+
+  // a run without benchmarks is a valid baseline
+  EXPECT_TRUE(from_json(to_json({}, "3.8.2.0", "generic")).empty());
+}
+
+TEST(report, invalid_baseline) {
+  // not a baseline at all
+  EXPECT_THROW(from_json(""), std::invalid_argument);
+  EXPECT_THROW(from_json("{\"results\": []}"), std::invalid_argument);
+
+  // a benchmark without its time
+  const std::string json = R"({
+  "benchmarks": [
+    {"name": "demodulator", "items": 25000}
+  ]
+})";
+  EXPECT_THROW(from_json(json), std::invalid_argument);
+}
+
+TEST(report, missing_benchmark) {
+  const std::vector<BenchmarkResult> baseline = {
+      BenchmarkResult{/*name=*/"demodulator", /*items=*/25000, /*ns_per_item=*/100},
+      BenchmarkResult{/*name=*/"removed", /*items=*/25000, /*ns_per_item=*/10},
+  };
+  const std::vector<BenchmarkResult> results = {
+      BenchmarkResult{/*name=*/"demodulator", /*items=*/25000, /*ns_per_item=*/100},
+      BenchmarkResult{/*name=*/"new", /*items=*/25000, /*ns_per_item=*/1000},
+  };
+
+  // a new benchmark has no baseline and is no regression, a benchmark that only the baseline has is ignored
+  const auto comparisons = compare(results, baseline, /*tolerance=*/0.1);
+  ASSERT_EQ(comparisons.size(), 2);
+  EXPECT_EQ(comparisons[0].name_, "demodulator");
+  EXPECT_TRUE(comparisons[0].baseline_ns_per_item_);
+  EXPECT_EQ(comparisons[1].name_, "new");
+  EXPECT_FALSE(comparisons[1].baseline_ns_per_item_);
+  EXPECT_FALSE(comparisons[1].regression_);
+}
+
+TEST(report, regression_threshold) {
+  const std::vector<BenchmarkResult> baseline = {
+      BenchmarkResult{/*name=*/"faster", /*items=*/1, /*ns_per_item=*/100},
+      BenchmarkResult{/*name=*/"within", /*items=*/1, /*ns_per_item=*/100},
+      BenchmarkResult{/*name=*/"at", /*items=*/1, /*ns_per_item=*/100},
+      BenchmarkResult{/*name=*/"beyond", /*items=*/1, /*ns_per_item=*/100},
+  };
+  const std::vector<BenchmarkResult> results = {
+      BenchmarkResult{/*name=*/"faster", /*items=*/1, /*ns_per_item=*/50},
+      BenchmarkResult{/*name=*/"within", /*items=*/1, /*ns_per_item=*/105},
+      BenchmarkResult{/*name=*/"at", /*items=*/1, /*ns_per_item=*/110},
+      BenchmarkResult{/*name=*/"beyond", /*items=*/1, /*ns_per_item=*/110.5},
+  };
+
+  // only a stage that got slower by more than the tolerance is a regression
+  const auto comparisons = compare(results, baseline, /*tolerance=*/0.1);
+  ASSERT_EQ(comparisons.size(), 4);
+  EXPECT_FALSE(comparisons[0].regression_);
+  EXPECT_FALSE(comparisons[1].regression_);
+  EXPECT_FALSE(comparisons[2].regression_);
+  EXPECT_TRUE(comparisons[3].regression_);
+  EXPECT_DOUBLE_EQ(*comparisons[3].baseline_ns_per_item_, 100);
+
+  // without tolerance every slowdown is a regression
+  EXPECT_TRUE(compare(results, baseline, /*tolerance=*/0)[1].regression_);
+}
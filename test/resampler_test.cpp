@@ -0,0 +1,46 @@
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "config.h"
+#include "resampler.h"
+
+static constexpr unsigned int kFilters = 32;
+
+/// The gain in dB of the prototype at a frequency in units of the input sample rate of the resampler
+static auto gain(const std::vector<float>& taps, const double frequency) -> double {
+  std::complex<double> sum = 0;
+  for (std::size_t n = 0; n < taps.size(); n++) {
+    sum += static_cast<double>(taps[n]) * std::polar(1.0, -2 * M_PI * frequency / kFilters * static_cast<double>(n));
+  }
+  // each filter has unit gain, so the prototype has a gain of the number of filters
+  return 20 * std::log10(std::abs(sum) / kFilters);
+}
+
+TEST(resampler, passband_edge) {
+  // a Decimate block of 300 kS/s from 1 MS/s decimates by 3 and resamples by 0.9
+  for (const auto rate : {0.9, 0.6, 0.3}) {
+    const auto taps = resampler::taps(kFilters, rate, config::kResamplerPassband);
+    EXPECT_EQ(taps.size() % 2, 1);
+    EXPECT_NEAR(gain(taps, 0), 0, 1e-3) << "rate " << rate;
+
+    // a stream at the edge of the accepted band is passed
+    const auto edge = config::kResamplerPassband / 2 * rate;
+    for (double frequency = 0; frequency <= edge; frequency += edge / 20) {
+      EXPECT_NEAR(gain(taps, frequency), 0, 0.05) << "rate " << rate << " frequency " << frequency;
+    }
+
+    // everything that aliases into the accepted band is attenuated
+    for (double frequency = rate - edge; frequency < 4 * rate; frequency += rate / 50) {
+      EXPECT_LT(gain(taps, frequency), -80) << "rate " << rate << " frequency " << frequency;
+    }
+  }
+}
+
+TEST(resampler, invalid_arguments) {
+  EXPECT_THROW(resampler::taps(/*filters=*/0, 0.9, config::kResamplerPassband), std::invalid_argument);
+  EXPECT_THROW(resampler::taps(kFilters, /*rate=*/1.0, config::kResamplerPassband), std::invalid_argument);
+  EXPECT_THROW(resampler::taps(kFilters, 0.9, /*passband=*/0), std::invalid_argument);
+}
@@ -0,0 +1,105 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ring_recording.h"
+
+static constexpr uint64_t kChunk = 4;
+static constexpr uint64_t kCapacity = 4 * kChunk;
+
+/// A ring of sample numbers whose writer never waits, like the one of the IqRingRecorder
+class Ring {
+public:
+  std::vector<uint64_t> samples_ = std::vector<uint64_t>(kCapacity);
+  uint64_t written_ = 0;
+
+  auto write(const uint64_t count) -> void {
+    for (uint64_t i = 0; i < count; i++, written_++) {
+      samples_[written_ % kCapacity] = written_;
+    }
+  }
+};
+
+/// Read a chunk and let the writer write some samples while the chunk is read
+static auto read(Ring& ring, const RingRecording::Chunk& chunk, const uint64_t written_meanwhile)
+    -> std::vector<uint64_t> {
+  std::vector<uint64_t> samples;
+  for (uint64_t i = 0; i < chunk.count_; i++) {
+    if (i == chunk.count_ / 2) {
+      ring.write(written_meanwhile);
+    }
+    samples.push_back(ring.samples_[(chunk.position_ + i) % kCapacity]);
+  }
+  return samples;
+}
+
+TEST(ring_recording, records_all_samples) {
+  Ring ring;
+  RingRecording recording(kCapacity, kChunk, /*start=*/0, /*end=*/10);
+  std::vector<uint64_t> recorded;
+
+  while (!recording.finished()) {
+    const auto chunk = recording.next(ring.written_);
+    if (!chunk) {
+      // the writer has not written a full chunk yet
+      ring.write(3);
+      continue;
+    }
+    const auto samples = read(ring, *chunk, /*written_meanwhile=*/1);
+    ASSERT_TRUE(recording.commit(*chunk, ring.written_));
+    recorded.insert(recorded.end(), samples.begin(), samples.end());
+  }
+
+  EXPECT_FALSE(recording.lapped());
+  EXPECT_EQ(recording.recorded(), 10);
+  EXPECT_EQ(recording.dropped(), 0);
+  for (uint64_t i = 0; i < recorded.size(); i++) {
+    EXPECT_EQ(recorded[i], i);
+  }
+}
+
+TEST(ring_recording, slow_writer_is_lapped) {
+  Ring ring;
+  ring.write(2 * kChunk);
+  RingRecording recording(kCapacity, kChunk, /*start=*/0, /*end=*/6 * kChunk);
+
+  // the first chunk is read in time
+  auto chunk = recording.next(ring.written_);
+  ASSERT_TRUE(chunk);
+  read(ring, *chunk, /*written_meanwhile=*/0);
+  EXPECT_TRUE(recording.commit(*chunk, ring.written_));
+
+  // the second chunk is still in the ring when the read starts, but the writer laps it while it is read
+  chunk = recording.next(ring.written_);
+  ASSERT_TRUE(chunk);
+  EXPECT_EQ(chunk->position_, kChunk);
+  const auto samples = read(ring, *chunk, /*written_meanwhile=*/4 * kChunk);
+  EXPECT_NE(samples.back(), chunk->position_ + chunk->count_ - 1);
+  EXPECT_FALSE(recording.commit(*chunk, ring.written_));
+
+  // the recording ends before the overwritten chunk
+  EXPECT_TRUE(recording.finished());
+  EXPECT_TRUE(recording.lapped());
+  EXPECT_EQ(recording.recorded(), kChunk);
+  EXPECT_EQ(recording.dropped(), 5 * kChunk);
+  EXPECT_FALSE(recording.next(ring.written_));
+}
+
+TEST(ring_recording, lapped_before_read) {
+  Ring ring;
+  ring.write(kCapacity);
+  RingRecording recording(kCapacity, kChunk, /*start=*/0, /*end=*/2 * kChunk);
+
+  // the writer may be writing into the first chunk right now
+  EXPECT_FALSE(recording.next(ring.written_));
+  EXPECT_TRUE(recording.lapped());
+  EXPECT_EQ(recording.recorded(), 0);
+  EXPECT_EQ(recording.dropped(), 2 * kChunk);
+}
+
+TEST(ring_recording, invalid_arguments) {
+  EXPECT_THROW(RingRecording(/*capacity=*/10, kChunk, /*start=*/0, /*end=*/4), std::invalid_argument);
+  EXPECT_THROW(RingRecording(kCapacity, /*chunk_size=*/0, /*start=*/0, /*end=*/4), std::invalid_argument);
+  EXPECT_THROW(RingRecording(kCapacity, kChunk, /*start=*/1, /*end=*/4), std::invalid_argument);
+}
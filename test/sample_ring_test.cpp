@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <vector>
+
+#include "sample_ring.h"
+
+TEST(sample_ring, write_read) {
+  SampleRing ring(/*item_size=*/sizeof(std::complex<float>), /*capacity=*/4, /*huge_pages=*/false);
+  EXPECT_EQ(ring.capacity(), 4);
+
+  const std::vector<std::complex<float>> input = {{1, 2}, {3, 4}, {5, 6}};
+  EXPECT_EQ(ring.write(input.data(), input.size()), 3);
+  EXPECT_EQ(ring.size(), 3);
+
+  std::vector<std::complex<float>> output(3);
+  EXPECT_EQ(ring.read(output.data(), output.size()), 3);
+  EXPECT_EQ(output, input);
+  EXPECT_EQ(ring.high_water(), 3);
+  EXPECT_EQ(ring.dropped(), 0);
+  EXPECT_FALSE(ring.pop_gap());
+}
+
+TEST(sample_ring, overflow_records_gap) {
+  SampleRing ring(/*item_size=*/2, /*capacity=*/4, /*huge_pages=*/false);
+
+  const std::vector<uint16_t> input = {1, 2, 3, 4, 5, 6};
+  EXPECT_EQ(ring.write(input.data(), input.size()), 4);
+  EXPECT_EQ(ring.dropped(), 2);
+  EXPECT_EQ(ring.high_water(), 4);
+
+  // the gap is before the fifth sample
+  const auto gap = ring.pop_gap();
+  ASSERT_TRUE(gap);
+  EXPECT_EQ(gap->position_, 4);
+  EXPECT_EQ(gap->dropped_, 2);
+  EXPECT_FALSE(ring.pop_gap());
+
+  std::vector<uint16_t> output(4);
+  EXPECT_EQ(ring.read(output.data(), output.size()), 4);
+  EXPECT_EQ(output, std::vector<uint16_t>({1, 2, 3, 4}));
+
+  EXPECT_EQ(ring.write(input.data(), 1), 1);
+  EXPECT_EQ(ring.read(output.data(), output.size()), 1);
+  EXPECT_EQ(output[0], 1);
+}
+
+TEST(sample_ring, merge_gaps_when_full) {
+  SampleRing ring(/*item_size=*/1, /*capacity=*/1, /*huge_pages=*/false);
+
+  const uint8_t sample = 0;
+  EXPECT_EQ(ring.write(&sample, 1), 1);
+  // fill the gap ring and overflow it by one gap
+  for (std::size_t i = 0; i < SampleRing::kGapCapacity + 1; i++) {
+    EXPECT_EQ(ring.write(&sample, 1), 0);
+  }
+  EXPECT_EQ(ring.dropped(), SampleRing::kGapCapacity + 1);
+
+  uint64_t dropped = 0;
+  while (const auto gap = ring.pop_gap()) {
+    dropped += gap->dropped_;
+  }
+  EXPECT_EQ(dropped, SampleRing::kGapCapacity);
+
+  // the pending gap is recorded with the next write
+  uint8_t output = 0;
+  EXPECT_EQ(ring.read(&output, 1), 1);
+  EXPECT_EQ(ring.write(&sample, 1), 1);
+  const auto gap = ring.pop_gap();
+  ASSERT_TRUE(gap);
+  EXPECT_EQ(gap->position_, 1);
+  EXPECT_EQ(gap->dropped_, 1);
+}
+
+TEST(sample_ring, wait_and_finish) {
+  SampleRing ring(/*item_size=*/1, /*capacity=*/4, /*huge_pages=*/false);
+  EXPECT_FALSE(ring.wait(std::chrono::milliseconds(1)));
+  EXPECT_FALSE(ring.drained());
+
+  const uint8_t sample = 0;
+  ring.write(&sample, 1);
+  ring.finish();
+  EXPECT_TRUE(ring.wait(std::chrono::milliseconds(1)));
+  EXPECT_FALSE(ring.drained());
+
+  uint8_t output = 0;
+  ring.read(&output, 1);
+  EXPECT_FALSE(ring.wait(std::chrono::milliseconds(1)));
+  EXPECT_TRUE(ring.drained());
+}
+
+TEST(sample_ring, empty) {
+  EXPECT_THROW(SampleRing(/*item_size=*/8, /*capacity=*/0, /*huge_pages=*/false), std::invalid_argument);
+}
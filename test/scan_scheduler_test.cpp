@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "scan_scheduler.h"
+
+/// The center frequencies of count carriers 25 kHz apart
+static auto frequencies(const std::size_t count) -> std::vector<unsigned int> {
+  std::vector<unsigned int> frequencies;
+  for (std::size_t i = 0; i < count; i++) {
+    frequencies.push_back(static_cast<unsigned int>(420000000 + 25000 * i));
+  }
+  return frequencies;
+}
+
+TEST(scan_scheduler, round_robin) {
+  ScanScheduler scheduler(frequencies(5), /*slots=*/2, /*dwell_seconds=*/1, /*max_dwell_seconds=*/3);
+
+  EXPECT_EQ(scheduler.slots(), 2);
+  EXPECT_EQ(scheduler.first(0).carrier_, 0);
+  EXPECT_EQ(scheduler.first(1).carrier_, 1);
+  EXPECT_DOUBLE_EQ(scheduler.first(0).seconds_, 1);
+
+  // without activity the slots take the waiting carriers in order
+  EXPECT_EQ(scheduler.next(0).carrier_, 2);
+  EXPECT_EQ(scheduler.next(1).carrier_, 3);
+  EXPECT_EQ(scheduler.next(0).carrier_, 4);
+  EXPECT_EQ(scheduler.next(1).carrier_, 0);
+  EXPECT_EQ(scheduler.next(0).carrier_, 1);
+}
+
+TEST(scan_scheduler, activity_extends_dwell) {
+  ScanScheduler scheduler(frequencies(3), /*slots=*/1, /*dwell_seconds=*/1, /*max_dwell_seconds=*/2.5);
+
+  // an active carrier keeps the slot up to the maximum dwell
+  scheduler.report(0);
+  EXPECT_EQ(scheduler.next(0).carrier_, 0);
+  scheduler.report(0);
+  const auto last = scheduler.next(0);
+  EXPECT_EQ(last.carrier_, 0);
+  EXPECT_DOUBLE_EQ(last.seconds_, 0.5);
+  scheduler.report(0);
+  EXPECT_EQ(scheduler.next(0).carrier_, 1);
+
+  // reports of carriers without a slot are ignored
+  scheduler.report(0);
+  EXPECT_EQ(scheduler.next(0).carrier_, 2);
+  EXPECT_EQ(scheduler.next(0).carrier_, 0);
+
+  // a carrier that is not reported again during its extension loses the slot
+  scheduler.report(0);
+  EXPECT_EQ(scheduler.next(0).carrier_, 0);
+  EXPECT_EQ(scheduler.next(0).carrier_, 1);
+}
+
+TEST(scan_scheduler, bounded_revisit_time) {
+  const std::size_t carriers = 100;
+  const std::size_t slots = 10;
+  ScanScheduler scheduler(frequencies(carriers), slots, /*dwell_seconds=*/1, /*max_dwell_seconds=*/4);
+  EXPECT_DOUBLE_EQ(scheduler.max_revisit_seconds(), 9 * 4);
+
+  std::mt19937 generator(/*seed=*/42);
+  std::bernoulli_distribution active(0.3);
+
+  // the time each slot asks for its next dwell and the time each carrier was left
+  std::vector<double> ends(slots);
+  std::vector<double> left(carriers, 0);
+  std::vector<std::size_t> current(slots);
+  for (std::size_t slot = 0; slot < slots; slot++) {
+    const auto dwell = scheduler.first(slot);
+    ends[slot] = dwell.seconds_;
+    current[slot] = dwell.carrier_;
+  }
+
+  std::vector<bool> visited(carriers, false);
+  for (int step = 0; step < 10000; step++) {
+    const auto slot = std::min_element(ends.begin(), ends.end()) - ends.begin();
+    const auto now = ends[slot];
+    if (active(generator)) {
+      scheduler.report(current[slot]);
+    }
+
+    const auto dwell = scheduler.next(slot);
+    if (dwell.carrier_ != current[slot]) {
+      left[current[slot]] = now;
+      if (visited[dwell.carrier_]) {
+        EXPECT_LE(now - left[dwell.carrier_], scheduler.max_revisit_seconds());
+      }
+      visited[dwell.carrier_] = true;
+      current[slot] = dwell.carrier_;
+    }
+    ends[slot] = now + dwell.seconds_;
+  }
+
+  EXPECT_TRUE(std::all_of(visited.begin() + slots, visited.end(), [](const bool v) { return v; }));
+}
+
+TEST(scan_scheduler, every_carrier_has_a_slot) {
+  ScanScheduler scheduler(frequencies(2), /*slots=*/2, /*dwell_seconds=*/1, /*max_dwell_seconds=*/1);
+
+  EXPECT_EQ(scheduler.next(0).carrier_, 0);
+  EXPECT_EQ(scheduler.next(1).carrier_, 1);
+  EXPECT_DOUBLE_EQ(scheduler.max_revisit_seconds(), 0);
+}
+
+TEST(scan_scheduler, frequencies) {
+  ScanScheduler scheduler(frequencies(3), /*slots=*/1, /*dwell_seconds=*/1, /*max_dwell_seconds=*/1);
+
+  EXPECT_EQ(scheduler.frequency(2), 420050000);
+  EXPECT_EQ(scheduler.carrier(420025000), 1);
+  EXPECT_THROW(static_cast<void>(scheduler.carrier(420012500)), std::invalid_argument);
+}
+
+TEST(scan_scheduler, invalid_arguments) {
+  EXPECT_THROW(ScanScheduler(frequencies(3), /*slots=*/0, 1, 1), std::invalid_argument);
+  EXPECT_THROW(ScanScheduler(frequencies(3), /*slots=*/4, 1, 1), std::invalid_argument);
+  EXPECT_THROW(ScanScheduler(frequencies(3), /*slots=*/1, /*dwell_seconds=*/0, 1), std::invalid_argument);
+  EXPECT_THROW(ScanScheduler(frequencies(3), /*slots=*/1, /*dwell_seconds=*/2, /*max_dwell_seconds=*/1),
+               std::invalid_argument);
+}
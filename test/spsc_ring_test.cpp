@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+TEST(spsc_ring, write_read_wrap_around) {
+  SpscRing<int> ring(/*capacity=*/5, /*huge_pages=*/false);
+  EXPECT_EQ(ring.capacity(), 5);
+  EXPECT_EQ(ring.size(), 0);
+  EXPECT_EQ(ring.space(), 5);
+
+  const std::vector<int> input = {1, 2, 3, 4};
+  EXPECT_EQ(ring.write(input.data(), input.size()), 4);
+
+  std::vector<int> output(3);
+  EXPECT_EQ(ring.read(output.data(), output.size()), 3);
+  EXPECT_EQ(output, std::vector<int>({1, 2, 3}));
+
+  // the next write wraps around the end of the ring
+  EXPECT_EQ(ring.write(input.data(), input.size()), 4);
+  EXPECT_EQ(ring.size(), 5);
+
+  output.resize(5);
+  EXPECT_EQ(ring.read(output.data(), output.size()), 5);
+  EXPECT_EQ(output, std::vector<int>({4, 1, 2, 3, 4}));
+  EXPECT_EQ(ring.write_position(), 8);
+  EXPECT_EQ(ring.read_position(), 8);
+}
+
+TEST(spsc_ring, write_full) {
+  SpscRing<int> ring(/*capacity=*/3, /*huge_pages=*/false);
+
+  const std::vector<int> input = {1, 2, 3, 4, 5};
+  EXPECT_EQ(ring.write(input.data(), input.size()), 3);
+  EXPECT_EQ(ring.write(input.data(), input.size()), 0);
+  EXPECT_EQ(ring.space(), 0);
+
+  std::vector<int> output(5);
+  EXPECT_EQ(ring.read(output.data(), output.size()), 3);
+  EXPECT_EQ(ring.read(output.data(), output.size()), 0);
+}
+
+TEST(spsc_ring, threads) {
+  constexpr int kItems = 1000000;
+  SpscRing<int> ring(/*capacity=*/1000, /*huge_pages=*/false);
+
+  std::thread writer([&ring] {
+    std::vector<int> items(100);
+    int next = 0;
+    while (next < kItems) {
+      std::iota(items.begin(), items.end(), next);
+      const auto count = std::min<int>(items.size(), kItems - next);
+      next += ring.write(items.data(), count);
+    }
+  });
+
+  // every item arrives exactly once and in order
+  std::vector<int> items(77);
+  int expected = 0;
+  bool in_order = true;
+  while (expected < kItems) {
+    const auto read = ring.read(items.data(), items.size());
+    for (std::size_t i = 0; i < read; i++) {
+      in_order &= items[i] == expected++;
+    }
+  }
+  writer.join();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ(ring.size(), 0);
+}
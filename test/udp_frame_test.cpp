@@ -0,0 +1,237 @@
+#include <array>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "udp_frame.h"
+
+TEST(udp_frame, header_layout) {
+  udp_frame::Header header;
+  header.payload_type_ = udp_frame::PayloadType::kSoftBits;
+  header.sequence_ = 0x01020304;
+  header.sample_rate_ = 36000;
+  header.center_frequency_ = 420000000;
+  header.item_count_ = 1440;
+
+  std::array<uint8_t, udp_frame::kHeaderSize> frame{};
+  udp_frame::write_header(header, frame.data());
+
+  // magic, version, payload type and reserved bytes
+  EXPECT_EQ(frame[0], 'T');
+  EXPECT_EQ(frame[1], 'E');
+  EXPECT_EQ(frame[2], 'T');
+  EXPECT_EQ(frame[3], 'R');
+  EXPECT_EQ(frame[4], udp_frame::kVersion);
+  EXPECT_EQ(frame[5], 1);
+  EXPECT_EQ(frame[6], 0);
+  EXPECT_EQ(frame[7], 0);
+  // the fields are big-endian
+  EXPECT_EQ(frame[8], 0x01);
+  EXPECT_EQ(frame[11], 0x04);
+  EXPECT_EQ(frame[14], 36000 >> 8);
+  EXPECT_EQ(frame[15], 36000 & 0xff);
+}
+
+TEST(udp_frame, round_trip) {
+  udp_frame::Header header;
+  header.sequence_ = 0xfffffffe;
+  header.sample_rate_ = 36000;
+  header.center_frequency_ = 4294967295;
+  header.item_count_ = 7;
+
+  std::array<uint8_t, udp_frame::kHeaderSize> frame{};
+  udp_frame::write_header(header, frame.data());
+  const auto read = udp_frame::read_header(frame.data(), frame.size());
+
+  EXPECT_EQ(read.payload_type_, header.payload_type_);
+  EXPECT_EQ(read.sequence_, header.sequence_);
+  EXPECT_EQ(read.sample_rate_, header.sample_rate_);
+  EXPECT_EQ(read.center_frequency_, header.center_frequency_);
+  EXPECT_EQ(read.item_count_, header.item_count_);
+}
+
+TEST(udp_frame, burst_header) {
+  udp_frame::BurstHeader header;
+  header.burst_type_ = 3;
+  header.frequency_offset_ = -1200;
+  header.symbol_ = 0x0102030405060708;
+
+  std::array<uint8_t, udp_frame::kBurstHeaderSize> payload{};
+  udp_frame::write_burst_header(header, payload.data());
+
+  // the fields are big-endian, the frequency offset in two's complement
+  EXPECT_EQ(payload[0], 3);
+  EXPECT_EQ(payload[1], 0);
+  EXPECT_EQ(payload[2], 0xfb);
+  EXPECT_EQ(payload[3], 0x50);
+  EXPECT_EQ(payload[4], 0x01);
+  EXPECT_EQ(payload[11], 0x08);
+
+  const auto read = udp_frame::read_burst_header(payload.data(), payload.size());
+  EXPECT_EQ(read.burst_type_, header.burst_type_);
+  EXPECT_EQ(read.frequency_offset_, header.frequency_offset_);
+  EXPECT_EQ(read.symbol_, header.symbol_);
+
+  EXPECT_THROW(udp_frame::read_burst_header(payload.data(), payload.size() - 1), std::invalid_argument);
+}
+
+TEST(udp_frame, invalid_frames) {
+  std::array<uint8_t, udp_frame::kHeaderSize> frame{};
+  udp_frame::write_header(udp_frame::Header{}, frame.data());
+
+  // too short
+  EXPECT_THROW(udp_frame::read_header(frame.data(), udp_frame::kHeaderSize - 1), std::invalid_argument);
+
+  // wrong version
+  frame[4] = udp_frame::kVersion + 1;
+  EXPECT_THROW(udp_frame::read_header(frame.data(), frame.size()), std::invalid_argument);
+
+  // wrong magic
+  frame[4] = udp_frame::kVersion;
+  frame[0] = 'X';
+  EXPECT_THROW(udp_frame::read_header(frame.data(), frame.size()), std::invalid_argument);
+}
+
+/// A frame of complex float samples with the given sequence number and items
+static auto iq_frame(const uint32_t sequence, const std::size_t items, const uint32_t sample_rate = 200000)
+    -> std::vector<uint8_t> {
+  udp_frame::Header header;
+  header.payload_type_ = udp_frame::PayloadType::kComplexFloat32;
+  header.sequence_ = sequence;
+  header.sample_rate_ = sample_rate;
+  header.center_frequency_ = 420000000;
+  header.item_count_ = items;
+
+  std::vector<uint8_t> frame(udp_frame::kHeaderSize + items * 8);
+  udp_frame::write_header(header, frame.data());
+  return frame;
+}
+
+TEST(udp_frame, deframer_lost_and_late_frames) {
+  udp_frame::Deframer deframer(udp_frame::PayloadType::kComplexFloat32, /*item_size=*/8, /*sample_rate=*/200000,
+                               /*center_frequency=*/420000000);
+
+  // the first frame starts the sequence
+  auto frame = iq_frame(/*sequence=*/10, /*items=*/4);
+  auto payload = deframer.push(frame.data(), frame.size());
+  ASSERT_TRUE(payload);
+  EXPECT_EQ(payload->lost_items_, 0);
+  EXPECT_EQ(payload->items_, 4);
+  EXPECT_EQ(payload->payload_, frame.data() + udp_frame::kHeaderSize);
+
+  // frames 11 and 12 were lost
+  frame = iq_frame(/*sequence=*/13, /*items=*/4);
+  payload = deframer.push(frame.data(), frame.size());
+  ASSERT_TRUE(payload);
+  EXPECT_EQ(payload->lost_items_, 8);
+
+  // frame 12 arrives late and is dropped
+  frame = iq_frame(/*sequence=*/12, /*items=*/4);
+  EXPECT_FALSE(deframer.push(frame.data(), frame.size()));
+  EXPECT_EQ(deframer.late_frames(), 1);
+
+  // the sequence continues
+  frame = iq_frame(/*sequence=*/14, /*items=*/4);
+  payload = deframer.push(frame.data(), frame.size());
+  ASSERT_TRUE(payload);
+  EXPECT_EQ(payload->lost_items_, 0);
+}
+
+TEST(udp_frame, deframer_wraparound_and_restart) {
+  udp_frame::Deframer deframer(udp_frame::PayloadType::kComplexFloat32, /*item_size=*/8, /*sample_rate=*/200000,
+                               /*center_frequency=*/420000000);
+
+  auto frame = iq_frame(/*sequence=*/0xffffffff, /*items=*/2);
+  ASSERT_TRUE(deframer.push(frame.data(), frame.size()));
+
+  // the sequence number wraps around and frame 0 was lost
+  frame = iq_frame(/*sequence=*/1, /*items=*/2);
+  auto payload = deframer.push(frame.data(), frame.size());
+  ASSERT_TRUE(payload);
+  EXPECT_EQ(payload->lost_items_, 2);
+
+  // a restarted sender begins with another sequence number, which is not a gap
+  frame = iq_frame(/*sequence=*/1000000, /*items=*/2);
+  payload = deframer.push(frame.data(), frame.size());
+  ASSERT_TRUE(payload);
+  EXPECT_EQ(payload->lost_items_, 0);
+}
+
+TEST(udp_frame, deframer_validates_frames) {
+  udp_frame::Deframer deframer(udp_frame::PayloadType::kComplexFloat32, /*item_size=*/8, /*sample_rate=*/200000,
+                               /*center_frequency=*/420000000);
+
+  // another sample rate
+  auto frame = iq_frame(/*sequence=*/0, /*items=*/2, /*sample_rate=*/250000);
+  EXPECT_THROW(deframer.push(frame.data(), frame.size()), std::invalid_argument);
+
+  // a truncated payload
+  frame = iq_frame(/*sequence=*/0, /*items=*/2);
+  EXPECT_THROW(deframer.push(frame.data(), frame.size() - 1), std::invalid_argument);
+
+  // another kind of items
+  udp_frame::Header header;
+  header.payload_type_ = udp_frame::PayloadType::kSoftBits;
+  header.sample_rate_ = 200000;
+  header.center_frequency_ = 420000000;
+  std::array<uint8_t, udp_frame::kHeaderSize> soft_bits{};
+  udp_frame::write_header(header, soft_bits.data());
+  EXPECT_THROW(deframer.push(soft_bits.data(), soft_bits.size()), std::invalid_argument);
+}
+
+TEST(udp_frame, frame_splitter_retune) {
+  udp_frame::FrameSplitter splitter(/*capacity=*/720, /*center_frequency=*/420000000);
+
+  // the carrier changes in the middle of the second frame, which ends early
+  splitter.retune(/*position=*/1000, /*center_frequency=*/420100000);
+  EXPECT_EQ(splitter.next(/*available=*/2000), 720);
+  EXPECT_EQ(splitter.center_frequency(), 420000000);
+  EXPECT_EQ(splitter.next(/*available=*/1280), 280);
+  EXPECT_EQ(splitter.center_frequency(), 420000000);
+  EXPECT_EQ(splitter.next(/*available=*/1000), 720);
+  EXPECT_EQ(splitter.center_frequency(), 420100000);
+  EXPECT_EQ(splitter.position(), 1720);
+
+  // a retune at the end of a frame does not shorten it
+  splitter.retune(/*position=*/2440, /*center_frequency=*/420200000);
+  EXPECT_EQ(splitter.next(/*available=*/720), 720);
+  EXPECT_EQ(splitter.center_frequency(), 420100000);
+  EXPECT_EQ(splitter.next(/*available=*/720), 720);
+  EXPECT_EQ(splitter.center_frequency(), 420200000);
+
+  // a retune earlier than the next frame is rejected
+  EXPECT_THROW(splitter.retune(/*position=*/3000, /*center_frequency=*/420000000), std::invalid_argument);
+}
+
+TEST(udp_frame, frame_splitter_waits_for_items) {
+  udp_frame::FrameSplitter splitter(/*capacity=*/720, /*center_frequency=*/420000000);
+
+  // a full frame needs all of its items
+  EXPECT_FALSE(splitter.next(/*available=*/719));
+  EXPECT_EQ(splitter.position(), 0);
+
+  // a frame that ends at a retune only needs the items up to it
+  splitter.retune(/*position=*/100, /*center_frequency=*/420100000);
+  EXPECT_EQ(splitter.next(/*available=*/100), 100);
+  EXPECT_FALSE(splitter.next(/*available=*/0));
+  EXPECT_EQ(splitter.center_frequency(), 420100000);
+
+  // two retunes at the same item only keep the later carrier
+  splitter.retune(/*position=*/820, /*center_frequency=*/420200000);
+  splitter.retune(/*position=*/820, /*center_frequency=*/420300000);
+  EXPECT_EQ(splitter.next(/*available=*/720), 720);
+  EXPECT_EQ(splitter.next(/*available=*/720), 720);
+  EXPECT_EQ(splitter.center_frequency(), 420300000);
+}
+
+TEST(udp_frame, deframer_accepts_padded_frames) {
+  udp_frame::Deframer deframer(udp_frame::PayloadType::kComplexFloat32, /*item_size=*/8, /*sample_rate=*/200000,
+                               /*center_frequency=*/420000000);
+
+  // a frame that ended early keeps the size of the full frames
+  auto frame = iq_frame(/*sequence=*/0, /*items=*/2);
+  frame.resize(frame.size() + 3 * 8);
+  const auto payload = deframer.push(frame.data(), frame.size());
+  ASSERT_TRUE(payload);
+  EXPECT_EQ(payload->items_, 2);
+}